@@ -0,0 +1,41 @@
+#ifndef AST_AST_NODE_COUNTER_H
+#define AST_AST_NODE_COUNTER_H
+
+#include <cstddef>
+
+#include "visitor/AstNodeVisitor.hpp"
+
+// Counts the nodes of a subtree, a rough measure of the code it generates.
+class AstNodeCounter final : public AstNodeVisitor {
+ private:
+  size_t m_count = 0;
+
+  template <typename Node>
+  void count(Node &p_node);
+
+ public:
+  ~AstNodeCounter() = default;
+  AstNodeCounter() = default;
+
+  size_t getCount() const { return m_count; }
+
+  void visit(ProgramNode &p_program) override;
+  void visit(DeclNode &p_decl) override;
+  void visit(VariableNode &p_variable) override;
+  void visit(ConstantValueNode &p_constant_value) override;
+  void visit(FunctionNode &p_function) override;
+  void visit(CompoundStatementNode &p_compound_statement) override;
+  void visit(PrintNode &p_print) override;
+  void visit(BinaryOperatorNode &p_bin_op) override;
+  void visit(UnaryOperatorNode &p_un_op) override;
+  void visit(FunctionInvocationNode &p_func_invocation) override;
+  void visit(VariableReferenceNode &p_variable_ref) override;
+  void visit(AssignmentNode &p_assignment) override;
+  void visit(ReadNode &p_read) override;
+  void visit(IfNode &p_if) override;
+  void visit(WhileNode &p_while) override;
+  void visit(ForNode &p_for) override;
+  void visit(ReturnNode &p_return) override;
+};
+
+#endif
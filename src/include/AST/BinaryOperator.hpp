@@ -35,6 +35,12 @@ class BinaryOperatorNode final : public ExpressionNode {
   const ExpressionNode &getRightOperand() const {
     return *m_right_operand.get();
   }
+  std::unique_ptr<ExpressionNode> &getLeftOperandPtr() {
+    return m_left_operand;
+  }
+  std::unique_ptr<ExpressionNode> &getRightOperandPtr() {
+    return m_right_operand;
+  }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
@@ -28,6 +28,9 @@ class CompoundStatementNode final : public AstNode {
         m_decl_nodes(std::move(p_decl_nodes)),
         m_stmt_nodes(std::move(p_stmt_nodes)) {}
 
+  const StmtNodes &getStatements() const { return m_stmt_nodes; }
+  StmtNodes &getStatements() { return m_stmt_nodes; }
+
   const SymbolTable *getSymbolTable() const { return m_symbol_table_ptr; }
   void setSymbolTable(const SymbolTable *p_symbol_table) {
     m_symbol_table_ptr = p_symbol_table;
@@ -0,0 +1,47 @@
+#ifndef AST_CONSTANT_FOLDER_H
+#define AST_CONSTANT_FOLDER_H
+
+#include <memory>
+
+#include "AST/expression.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+class SymbolManager;
+
+// Rewrites the AST after semantic analysis: references to integer and boolean
+// constants are replaced by their values, and operators whose operands are all
+// constant are replaced by the value they compute.
+class ConstantFolder final : public AstNodeVisitor {
+ private:
+  const SymbolManager *m_symbol_manager_ptr;
+
+  // the node that replaces the expression just visited, if any
+  std::unique_ptr<ExpressionNode> m_folded;
+
+  void foldExpr(std::unique_ptr<ExpressionNode> &p_expr);
+
+ public:
+  ~ConstantFolder() = default;
+  ConstantFolder(const SymbolManager *const p_symbol_manager)
+      : m_symbol_manager_ptr(p_symbol_manager) {}
+
+  void visit(ProgramNode &p_program) override;
+  void visit(DeclNode &p_decl) override;
+  void visit(VariableNode &p_variable) override;
+  void visit(ConstantValueNode &p_constant_value) override;
+  void visit(FunctionNode &p_function) override;
+  void visit(CompoundStatementNode &p_compound_statement) override;
+  void visit(PrintNode &p_print) override;
+  void visit(BinaryOperatorNode &p_bin_op) override;
+  void visit(UnaryOperatorNode &p_un_op) override;
+  void visit(FunctionInvocationNode &p_func_invocation) override;
+  void visit(VariableReferenceNode &p_variable_ref) override;
+  void visit(AssignmentNode &p_assignment) override;
+  void visit(ReadNode &p_read) override;
+  void visit(IfNode &p_if) override;
+  void visit(WhileNode &p_while) override;
+  void visit(ForNode &p_for) override;
+  void visit(ReturnNode &p_return) override;
+};
+
+#endif
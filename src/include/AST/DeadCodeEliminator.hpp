@@ -0,0 +1,63 @@
+#ifndef AST_DEAD_CODE_ELIMINATOR_H
+#define AST_DEAD_CODE_ELIMINATOR_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+#include "AST/CompoundStatement.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+class SymbolEntry;
+class SymbolManager;
+
+// Removes code that can never run or whose effect is never observed:
+// statements after a return, if/while statements whose condition folded to a
+// constant, assignments to locals that are never read and, in whole-program
+// mode, functions that are never called from the main program.
+class DeadCodeEliminator final : public AstNodeVisitor {
+ private:
+  enum class Phase : uint8_t {
+    kCollectCalls,
+    kPrune,
+    kCollectReads,
+    kRemoveDeadStores
+  };
+
+  SymbolManager *m_symbol_manager_ptr;
+  const bool m_whole_program;
+
+  Phase m_phase = Phase::kPrune;
+  std::set<std::string> m_called;
+  std::set<const SymbolEntry *> m_read;
+  bool m_changed = false;
+
+  void removeUncalledFunctions(ProgramNode &p_program);
+  void eliminateInBody(CompoundStatementNode &p_body);
+  void pruneStatements(CompoundStatementNode::StmtNodes &p_stmts);
+  bool isDeadStore(const AssignmentNode &p_assignment) const;
+
+ public:
+  ~DeadCodeEliminator() = default;
+  DeadCodeEliminator(SymbolManager *const p_symbol_manager,
+                     const bool p_whole_program)
+      : m_symbol_manager_ptr(p_symbol_manager),
+        m_whole_program(p_whole_program) {}
+
+  void visit(ProgramNode &p_program) override;
+  void visit(FunctionNode &p_function) override;
+  void visit(CompoundStatementNode &p_compound_statement) override;
+  void visit(PrintNode &p_print) override;
+  void visit(BinaryOperatorNode &p_bin_op) override;
+  void visit(UnaryOperatorNode &p_un_op) override;
+  void visit(FunctionInvocationNode &p_func_invocation) override;
+  void visit(VariableReferenceNode &p_variable_ref) override;
+  void visit(AssignmentNode &p_assignment) override;
+  void visit(ReadNode &p_read) override;
+  void visit(IfNode &p_if) override;
+  void visit(WhileNode &p_while) override;
+  void visit(ForNode &p_for) override;
+  void visit(ReturnNode &p_return) override;
+};
+
+#endif
@@ -27,6 +27,7 @@ class FunctionInvocationNode final : public ExpressionNode {
   const char *getNameCString() const { return m_name.c_str(); }
 
   const ExprNodes &getArguments() const { return m_args; }
+  ExprNodes &getArguments() { return m_args; }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
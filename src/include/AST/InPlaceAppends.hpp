@@ -0,0 +1,26 @@
+#ifndef AST_IN_PLACE_APPENDS_H
+#define AST_IN_PLACE_APPENDS_H
+
+#include <set>
+
+class AssignmentNode;
+class CompoundStatementNode;
+class ExpressionNode;
+class SymbolManager;
+
+using InPlaceAppends = std::set<const AssignmentNode *>;
+
+// the string a chain of concatenations starts from: s in s + t + u
+const ExpressionNode &getConcatenationBase(const ExpressionNode &p_expr);
+
+// The assignments s := s + t (+ u ...) in the body of a function or of the
+// main program that may extend the string s holds in place instead of
+// copying it. s must be a local variable nothing else can share the value
+// of: it is only ever assigned a literal or the result of a concatenation,
+// and is never assigned, passed, returned or read into as a whole. Nor may
+// the rest of the chain read s, which would see it extended already. The
+// scope the body is in must be in the hash table of the symbol manager.
+InPlaceAppends findInPlaceAppends(CompoundStatementNode &p_body,
+                                  const SymbolManager *p_symbol_manager);
+
+#endif
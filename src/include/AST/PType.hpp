@@ -89,6 +89,26 @@ class PType {
     }
     return size;
   }
+
+  // Layout in target memory, where values are accessed with whole words:
+  // an element takes a word (p_real_size bytes for reals, which depends on
+  // the precision they are computed in) and arrays are stored row-major.
+  size_t getElementSize(const size_t p_real_size) const {
+    return isPrimitiveReal() ? p_real_size : 4;
+  }
+  size_t getStorageSize(const size_t p_real_size) const {
+    return m_dimensions.empty()
+               ? getElementSize(p_real_size)
+               : getStride(0, p_real_size) * m_dimensions.front();
+  }
+  // bytes between consecutive indices of the p_dim-th dimension
+  size_t getStride(const size_t p_dim, const size_t p_real_size) const {
+    size_t stride = getElementSize(p_real_size);
+    for (size_t i = p_dim + 1; i < m_dimensions.size(); ++i) {
+      stride *= m_dimensions[i];
+    }
+    return stride;
+  }
 };
 
 #endif
@@ -27,6 +27,7 @@ class UnaryOperatorNode final : public ExpressionNode {
   }
 
   const ExpressionNode &getOperand() const { return *m_operand.get(); }
+  std::unique_ptr<ExpressionNode> &getOperandPtr() { return m_operand; }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
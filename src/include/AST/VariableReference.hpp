@@ -36,6 +36,7 @@ class VariableReferenceNode final : public ExpressionNode {
   const char *getNameCString() const { return m_name.c_str(); }
 
   const ExprNodes &getIndices() const { return m_indices; }
+  ExprNodes &getIndices() { return m_indices; }
 
   bool isLvalue() const { return m_lvalue; }
   void setLvalue() { m_lvalue = true; }
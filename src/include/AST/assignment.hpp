@@ -20,6 +20,7 @@ class AssignmentNode final : public AstNode {
 
   VariableReferenceNode &getLvalue() const { return *m_lvalue.get(); }
   ExpressionNode &getExpr() const { return *m_expr.get(); }
+  std::unique_ptr<ExpressionNode> &getExprPtr() { return m_expr; }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
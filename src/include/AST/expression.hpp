@@ -20,4 +20,12 @@ class ExpressionNode : public AstNode {
   void setInferredType(PType *p_type) { m_type.reset(p_type); }
 };
 
+// Whether evaluating the expression calls a function, in which case it may
+// have side effects and its operands must keep their evaluation order. String
+// concatenations call the runtime.
+bool hasFunctionInvocation(const ExpressionNode &p_expr);
+
+// whether the expression is a + of two strings
+bool isConcatenation(const ExpressionNode &p_expr);
+
 #endif
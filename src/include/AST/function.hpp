@@ -49,6 +49,9 @@ class FunctionNode final : public AstNode {
 
   const PType *getTypePtr() const { return m_ret_type.get(); }
 
+  // nullptr for a function declared without a body
+  CompoundStatementNode *getBody() const { return m_body.get(); }
+
   const SymbolTable *getSymbolTable() const { return m_symbol_table_ptr; }
   void setSymbolTable(const SymbolTable *p_symbol_table) {
     m_symbol_table_ptr = p_symbol_table;
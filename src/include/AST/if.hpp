@@ -23,6 +23,7 @@ class IfNode final : public AstNode {
         m_else_body(p_else_body) {}
 
   ExpressionNode &getCondition() const { return *m_condition.get(); }
+  std::unique_ptr<ExpressionNode> &getConditionPtr() { return m_condition; }
   CompoundStatementNode &getBody() const { return *m_body.get(); }
   CompoundStatementNode *getElseBody() const {
     if (!m_else_body) {
@@ -30,6 +31,10 @@ class IfNode final : public AstNode {
     }
     return m_else_body.get();
   }
+  std::unique_ptr<CompoundStatementNode> &getBodyPtr() { return m_body; }
+  std::unique_ptr<CompoundStatementNode> &getElseBodyPtr() {
+    return m_else_body;
+  }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
@@ -17,6 +17,7 @@ class PrintNode final : public AstNode {
       : AstNode{line, col}, m_target(p_target) {}
 
   const ExpressionNode &getTarget() const { return *m_target.get(); }
+  std::unique_ptr<ExpressionNode> &getTargetPtr() { return m_target; }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
@@ -44,6 +44,7 @@ class ProgramNode final : public AstNode {
 
   const DeclNodes &getDeclNodes() const { return m_decl_nodes; }
   const FuncNodes &getFuncNodes() const { return m_func_nodes; }
+  FuncNodes &getFuncNodes() { return m_func_nodes; }
   const CompoundStatementNode &getBody() const { return *m_body.get(); }
 
   const SymbolTable *getSymbolTable() const { return m_symbol_table_ptr; }
@@ -17,6 +17,7 @@ class ReturnNode final : public AstNode {
       : AstNode{line, col}, m_ret_val(p_ret_val) {}
 
   const ExpressionNode &getReturnValue() const { return *m_ret_val.get(); }
+  std::unique_ptr<ExpressionNode> &getReturnValuePtr() { return m_ret_val; }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
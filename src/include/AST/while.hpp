@@ -19,6 +19,7 @@ class WhileNode final : public AstNode {
       : AstNode{line, col}, m_condition(p_condition), m_body(p_body) {}
 
   ExpressionNode &getCondition() const { return *m_condition.get(); }
+  std::unique_ptr<ExpressionNode> &getConditionPtr() { return m_condition; }
   CompoundStatementNode &getBody() const { return *m_body.get(); }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
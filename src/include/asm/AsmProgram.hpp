@@ -0,0 +1,42 @@
+#ifndef ASM_ASM_PROGRAM_H
+#define ASM_ASM_PROGRAM_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// One statement of a RISC-V assembly file: a label definition, an assembler
+// directive or an instruction (pseudo-instructions included).
+struct AsmStatement {
+  enum class Kind : uint8_t { kLabel, kDirective, kInstruction };
+
+  Kind kind;
+  // label name, directive (with its leading dot) or mnemonic
+  std::string name;
+  // split at the top-level commas, e.g., {"a0", "4(sp)"}
+  std::vector<std::string> operands;
+  size_t line;
+};
+
+// The in-memory form of the assembly the code generators write.
+class AsmProgram {
+ public:
+  using Statements = std::vector<AsmStatement>;
+
+ private:
+  Statements m_statements;
+
+ public:
+  ~AsmProgram() = default;
+  AsmProgram() = default;
+
+  const Statements &getStatements() const { return m_statements; }
+  Statements &getStatements() { return m_statements; }
+
+  // Returns false and describes the first malformed line in p_error.
+  bool parse(const std::string &p_text, std::string &p_error);
+  bool parseFile(const std::string &p_path, std::string &p_error);
+  void print(FILE *p_out) const;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef ASM_ASSEMBLER_H
+#define ASM_ASSEMBLER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "asm/AsmProgram.hpp"
+#include "asm/ObjectFile.hpp"
+
+// Encodes RV32IMFD assembly, including the pseudo-instructions and directives
+// the code generators emit, into an ObjectFile. Two passes over the program:
+// the first lays out the sections and defines the labels, the second encodes
+// with every label known.
+class Assembler {
+ private:
+  struct SymbolInfo {
+    int section = ObjectFile::kUndefinedSection;
+    uint32_t value = 0;
+    uint32_t size = 0;
+    ObjectFile::Symbol::Type type = ObjectFile::Symbol::Type::kNoType;
+    bool is_global = false;
+    // local labels (.L*) only make it into the symbol table when a
+    // relocation refers to them
+    bool is_referenced = false;
+  };
+  struct PendingRelocation {
+    int section;
+    uint32_t offset;
+    RiscvRelocation type;
+    std::string symbol;
+    int32_t addend;
+  };
+
+  ObjectFile &m_object;
+  std::map<std::string, SymbolInfo> m_symbols;
+  std::vector<std::string> m_symbol_order;
+  std::vector<PendingRelocation> m_relocations;
+  int m_section = 0;
+  bool m_final_pass = false;
+  size_t m_num_pcrel_labels = 0;
+  size_t m_line = 0;
+  std::string m_error;
+
+  bool runPass(const AsmProgram &p_program);
+  bool defineLabel(const std::string &p_name);
+  bool handleDirective(const AsmStatement &p_statement);
+  bool handleInstruction(const AsmStatement &p_statement);
+  bool switchSection(const std::string &p_name);
+  void finish();
+
+  SymbolInfo &getSymbol(const std::string &p_name);
+  ObjectFile::Section &currentSection() {
+    return m_object.getSections()[m_section];
+  }
+  uint32_t currentOffset() { return currentSection().size(); }
+  void emitWord(const uint32_t p_word);
+  void emitBytes(const uint64_t p_value, const size_t p_size);
+  void addRelocation(const RiscvRelocation p_type, const std::string &p_symbol,
+                     const int32_t p_addend = 0);
+  bool fail(const std::string &p_message);
+
+  bool parseRegister(const std::string &p_operand, uint32_t &p_reg);
+  bool parseFloatRegister(const std::string &p_operand, uint32_t &p_reg);
+  bool parseImmediate(const std::string &p_operand, int64_t &p_imm);
+  bool parseMemory(const std::string &p_operand, int64_t &p_offset,
+                   uint32_t &p_base);
+  // pc-relative offset to a label of the current section; false for labels
+  // resolved by the linker
+  bool getLocalOffset(const std::string &p_label, int64_t &p_offset);
+
+ public:
+  ~Assembler() = default;
+  explicit Assembler(ObjectFile &p_object) : m_object(p_object) {}
+
+  bool assemble(const AsmProgram &p_program);
+  const std::string &getError() const { return m_error; }
+};
+
+// Assembles the file at p_asm_path into a relocatable object at p_obj_path.
+bool assembleFile(const std::string &p_asm_path, const std::string &p_obj_path,
+                  std::string &p_error);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef ASM_BLOCK_LAYOUT_H
+#define ASM_BLOCK_LAYOUT_H
+
+#include <string>
+
+#include "asm/AsmProgram.hpp"
+
+// Splits each run of code between directives (a function) into basic blocks
+// and orders them so that control falls through wherever it can: a block
+// ending in a jump is followed by its target unless something already falls
+// into that target, and a conditional branch followed by a jump is inverted
+// when that lets its target follow instead. Fall-throughs the code
+// generators chose stay as they are, so loops tested at the bottom keep
+// their backward branch. Jumps and branches to blocks that only jump on are
+// retargeted, jumps to the next block dropped, and unreachable blocks
+// removed. Returns whether anything changed.
+bool layoutBlocks(AsmProgram &p_program);
+
+// Conditional branches reach +-4 KiB: rewrites the ones whose target is
+// farther away into the inverted branch over a jump to the target. Needed
+// for the assembler to accept long functions, whatever else runs. Returns
+// whether anything changed.
+bool relaxBranches(AsmProgram &p_program);
+
+// Runs layoutBlocks (if p_reorder) and then relaxBranches over the assembly
+// file at p_path and writes the result back in its place.
+bool layoutBlocksFile(const std::string &p_path, const bool p_reorder,
+                      std::string &p_error);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef ASM_OBJECT_FILE_H
+#define ASM_OBJECT_FILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// relocation types of the RISC-V ELF psABI (R_RISCV_*)
+enum class RiscvRelocation : uint32_t {
+  k32 = 1,
+  kBranch = 16,
+  kJal = 17,
+  kCallPlt = 19,
+  kPcrelHi20 = 23,
+  kPcrelLo12I = 24,
+  kPcrelLo12S = 25,
+};
+
+// Contents of an ELF32 relocatable object: sections, symbols and the
+// relocations against them.
+class ObjectFile {
+ public:
+  struct Relocation {
+    uint32_t offset;
+    RiscvRelocation type;
+    // index into the symbols
+    size_t symbol;
+    int32_t addend;
+  };
+
+  struct Section {
+    // determines the ELF section type and flags
+    enum class Kind : uint8_t { kText, kData, kRodata, kBss, kNote };
+
+    std::string name;
+    Kind kind;
+    uint32_t align = 1;
+    std::vector<uint8_t> data;
+    // size of SHT_NOBITS sections, which have no data
+    uint32_t nobits_size = 0;
+    std::vector<Relocation> relocations;
+
+    uint32_t size() const {
+      return data.empty() ? nobits_size : static_cast<uint32_t>(data.size());
+    }
+  };
+
+  static constexpr int kUndefinedSection = -1;
+
+  struct Symbol {
+    enum class Type : uint8_t { kNoType, kObject, kFunction };
+
+    std::string name;
+    // index into the sections, kUndefinedSection for external symbols
+    int section = kUndefinedSection;
+    uint32_t value = 0;
+    uint32_t size = 0;
+    Type type = Type::kNoType;
+    bool is_global = false;
+  };
+
+ private:
+  std::vector<Section> m_sections;
+  std::vector<Symbol> m_symbols;
+  std::string m_file_name;
+
+ public:
+  ~ObjectFile() = default;
+  ObjectFile() = default;
+
+  const std::vector<Section> &getSections() const { return m_sections; }
+  std::vector<Section> &getSections() { return m_sections; }
+  const std::vector<Symbol> &getSymbols() const { return m_symbols; }
+  std::vector<Symbol> &getSymbols() { return m_symbols; }
+  void setFileName(const std::string &p_name) { m_file_name = p_name; }
+
+  // Serializes to an ELF32 little-endian RISC-V relocatable object.
+  bool write(const std::string &p_path, std::string &p_error) const;
+};
+
+#endif
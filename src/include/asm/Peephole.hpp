@@ -0,0 +1,20 @@
+#ifndef ASM_PEEPHOLE_H
+#define ASM_PEEPHOLE_H
+
+#include <string>
+
+#include "asm/AsmProgram.hpp"
+
+// Rewrites short instruction sequences of the generated assembly into
+// cheaper equivalents: stores forwarded to the loads reading them back,
+// pushes popped right away cancelled, adjacent sp adjustments merged and
+// jumps to the next instruction dropped. The rules never look past a label,
+// a call or a branch, so each one only reasons about straight-line code.
+// Returns whether anything changed.
+bool optimizePeephole(AsmProgram &p_program);
+
+// Runs optimizePeephole over the assembly file at p_path and writes the
+// result back in its place.
+bool optimizePeepholeFile(const std::string &p_path, std::string &p_error);
+
+#endif
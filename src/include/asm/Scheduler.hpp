@@ -0,0 +1,36 @@
+#ifndef ASM_SCHEDULER_H
+#define ASM_SCHEDULER_H
+
+#include <string>
+
+#include "asm/AsmProgram.hpp"
+
+// Cycles until the result of each kind of instruction can be used by the
+// next one on an in-order, single-issue core. Everything else takes 1.
+struct PipelineModel {
+  const char *name;
+  unsigned load;
+  unsigned multiply;
+  unsigned divide;
+  // floating-point arithmetic, conversions and comparisons
+  unsigned real;
+  unsigned real_divide;
+};
+
+// nullptr if no core of that name is modelled
+const PipelineModel *findPipelineModel(const std::string &p_name);
+
+// Reorders the straight-line code between labels, branches and calls with a
+// list scheduler, so that independent instructions fill the cycles a use
+// would otherwise wait for a load, multiply or divide. Only register and
+// memory dependences are kept; accesses off the same base register that do
+// not overlap are independent. Returns whether anything changed.
+bool scheduleInstructions(AsmProgram &p_program, const PipelineModel &p_model);
+
+// Runs scheduleInstructions over the assembly file at p_path and writes the
+// result back in its place.
+bool scheduleInstructionsFile(const std::string &p_path,
+                              const PipelineModel &p_model,
+                              std::string &p_error);
+
+#endif
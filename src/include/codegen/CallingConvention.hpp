@@ -0,0 +1,31 @@
+#ifndef CODEGEN_CALLING_CONVENTION_H
+#define CODEGEN_CALLING_CONVENTION_H
+
+#include <cstddef>
+#include <vector>
+
+#include "codegen/RealPrecision.hpp"
+
+// Where the arguments of a call are passed. Integers, booleans and addresses
+// take a0-a7 and reals fa0-fa7, each kind in the order of its arguments; the
+// rest go on the stack in argument order, a word each (a double takes two
+// words aligned to 8), starting at 0(sp) when the callee is entered. Up to
+// eight arguments of each kind this is the standard hard-float ABI, so the C
+// runtime is called the same way.
+struct ArgumentLocation {
+  // nullptr for an argument on the stack
+  const char *reg;
+  // bytes above the stack pointer at the call
+  size_t stack_offset;
+};
+
+struct ArgumentLayout {
+  std::vector<ArgumentLocation> locations;
+  // bytes taken by the stack arguments
+  size_t stack_size = 0;
+};
+
+ArgumentLayout layoutArguments(const std::vector<bool> &p_is_real,
+                               const RealPrecision p_precision);
+
+#endif
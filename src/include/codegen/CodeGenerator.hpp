@@ -1,28 +1,159 @@
 #ifndef CODEGEN_CODE_GENERATOR_H
 #define CODEGEN_CODE_GENERATOR_H
 
+#include <cstdint>
 #include <cstdio>
 #include <map>
 #include <memory>
 #include <string>
 
+#include "AST/InPlaceAppends.hpp"
+#include "AST/operator.hpp"
+#include "codegen/CallingConvention.hpp"
+#include "codegen/FrameLayout.hpp"
+#include "codegen/OutputPath.hpp"
+#include "codegen/RealPrecision.hpp"
 #include "sema/SymbolTable.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
+class ExpressionNode;
+class PType;
+
 class CodeGenerator final : public AstNodeVisitor {
  private:
   const SymbolManager *m_symbol_manager_ptr;
   std::string m_source_file_path;
-  std::unique_ptr<FILE> m_output_file;
+  OutputFile m_output_file;
   bool m_is_global_scope = false;
-  std::map<std::string, std::vector<std::string>> overfit;
-  void genOverfit(const std::vector<std::string> &);
+
+  // Expression values live in small register stacks (t0-t6, and ft0-ft7 for
+  // reals) instead of the memory stack. Registers are handed out and
+  // released in LIFO order, so m_reg_depth (m_freg_depth) is both the number
+  // of live values and the index of the next free register.
+  size_t m_reg_depth = 0;
+  size_t m_freg_depth = 0;
+  // register holding the value of the most recently generated expression
+  const char *m_expr_reg = nullptr;
+  // > 0 while generating an operand, 0 when an expression is a statement
+  size_t m_expr_nesting = 0;
+
+  RealPrecision m_precision;
+  // real constants are loaded from .LC<index>, one per bit pattern of the
+  // double they are written as
+  std::map<uint64_t, size_t> m_real_constants;
+
+  const char *allocReg();
+  const char *allocFloatReg();
+  // of the class of p_reg, which is either on top of its stack or s0
+  void freeReg(const char *p_reg);
+  // registers free in both stacks
+  size_t getNumFreeRegs() const;
+  const char *genExpr(ExpressionNode &p_expr);
+  // the value of p_expr converted to p_type if one is an integer and the
+  // other a real; reals are truncated toward zero
+  const char *genConverted(ExpressionNode &p_expr, const PType *p_type);
+  void genBinaryOperands(BinaryOperatorNode &p_bin_op, const bool p_as_real,
+                         const char *&p_lhs, const char *&p_rhs);
+  // frees both operand registers, whichever was allocated last first
+  void freeOperands(const char *p_lhs, const char *p_rhs);
+  // a register holding the real constant p_value
+  const char *genRealConstant(const double p_value);
+  void genRealConstantPool();
+  // each distinct string literal is emitted once, as .LS<index>
+  std::map<std::string, size_t> m_string_literals;
+  size_t internString(const std::string &p_value);
+  // a register holding the address of the string literal p_value
+  const char *genStringConstant(const std::string &p_value);
+  void genStringLiteralPool();
+  // the assignments of the function (or main program) being generated that
+  // append to a string in place, see findInPlaceAppends()
+  InPlaceAppends m_in_place_appends;
+  // the variable the assignment being generated extends in place
+  const ExpressionNode *m_appended = nullptr;
+  // calls concatString of the runtime, or appendString if the left operand
+  // is a temporary or m_appended, which nothing else holds
+  void genConcatenation(BinaryOperatorNode &p_bin_op);
+
+  // Temporaries are caller-saved: parks the live ones on the stack below sp
+  // and hands the whole register stacks to what is evaluated before the call.
+  struct SavedRegs {
+    size_t regs;
+    size_t fregs;
+    // bytes taken on the stack
+    size_t size;
+  };
+  SavedRegs saveLiveRegs();
+  void restoreLiveRegs(const SavedRegs &p_saved);
+  // into an integer register: 1 if the real comparison p_op holds
+  const char *genRealCompare(const Operator p_op, const char *p_lhs,
+                             const char *p_rhs);
+  bool genByConstant(BinaryOperatorNode &p_bin_op);
+  void spillReg(const char *p_reg);
+  void reloadReg(const char *p_reg);
+  // Labels are numbered in the order they are generated, so the same source
+  // always gives the same assembly. Callers append what the label marks,
+  // e.g., ".L3_else".
+  size_t m_num_labels = 0;
+  std::string newLabel();
+  // Jumps to p_label when the condition evaluates to p_jump_if and falls
+  // through otherwise.
+  void genBranch(ExpressionNode &p_cond, const std::string &p_label,
+                 const bool p_jump_if);
+
+  // 0: chosen per loop, see chooseUnrollFactor()
+  size_t m_unroll_factor;
+  size_t chooseUnrollFactor(ForNode &p_for, const size_t p_trip_count) const;
+  void genCountedLoop(ForNode &p_for, const size_t p_loop_var_offset,
+                      const int64_t p_end, const size_t p_factor,
+                      const std::string &p_label);
+
+  // frame of the function being generated
+  FrameLayout::Frame m_frame{0, true, true};
+
+  // leaf functions without locals neither save ra nor set up s0 and sp
+  bool isFrameless() const;
+  void genPrologue();
+  void genEpilogue();
+
+  // where the arguments of a call to p_name go, see layoutArguments()
+  ArgumentLayout layoutCall(const std::string &p_name) const;
+  // Puts the arguments of a call in their registers and the rest on the
+  // stack, either on top of it (the caller makes room for them) or, for a
+  // tail call, over the incoming stack arguments of the current function.
+  void genArguments(FunctionInvocationNode &p_func_invocation,
+                    const ArgumentLayout &p_layout, const bool p_to_incoming);
+
+  // the function being generated, nullptr in the main program
+  const FunctionNode *m_function = nullptr;
+  // where the parameters of m_function are passed
+  ArgumentLayout m_param_layout;
+  // Returns the value of a call made in tail position by jumping to the
+  // callee with the current frame released, or back to the entry of the
+  // current function if it calls itself. false if the call needs a frame.
+  bool genTailCall(FunctionInvocationNode &p_func_invocation);
+  // Leaves the address of the array element (or subarray) p_variable_ref
+  // refers to as p_disp(base) and returns base: s0 for a local indexed by
+  // constants only, a newly allocated register otherwise. Constant indices
+  // only add to p_disp; variable ones are scaled by their stride.
+  const char *genElementAddress(VariableReferenceNode &p_variable_ref,
+                                int64_t &p_disp);
+  void genScale(const char *p_reg, const size_t p_factor);
+  // stores p_value to the variable or array element and frees it
+  void genStore(VariableReferenceNode &p_variable_ref, const char *p_value);
+  // lw/sw, or the real loads and stores for a floating-point register
+  const char *getLoadMnemonic(const char *p_reg) const;
+  const char *getStoreMnemonic(const char *p_reg) const;
+  // locals live at -offset(s0)
+  void loadLocal(const char *p_reg, const size_t p_offset);
+  void storeLocal(const char *p_reg, const size_t p_offset);
 
  public:
   ~CodeGenerator() = default;
   CodeGenerator(const std::string &source_file_name,
                 const std::string &save_path,
-                const SymbolManager *const p_symbol_manager);
+                const SymbolManager *const p_symbol_manager,
+                const size_t p_unroll_factor = 0,
+                const RealPrecision p_precision = RealPrecision::kSingle);
 
   void visit(ProgramNode &p_program) override;
   void visit(DeclNode &p_decl) override;
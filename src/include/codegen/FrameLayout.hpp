@@ -0,0 +1,60 @@
+#ifndef CODEGEN_FRAME_LAYOUT_H
+#define CODEGEN_FRAME_LAYOUT_H
+
+#include <cstddef>
+
+#include "codegen/RealPrecision.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+class SymbolTable;
+
+// Assigns every local of a function (or of the main program body) a slot at
+// -offset(s0) and computes the size of the frame. Sibling scopes are never
+// alive at the same time, so each of them starts right after the locals of
+// the enclosing scopes and they share the same slots.
+class FrameLayout final : public AstNodeVisitor {
+ public:
+  // ra and the caller's s0 sit right below the frame pointer
+  static constexpr size_t kFrameHeaderSize = 8;
+  static constexpr size_t kStackAlignment = 16;
+
+  struct Frame {
+    // in bytes, a multiple of kStackAlignment
+    size_t size;
+    // no local lives in the frame, only ra and s0 would
+    bool is_empty;
+    // nothing is called, not even the runtime, so ra is never overwritten
+    bool is_leaf;
+  };
+
+ private:
+  const size_t m_real_size;
+  size_t m_offset = kFrameHeaderSize;
+  size_t m_max_offset = kFrameHeaderSize;
+  bool m_has_calls = false;
+
+  void allocate(const SymbolTable *p_table);
+  Frame getFrame() const;
+
+ public:
+  ~FrameLayout() = default;
+  explicit FrameLayout(const RealPrecision p_precision)
+      : m_real_size(getRealSize(p_precision)) {}
+
+  static Frame layoutFunction(FunctionNode &p_function,
+                              const RealPrecision p_precision);
+  static Frame layoutMainProgram(CompoundStatementNode &p_body,
+                                 const RealPrecision p_precision);
+
+  void visit(CompoundStatementNode &p_compound_statement) override;
+  void visit(PrintNode &p_print) override;
+  void visit(FunctionInvocationNode &p_func_invocation) override;
+  void visit(AssignmentNode &p_assignment) override;
+  void visit(ReadNode &p_read) override;
+  void visit(IfNode &p_if) override;
+  void visit(WhileNode &p_while) override;
+  void visit(ForNode &p_for) override;
+  void visit(ReturnNode &p_return) override;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef CODEGEN_IR_CODE_GENERATOR_H
+#define CODEGEN_IR_CODE_GENERATOR_H
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codegen/CallingConvention.hpp"
+#include "codegen/OutputPath.hpp"
+#include "codegen/RealPrecision.hpp"
+#include "codegen/RegisterAllocator.hpp"
+#include "ir/IR.hpp"
+
+// Emits RISC-V assembly from the IR. Virtual registers live in the registers
+// picked by the register allocator; spilled ones get a word (a real) in the
+// frame and go through the scratch registers t0/t1 (ft0/ft1 for reals).
+class IRCodeGenerator {
+ private:
+  const IRModule &m_module;
+  OutputFile m_output_file;
+  RealPrecision m_precision;
+  // the functions of the module by name, the rest are in the runtime
+  std::map<std::string, const IRFunction *> m_functions;
+  // real constants are loaded from .LC<index>, one per bit pattern
+  std::map<int64_t, size_t> m_real_constants;
+
+  // frame layout of the function being generated, offsets are below s0
+  const IRFunction *m_function = nullptr;
+  std::unique_ptr<RegisterAllocator> m_allocator;
+  std::vector<size_t> m_saved_reg_offsets;
+  std::vector<size_t> m_slot_offsets;
+  std::vector<size_t> m_spill_offsets;
+  // where the parameters of the function being generated are passed
+  ArgumentLayout m_param_layout;
+  // 0 if the function needs no frame at all
+  size_t m_frame_size = 0;
+  // calls nothing, so ra is never overwritten
+  bool m_is_leaf = false;
+  // comparison whose only use is the conditional branch right after it; it
+  // is emitted as part of the branch
+  const IRInstruction *m_fused_compare = nullptr;
+
+  void layoutFrame(const IRFunction &p_function);
+  void genGlobals();
+  void genRealConstantPool();
+  // the string literals of the module, see IRModule::internString()
+  void genStringLiteralPool();
+  void genFunction(const IRFunction &p_function);
+  void genInstruction(const IRInstruction &p_instruction,
+                      const IRBasicBlock *p_next);
+  void genBinary(const IROpcode p_opcode, const char *p_dst,
+                 const char *p_lhs, const char *p_rhs);
+  // shifts and reciprocal multiplications for mul/div/rem by a constant,
+  // false if the plain instruction is cheaper
+  bool genByConstant(const IROpcode p_opcode, const char *p_dst,
+                     const char *p_lhs, const int64_t p_imm);
+  // leaf functions without anything in the frame neither save ra nor set
+  // up s0 and sp
+  bool isFrameless() const;
+  void genPrologue();
+  void genEpilogue();
+  void genCall(const IRInstruction &p_call);
+  // by the parameter of the callee if it is in the module, by the argument
+  // itself if it is in the runtime
+  bool isRealArgument(const IRInstruction &p_call, const size_t p_index) const;
+  // where the arguments of the call go, see layoutArguments()
+  ArgumentLayout layoutCall(const IRInstruction &p_call) const;
+  // the runtime takes and returns single precision reals
+  bool convertsAtCall(const IRInstruction &p_call) const;
+  // puts the arguments of a call in their registers and the rest at
+  // p_stack_args
+  void genArguments(const IRInstruction &p_call, const char *p_stack_args);
+  // A call whose result is returned right away, and whose stack arguments
+  // fit in the space of the incoming ones. It jumps to the callee with the
+  // frame already released instead.
+  bool isTailCall(const IRBasicBlock &p_block, const size_t p_index) const;
+  void genTailCall(const IRInstruction &p_call);
+  void genTerminator(const IRInstruction &p_terminator,
+                     const IRBasicBlock *p_next);
+  void genCompareAndBranch(const IRInstruction &p_compare,
+                           const IRBasicBlock *p_then,
+                           const IRBasicBlock *p_else,
+                           const IRBasicBlock *p_next);
+  bool isReal(const IROperand &p_operand) const;
+  // arithmetic on reals, or a comparison of them
+  bool isRealOperation(const IRInstruction &p_instruction) const;
+  void genRealOperation(const IRInstruction &p_instruction, const char *p_dst);
+
+  // mv/lw/sw, or the real ones for a floating-point register
+  const char *getMoveMnemonic(const char *p_reg) const;
+  const char *getLoadMnemonic(const char *p_reg) const;
+  const char *getStoreMnemonic(const char *p_reg) const;
+  // the address of the pool entry of the real constant into t6
+  void loadRealConstantAddress(const IROperand &p_operand);
+  void addImmediate(const char *p_dst, const char *p_src, const int64_t p_imm);
+  void loadFrame(const char *p_reg, const size_t p_offset);
+  void storeFrame(const char *p_reg, const size_t p_offset);
+  // puts the value of the operand into p_reg
+  void loadOperand(const char *p_reg, const IROperand &p_operand);
+  void loadAddress(const char *p_reg, const IROperand &p_operand);
+  // the register holding the value of the operand, which is loaded into
+  // p_scratch if it does not live in one
+  const char *useOperand(const IROperand &p_operand, const char *p_scratch);
+  // the base register for an access p_offset bytes past the pointer, which
+  // may fold the offset into the register and zero it
+  const char *useAddress(const IROperand &p_pointer, int64_t &p_offset);
+  // the register to compute the result of the instruction into, and the
+  // store of it back to the frame if it is spilled
+  const char *defRegister(const IRInstruction &p_instruction);
+  void finishDef(const IRInstruction &p_instruction, const char *p_reg);
+
+ public:
+  ~IRCodeGenerator() = default;
+  IRCodeGenerator(const std::string &source_file_name,
+                  const std::string &save_path, const IRModule &p_module,
+                  const RealPrecision p_precision = RealPrecision::kSingle);
+
+  void generate();
+};
+
+#endif
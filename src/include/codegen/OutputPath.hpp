@@ -0,0 +1,19 @@
+#ifndef CODEGEN_OUTPUT_PATH_H
+#define CODEGEN_OUTPUT_PATH_H
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// FILE handles must be released with fclose, not delete
+struct FileCloser {
+  void operator()(FILE *p_file) const { std::fclose(p_file); }
+};
+using OutputFile = std::unique_ptr<FILE, FileCloser>;
+
+// <save_path>/<basename of source file without extension><p_extension>
+std::string getOutputFilePath(const std::string &p_source_file_name,
+                              const std::string &p_save_path,
+                              const char *p_extension);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef CODEGEN_REAL_PRECISION_H
+#define CODEGEN_REAL_PRECISION_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Reals are computed in IEEE single precision (RV32F) or double precision
+// (RV32D). The runtime's printReal/readReal pass a float either way, so
+// double precision reals are converted at those calls.
+enum class RealPrecision : uint8_t { kSingle, kDouble };
+
+inline size_t getRealSize(const RealPrecision p_precision) {
+  return p_precision == RealPrecision::kDouble ? 8 : 4;
+}
+
+// format suffix of the floating-point instructions, as in fadd.s/fadd.d
+inline const char *getRealSuffix(const RealPrecision p_precision) {
+  return p_precision == RealPrecision::kDouble ? "d" : "s";
+}
+
+inline const char *getRealMove(const RealPrecision p_precision) {
+  return p_precision == RealPrecision::kDouble ? "fmv.d" : "fmv.s";
+}
+
+inline const char *getRealLoad(const RealPrecision p_precision) {
+  return p_precision == RealPrecision::kDouble ? "fld" : "flw";
+}
+
+inline const char *getRealStore(const RealPrecision p_precision) {
+  return p_precision == RealPrecision::kDouble ? "fsd" : "fsw";
+}
+
+// the words holding p_value in memory, low word first; the second one is
+// only used by double precision
+void getRealWords(const RealPrecision p_precision, const double p_value,
+                  uint32_t (&p_words)[2]);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CODEGEN_REGISTER_ALLOCATOR_H
+#define CODEGEN_REGISTER_ALLOCATOR_H
+
+#include <vector>
+
+#include "codegen/CallingConvention.hpp"
+#include "ir/IR.hpp"
+
+// Linear-scan register allocation (Poletto and Sarkar) over the virtual
+// registers of a function out of SSA form. Each virtual register gets one
+// live interval spanning all of its live ranges in block order. When the
+// registers run out, the interval with the lowest spill weight (uses and
+// definitions weighted by 10^loop depth, per unit of length) is spilled to
+// the frame. Reals are given floating-point registers, everything else
+// integer registers. Values live across a call get callee-saved registers;
+// the argument registers go to values that no call overwrites before their
+// last use, a parameter only the one it arrives in.
+class RegisterAllocator {
+ public:
+  struct Interval {
+    size_t vreg;
+    size_t start;
+    size_t end;
+    double spill_cost = 0.0;
+    bool crosses_call = false;
+    // a call comes after the start, up to and including the end, and sets up
+    // its arguments in the argument registers
+    bool reaches_call = false;
+    bool is_param = false;
+    // the argument register the value arrives in: a parameter's, or a0 or
+    // fa0 for the result of a call
+    const char *arg_reg = nullptr;
+    // register whose value flows into this one through a copy
+    size_t hint_vreg = static_cast<size_t>(-1);
+  };
+
+ private:
+  const IRFunction &m_function;
+  const ArgumentLayout &m_param_layout;
+  std::vector<Interval> m_intervals;
+  // per vreg: allocated register, or nullptr if spilled (or unused)
+  std::vector<const char *> m_registers;
+  std::vector<bool> m_spilled;
+  std::vector<const char *> m_used_callee_saved;
+
+  void buildIntervals();
+  void allocate();
+
+ public:
+  ~RegisterAllocator() = default;
+  // p_param_layout tells where the parameters arrive
+  RegisterAllocator(const IRFunction &p_function,
+                    const ArgumentLayout &p_param_layout);
+
+  const char *getRegister(const size_t p_vreg) const {
+    return m_registers[p_vreg];
+  }
+  bool isSpilled(const size_t p_vreg) const { return m_spilled[p_vreg]; }
+  // callee-saved registers handed out, to be saved by the prologue
+  const std::vector<const char *> &getUsedCalleeSaved() const {
+    return m_used_callee_saved;
+  }
+};
+
+#endif
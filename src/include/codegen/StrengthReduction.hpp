@@ -0,0 +1,24 @@
+#ifndef CODEGEN_STRENGTH_REDUCTION_H
+#define CODEGEN_STRENGTH_REDUCTION_H
+
+#include <cstdint>
+#include <cstdio>
+
+// Cheaper sequences for multiplying, dividing and taking the remainder of a
+// 32-bit integer by a constant: shifts and adds instead of mul, and a
+// multiply by the reciprocal instead of div/rem. Quotients truncate toward
+// zero and remainders take the sign of the dividend, as div and rem do.
+//
+// Each one writes p_dst = p_src op p_imm to p_out and returns whether it did;
+// nothing is written when the plain instruction is the better choice. The
+// scratch registers must differ from p_src and p_dst, whereas p_dst may be
+// p_src.
+bool genMulByConstant(FILE *p_out, const char *p_dst, const char *p_src,
+                      const int64_t p_imm, const char *p_scratch);
+bool genDivByConstant(FILE *p_out, const char *p_dst, const char *p_src,
+                      const int64_t p_imm, const char *p_scratch);
+bool genRemByConstant(FILE *p_out, const char *p_dst, const char *p_src,
+                      const int64_t p_imm, const char *p_scratch0,
+                      const char *p_scratch1);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef CODEGEN_STRING_LITERAL_H
+#define CODEGEN_STRING_LITERAL_H
+
+#include <cstdio>
+#include <string>
+
+// Strings are NUL-terminated and passed around by address. Each one is
+// preceded by two words, its length and the number of characters it has room
+// for, which let the runtime concatenate without scanning for the NUL and
+// append in place; see concatString/appendString in test/io.c. Literals are
+// emitted once each into .rodata, with no room to append to.
+
+// p_value quoted and escaped as the operand of a .string directive
+std::string quoteStringLiteral(const std::string &p_value);
+
+// the read-only literal p_value at p_label, header included
+void genStringLiteral(FILE *p_out, const std::string &p_label,
+                      const std::string &p_value);
+
+#endif
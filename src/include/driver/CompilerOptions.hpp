@@ -0,0 +1,48 @@
+#ifndef DRIVER_COMPILER_OPTIONS_H
+#define DRIVER_COMPILER_OPTIONS_H
+
+#include <string>
+
+#include "codegen/RealPrecision.hpp"
+
+struct CompilerOptions {
+  std::string source_file;
+  std::string save_path;
+  bool dump_ast = false;
+  bool dump_ir = false;
+  // 0: generate code straight from the AST, >= 1: go through the IR
+  unsigned opt_level = 0;
+  // IR passes to run instead of the default pipeline of opt_level
+  bool has_passes = false;
+  std::string passes;
+  // unroll factor of counted for loops, 0 picks one from the trip count and
+  // the size of the body, 1 disables unrolling; only the code generated
+  // straight from the AST is unrolled, the IR backend ignores it
+  bool has_unroll = false;
+  size_t unroll_factor = 0;
+  // also assemble the generated code into an ELF relocatable object (.o)
+  bool emit_obj = false;
+  // the source is the whole program, so functions it never calls can go
+  bool whole_program = false;
+  // clean up the generated assembly, see optimizePeephole()
+  bool peephole = true;
+  // reorder the basic blocks of the generated assembly, see layoutBlocks();
+  // far branches are relaxed either way
+  bool block_layout = true;
+  // reorder the instructions of each basic block for the pipeline of the
+  // core named by tune, see scheduleInstructions()
+  bool schedule = true;
+  std::string tune = "generic";
+  // the precision reals are computed in; the runtime takes single
+  RealPrecision real_precision = RealPrecision::kSingle;
+
+  bool useIR() const { return opt_level > 0 || dump_ir || has_passes; }
+};
+
+// Returns false (after reporting to stderr) on malformed command lines.
+bool parseCompilerOptions(const int argc, const char *const argv[],
+                          CompilerOptions &p_options);
+
+void printUsage(const char *p_program);
+
+#endif
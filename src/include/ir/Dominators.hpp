@@ -0,0 +1,44 @@
+#ifndef IR_DOMINATORS_H
+#define IR_DOMINATORS_H
+
+#include <vector>
+
+#include "ir/IR.hpp"
+
+// Dominator tree and dominance frontiers of the blocks reachable from the
+// entry (Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm").
+// Tables are indexed by block id; the CFG must be up to date.
+class DominatorTree {
+ public:
+  using Blocks = std::vector<IRBasicBlock *>;
+
+ private:
+  Blocks m_reverse_post_order;
+  std::vector<size_t> m_rpo_index;
+  Blocks m_idom;
+  std::vector<Blocks> m_children;
+  std::vector<Blocks> m_frontiers;
+
+  void computeReversePostOrder(const IRFunction &p_function);
+  void computeIdoms();
+  void computeFrontiers();
+
+ public:
+  ~DominatorTree() = default;
+  explicit DominatorTree(const IRFunction &p_function);
+
+  const Blocks &getReversePostOrder() const { return m_reverse_post_order; }
+  bool isReachable(const IRBasicBlock *p_block) const;
+
+  // nullptr for the entry block
+  IRBasicBlock *getIdom(const IRBasicBlock *p_block) const;
+  const Blocks &getChildren(const IRBasicBlock *p_block) const {
+    return m_children[p_block->getId()];
+  }
+  const Blocks &getFrontier(const IRBasicBlock *p_block) const {
+    return m_frontiers[p_block->getId()];
+  }
+  bool dominates(const IRBasicBlock *p_dom, const IRBasicBlock *p_block) const;
+};
+
+#endif
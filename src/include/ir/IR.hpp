@@ -0,0 +1,311 @@
+#ifndef IR_IR_H
+#define IR_IR_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * A typed three-address IR. Every instruction defines at most one virtual
+ * register; locals start out in stack slots and are accessed through explicit
+ * loads and stores. Basic blocks end with exactly one terminator, from which
+ * the CFG (predecessors/successors) is derived.
+ */
+
+enum class IRType : uint8_t { kVoid, kBool, kInt, kPtr, kReal };
+
+const char *getIRTypeCString(const IRType p_type);
+
+class IROperand {
+ public:
+  // An integer immediate where a real is expected stands for the real with
+  // that value.
+  enum class Kind : uint8_t { kNone, kVReg, kImm, kSlot, kGlobal, kReal };
+
+ private:
+  Kind m_kind = Kind::kNone;
+  // the bits of the double for a real constant
+  int64_t m_value = 0;
+  std::string m_symbol;
+
+ public:
+  ~IROperand() = default;
+  IROperand() = default;
+
+  static IROperand vreg(const size_t p_id);
+  static IROperand imm(const int64_t p_value);
+  static IROperand slot(const size_t p_id);
+  static IROperand global(const std::string &p_name);
+  static IROperand real(const double p_value);
+
+  Kind getKind() const { return m_kind; }
+  bool isNone() const { return m_kind == Kind::kNone; }
+  bool isVReg() const { return m_kind == Kind::kVReg; }
+  bool isImm() const { return m_kind == Kind::kImm; }
+  bool isSlot() const { return m_kind == Kind::kSlot; }
+  bool isGlobal() const { return m_kind == Kind::kGlobal; }
+  bool isReal() const { return m_kind == Kind::kReal; }
+
+  size_t getVReg() const { return static_cast<size_t>(m_value); }
+  int64_t getImm() const { return m_value; }
+  size_t getSlot() const { return static_cast<size_t>(m_value); }
+  const std::string &getSymbol() const { return m_symbol; }
+  double getReal() const;
+
+  bool operator==(const IROperand &p_other) const;
+  bool operator!=(const IROperand &p_other) const { return !(*this == p_other); }
+};
+
+enum class IROpcode : uint8_t {
+  // dst = op0 <op> op1
+  kAdd,
+  kSub,
+  kMul,
+  kDiv,
+  kRem,
+  kAnd,
+  kOr,
+  // dst = op0 <cmp> op1, yields a boolean; reals compare as reals
+  kCmpEq,
+  kCmpNe,
+  kCmpLt,
+  kCmpLe,
+  kCmpGt,
+  kCmpGe,
+  // dst = <op> op0
+  kNeg,
+  kNot,
+  kCopy,
+  // dst = op0 converted to a real, and to an integer truncated toward zero
+  kIntToReal,
+  kRealToInt,
+  // dst = [op0 + op1], op0 is a slot, a global or a pointer and the byte
+  // offset op1, an immediate, is optional
+  kLoad,
+  // [op1 + op2] = op0, likewise
+  kStore,
+  // dst = &op0, op0 is a slot or a global
+  kAddr,
+  // dst = callee(op0, op1, ...), dst is absent for void callees
+  kCall,
+  // dst = phi [op_i, target_i]
+  kPhi,
+  // terminators
+  kBr,
+  kCondBr,
+  kRet
+};
+
+const char *getIROpcodeCString(const IROpcode p_opcode);
+
+// Evaluates a binary or unary operation on 32-bit constants (p_rhs is ignored
+// for unary ones). Returns false if the result is not known at compile time,
+// e.g., a division by zero.
+bool evaluateIROperation(const IROpcode p_opcode, const int64_t p_lhs,
+                         const int64_t p_rhs, int64_t &p_result);
+
+class IRBasicBlock;
+
+class IRInstruction {
+ public:
+  using Operands = std::vector<IROperand>;
+  using Targets = std::vector<IRBasicBlock *>;
+
+  static constexpr size_t kNoDst = static_cast<size_t>(-1);
+
+ private:
+  IROpcode m_opcode;
+  IRType m_type;
+  size_t m_dst;
+  Operands m_operands;
+  // branch targets, or the incoming blocks of a phi (parallel to operands)
+  Targets m_targets;
+  std::string m_callee;
+
+ public:
+  ~IRInstruction() = default;
+  IRInstruction(const IROpcode p_opcode, const IRType p_type,
+                const size_t p_dst, const Operands &p_operands)
+      : m_opcode(p_opcode),
+        m_type(p_type),
+        m_dst(p_dst),
+        m_operands(p_operands) {}
+
+  IROpcode getOpcode() const { return m_opcode; }
+  void setOpcode(const IROpcode p_opcode) { m_opcode = p_opcode; }
+  const char *getOpcodeCString() const { return getIROpcodeCString(m_opcode); }
+
+  IRType getType() const { return m_type; }
+
+  bool hasDst() const { return m_dst != kNoDst; }
+  size_t getDst() const { return m_dst; }
+  void setDst(const size_t p_dst) { m_dst = p_dst; }
+
+  const Operands &getOperands() const { return m_operands; }
+  Operands &getOperands() { return m_operands; }
+  const IROperand &getOperand(const size_t p_idx) const {
+    return m_operands[p_idx];
+  }
+  void setOperand(const size_t p_idx, const IROperand &p_operand) {
+    m_operands[p_idx] = p_operand;
+  }
+
+  const Targets &getTargets() const { return m_targets; }
+  Targets &getTargets() { return m_targets; }
+  IRBasicBlock *getTarget(const size_t p_idx) const {
+    return m_targets[p_idx];
+  }
+
+  const std::string &getCallee() const { return m_callee; }
+  void setCallee(const std::string &p_callee) { m_callee = p_callee; }
+
+  bool isTerminator() const;
+  bool isBinary() const;
+  bool isUnary() const;
+  bool isComparison() const;
+  // whether the instruction must be kept even if its result is unused
+  bool hasSideEffects() const;
+};
+
+class IRBasicBlock {
+ public:
+  using Instructions = std::vector<std::unique_ptr<IRInstruction>>;
+  using Blocks = std::vector<IRBasicBlock *>;
+
+ private:
+  size_t m_id;
+  Instructions m_instructions;
+  Blocks m_predecessors;
+  Blocks m_successors;
+
+ public:
+  ~IRBasicBlock() = default;
+  IRBasicBlock(const size_t p_id) : m_id(p_id) {}
+
+  size_t getId() const { return m_id; }
+
+  const Instructions &getInstructions() const { return m_instructions; }
+  Instructions &getInstructions() { return m_instructions; }
+
+  IRInstruction *append(IRInstruction *p_instruction);
+  // nullptr if the block is not terminated yet
+  IRInstruction *getTerminator() const;
+
+  const Blocks &getPredecessors() const { return m_predecessors; }
+  const Blocks &getSuccessors() const { return m_successors; }
+  Blocks &getPredecessors() { return m_predecessors; }
+  Blocks &getSuccessors() { return m_successors; }
+};
+
+class IRFunction {
+ public:
+  struct StackSlot {
+    std::string name;
+    size_t size;
+    size_t align;
+  };
+  using Blocks = std::vector<std::unique_ptr<IRBasicBlock>>;
+  using Slots = std::vector<StackSlot>;
+
+ private:
+  std::string m_name;
+  IRType m_ret_type;
+  std::vector<size_t> m_params;
+  std::vector<IRType> m_vreg_types;
+  Slots m_slots;
+  Blocks m_blocks;
+  size_t m_next_block_id = 0;
+
+ public:
+  ~IRFunction() = default;
+  IRFunction(const std::string &p_name, const IRType p_ret_type)
+      : m_name(p_name), m_ret_type(p_ret_type) {}
+
+  const std::string &getName() const { return m_name; }
+  const char *getNameCString() const { return m_name.c_str(); }
+  IRType getReturnType() const { return m_ret_type; }
+
+  size_t newVReg(const IRType p_type);
+  IRType getVRegType(const size_t p_id) const { return m_vreg_types[p_id]; }
+  size_t getNumVRegs() const { return m_vreg_types.size(); }
+
+  size_t addParam(const IRType p_type);
+  const std::vector<size_t> &getParams() const { return m_params; }
+
+  size_t addSlot(const std::string &p_name, const size_t p_size,
+                 const size_t p_align);
+  const Slots &getSlots() const { return m_slots; }
+
+  IRBasicBlock *createBlock();
+  const Blocks &getBlocks() const { return m_blocks; }
+  Blocks &getBlocks() { return m_blocks; }
+  IRBasicBlock *getEntryBlock() const { return m_blocks.front().get(); }
+  // upper bound of the block ids, for tables indexed by block id
+  size_t getNumBlockIds() const { return m_next_block_id; }
+
+  // rebuild predecessor/successor lists from the terminators
+  void recomputeCFG();
+  // drop blocks not reachable from the entry, along with the phi operands
+  // flowing out of them; returns whether anything was removed
+  bool removeUnreachableBlocks();
+  // drop stack slots no instruction refers to and renumber the rest
+  void removeUnusedSlots();
+  // rewrite every use of vreg i into p_replacements[i] unless that is none;
+  // chains of replacements are followed to the end
+  void replaceVRegs(std::vector<IROperand> &p_replacements);
+};
+
+class IRModule {
+ public:
+  struct Global {
+    std::string name;
+    size_t size;
+    size_t align;
+    bool is_constant;
+    // the bits of the double for a real
+    bool is_real;
+    int64_t init;
+    // the label of the literal instead for a string
+    std::string init_symbol;
+  };
+  using Globals = std::vector<Global>;
+  // string literals by their index, see getStringLabel()
+  using Strings = std::map<std::string, size_t>;
+  using Functions = std::vector<std::unique_ptr<IRFunction>>;
+
+ private:
+  std::string m_source_file;
+  Globals m_globals;
+  Strings m_strings;
+  Functions m_functions;
+  // nothing outside the module calls its functions, only main is entered
+  bool m_whole_program = false;
+
+ public:
+  ~IRModule() = default;
+  IRModule(const std::string &p_source_file) : m_source_file(p_source_file) {}
+
+  const std::string &getSourceFile() const { return m_source_file; }
+
+  void setWholeProgram(const bool p_whole_program) {
+    m_whole_program = p_whole_program;
+  }
+  bool isWholeProgram() const { return m_whole_program; }
+
+  void addGlobal(const Global &p_global) { m_globals.push_back(p_global); }
+  const Globals &getGlobals() const { return m_globals; }
+
+  // the label of the read-only copy of the string literal, one per distinct
+  // literal
+  std::string internString(const std::string &p_value);
+  const Strings &getStrings() const { return m_strings; }
+  static std::string getStringLabel(const size_t p_index);
+
+  IRFunction *addFunction(IRFunction *p_function);
+  const Functions &getFunctions() const { return m_functions; }
+  Functions &getFunctions() { return m_functions; }
+};
+
+#endif
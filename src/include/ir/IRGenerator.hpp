@@ -0,0 +1,96 @@
+#ifndef IR_IR_GENERATOR_H
+#define IR_IR_GENERATOR_H
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "AST/InPlaceAppends.hpp"
+#include "codegen/RealPrecision.hpp"
+#include "ir/IR.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+class Constant;
+class ExpressionNode;
+class VariableReferenceNode;
+
+// Lowers the AST to the three-address IR. Every local variable and parameter
+// is given a stack slot; values flow through virtual registers only within a
+// statement.
+class IRGenerator final : public AstNodeVisitor {
+ private:
+  const SymbolManager *m_symbol_manager_ptr;
+  // only decides the size of real variables
+  const size_t m_real_size;
+  std::unique_ptr<IRModule> m_module;
+  IRFunction *m_function = nullptr;
+  IRBasicBlock *m_block = nullptr;
+  // where each variable lives: a stack slot or a global symbol
+  std::map<const SymbolEntry *, IROperand> m_locations;
+  // value of the most recently generated expression
+  IROperand m_value;
+  // the assignments of the function being generated that append to a string
+  // in place, and the variable the one being generated extends
+  InPlaceAppends m_in_place_appends;
+  const ExpressionNode *m_appended = nullptr;
+
+  IROperand genExpr(const ExpressionNode &p_expr);
+  // an immediate, a real, or the address of a string literal
+  IROperand genConstant(const Constant &p_constant);
+  IRType getOperandType(const IROperand &p_operand) const;
+  // p_value as a p_type if one of them is a real and the other an integer
+  IROperand genConversion(const IROperand &p_value, const IRType p_type);
+  IROperand emit(const IROpcode p_opcode, const IRType p_type,
+                 const IRInstruction::Operands &p_operands);
+  void emitStore(const IRType p_type, const IROperand &p_value,
+                 const IROperand &p_addr);
+  void emitStore(const IRType p_type, const IROperand &p_value,
+                 const IRInstruction::Operands &p_location);
+  void emitBranch(IRBasicBlock *p_target);
+  void emitCondBranch(const IROperand &p_cond, IRBasicBlock *p_then,
+                      IRBasicBlock *p_else);
+  // branches to p_true or p_false, evaluating the operands of and/or only
+  // as far as needed to decide
+  void genCondition(const ExpressionNode &p_cond, IRBasicBlock *p_true,
+                    IRBasicBlock *p_false);
+  void emitReturn(const IRType p_type, const IROperand &p_value);
+  void startBlock(IRBasicBlock *p_block) { m_block = p_block; }
+  void finishFunction();
+  const IROperand &getLocation(const std::string &p_name) const;
+  // Address of the array element (or subarray) p_variable_ref refers to,
+  // less the constant p_offset in bytes that the constant indices add up to.
+  IROperand genElementAddress(const VariableReferenceNode &p_variable_ref,
+                              int64_t &p_offset);
+  // the operands of a load or store of the variable or element
+  IRInstruction::Operands genLocation(
+      const VariableReferenceNode &p_variable_ref);
+
+ public:
+  ~IRGenerator() = default;
+  IRGenerator(const std::string &p_source_file_name,
+              const SymbolManager *const p_symbol_manager,
+              const RealPrecision p_precision = RealPrecision::kSingle);
+
+  std::unique_ptr<IRModule> takeModule() { return std::move(m_module); }
+
+  void visit(ProgramNode &p_program) override;
+  void visit(DeclNode &p_decl) override;
+  void visit(VariableNode &p_variable) override;
+  void visit(ConstantValueNode &p_constant_value) override;
+  void visit(FunctionNode &p_function) override;
+  void visit(CompoundStatementNode &p_compound_statement) override;
+  void visit(PrintNode &p_print) override;
+  void visit(BinaryOperatorNode &p_bin_op) override;
+  void visit(UnaryOperatorNode &p_un_op) override;
+  void visit(FunctionInvocationNode &p_func_invocation) override;
+  void visit(VariableReferenceNode &p_variable_ref) override;
+  void visit(AssignmentNode &p_assignment) override;
+  void visit(ReadNode &p_read) override;
+  void visit(IfNode &p_if) override;
+  void visit(WhileNode &p_while) override;
+  void visit(ForNode &p_for) override;
+  void visit(ReturnNode &p_return) override;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef IR_IR_PRINTER_H
+#define IR_IR_PRINTER_H
+
+#include <cstdio>
+
+#include "ir/IR.hpp"
+
+class IRPrinter {
+ private:
+  FILE *m_out;
+
+  void printOperand(const IROperand &p_operand) const;
+  void printInstruction(const IRInstruction &p_instruction) const;
+  void printBasicBlock(const IRBasicBlock &p_block) const;
+
+ public:
+  ~IRPrinter() = default;
+  IRPrinter(FILE *p_out) : m_out(p_out) {}
+
+  void print(const IRModule &p_module) const;
+  void print(const IRFunction &p_function) const;
+};
+
+#endif
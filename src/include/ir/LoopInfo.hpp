@@ -0,0 +1,46 @@
+#ifndef IR_LOOP_INFO_H
+#define IR_LOOP_INFO_H
+
+#include <memory>
+#include <vector>
+
+#include "ir/Dominators.hpp"
+#include "ir/IR.hpp"
+
+// Natural loops of a function, found from the back edges of the CFG
+// (edges whose target dominates their source).
+class LoopInfo {
+ public:
+  struct Loop {
+    IRBasicBlock *header;
+    // blocks of the loop, header first
+    std::vector<IRBasicBlock *> blocks;
+    // sources of the back edges
+    std::vector<IRBasicBlock *> latches;
+    // innermost enclosing loop, nullptr for outermost loops
+    Loop *parent = nullptr;
+  };
+  using Loops = std::vector<std::unique_ptr<Loop>>;
+
+ private:
+  Loops m_loops;
+  // innermost loop of each block (by id), nullptr outside of loops
+  std::vector<Loop *> m_block_loops;
+  std::vector<size_t> m_depths;
+
+ public:
+  ~LoopInfo() = default;
+  LoopInfo(const IRFunction &p_function, const DominatorTree &p_dom_tree);
+
+  // outer loops come before the loops nested in them
+  const Loops &getLoops() const { return m_loops; }
+  Loop *getLoopFor(const IRBasicBlock *p_block) const {
+    return m_block_loops[p_block->getId()];
+  }
+  size_t getLoopDepth(const IRBasicBlock *p_block) const {
+    return m_depths[p_block->getId()];
+  }
+  bool contains(const Loop &p_loop, const IRBasicBlock *p_block) const;
+};
+
+#endif
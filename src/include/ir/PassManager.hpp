@@ -0,0 +1,40 @@
+#ifndef IR_PASS_MANAGER_H
+#define IR_PASS_MANAGER_H
+
+#include <string>
+#include <vector>
+
+#include "ir/IR.hpp"
+
+// Runs a configurable sequence of passes over a module, e.g.,
+// "mem2reg,sccp,copyprop,dce". Function passes run over every function
+// before the next pass starts, module passes run once.
+class IRPassManager {
+ public:
+  using Pass = bool (*)(IRFunction &);
+  using ModulePass = bool (*)(IRModule &);
+
+ private:
+  struct Entry {
+    std::string name;
+    // exactly one of them is set
+    Pass pass;
+    ModulePass module_pass;
+  };
+  std::vector<Entry> m_passes;
+
+ public:
+  ~IRPassManager() = default;
+  IRPassManager() = default;
+
+  // the pipeline used when none is given on the command line
+  static const char *getDefaultPipeline(const unsigned p_opt_level);
+  static Pass findPass(const std::string &p_name);
+  static ModulePass findModulePass(const std::string &p_name);
+
+  // appends the comma-separated passes; false on an unknown pass name
+  bool addPipeline(const std::string &p_pipeline);
+  void run(IRModule &p_module) const;
+};
+
+#endif
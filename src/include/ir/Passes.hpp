@@ -0,0 +1,46 @@
+#ifndef IR_PASSES_H
+#define IR_PASSES_H
+
+#include "ir/IR.hpp"
+
+// Optimizations on SSA form. Each returns whether it changed the function
+// (or module) and leaves the CFG up to date.
+
+// Forwards the source of every copy (and of phis whose incoming values are
+// all the same) to its uses.
+bool propagateCopies(IRFunction &p_function);
+
+// Sparse conditional constant propagation (Wegman and Zadeck): replaces
+// values that are constant on all executable paths and folds branches on
+// them, removing the blocks that become unreachable.
+bool propagateConstants(IRFunction &p_function);
+
+// Removes instructions whose results are never used and that have no side
+// effects, including dead phi cycles, and unreachable blocks.
+bool eliminateDeadCode(IRFunction &p_function);
+
+// Replaces instructions that recompute what an instruction in the same
+// block or in a dominating one already computed by that result. Operands
+// are compared after replacement and commutative operands in either order;
+// loads only match loads with no store or call in between.
+bool numberValues(IRFunction &p_function);
+
+// Turns calls of a function to itself whose result is returned right away
+// into branches back to its start, with phis merging the arguments into the
+// parameters; the recursion becomes a loop that needs no stack.
+bool eliminateTailRecursion(IRFunction &p_function);
+
+// Inlines calls to functions that are small or called from a single place,
+// bottom-up over the call graph; recursive functions are never inlined.
+// Parameters are replaced by the arguments, so constant arguments reach the
+// inlined body, and the callee's stack slots become new slots of the caller.
+// In a whole program, functions no longer reachable from main are removed.
+bool inlineFunctions(IRModule &p_module);
+
+// Loop-invariant code motion: moves computations whose operands are defined
+// outside a loop into a preheader that runs once before it, inner loops
+// first. Loads stay unless nothing in the loop may store to their location;
+// constants are never stored to.
+bool hoistLoopInvariants(IRModule &p_module);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef IR_SSA_H
+#define IR_SSA_H
+
+#include "ir/IR.hpp"
+
+// Promotes stack slots that are only ever loaded from and stored to into SSA
+// virtual registers, inserting phis at the iterated dominance frontiers of
+// their stores (Cytron et al.). Returns whether anything changed.
+bool promoteStackSlots(IRFunction &p_function);
+
+// Translates out of SSA form: splits critical edges and replaces every phi
+// with copies at the end of its predecessors.
+void eliminatePhis(IRFunction &p_function);
+
+#endif
@@ -45,6 +45,7 @@ class SemanticAnalyzer final : public AstNodeVisitor {
   bool hasError() const { return m_has_error; }
 
   const SymbolManager *getSymbolManager() const { return &m_symbol_manager; }
+  SymbolManager *getSymbolManager() { return &m_symbol_manager; }
 
  private:
   bool isInForLoop() const {
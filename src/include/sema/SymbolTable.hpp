@@ -112,6 +112,8 @@ class SymbolTable {
 
   const Entries &getEntries() const { return m_entries; };
 
+  void removeSymbol(const std::string &p_name);
+
   SymbolEntry *addSymbol(const std::string &p_name,
                          const SymbolEntry::KindEnum kind, const size_t level,
                          const PType *const p_type,
@@ -127,8 +129,6 @@ class SymbolManager {
   using Tables = std::vector<std::unique_ptr<SymbolTable>>;
   using NameEntryMap = std::map<std::string, SymbolEntry *>;
 
-  mutable size_t offset = 8;
-
  private:
   Tables m_in_use_tables;
 
@@ -184,6 +184,10 @@ class SymbolManager {
       const SymbolTable *const p_table) const;
   void removeSymbolsFromHashTable(const SymbolTable *const p_table) const;
 
+  // for passes that delete the declaration of a symbol from the AST
+  void removeSymbol(const SymbolTable *const p_table,
+                    const std::string &p_name);
+
  private:
   std::pair<bool, SymbolEntry *> checkExistence(
       const std::string &p_name, const size_t current_level) const;
@@ -0,0 +1,53 @@
+#include "AST/AstNodeCounter.hpp"
+
+#include "visitor/AstNodeInclude.hpp"
+
+template <typename Node>
+void AstNodeCounter::count(Node &p_node) {
+  ++m_count;
+  p_node.visitChildNodes(*this);
+}
+
+void AstNodeCounter::visit(ProgramNode &p_program) { count(p_program); }
+
+void AstNodeCounter::visit(DeclNode &p_decl) { count(p_decl); }
+
+void AstNodeCounter::visit(VariableNode &p_variable) { count(p_variable); }
+
+void AstNodeCounter::visit(ConstantValueNode &p_constant_value) {
+  count(p_constant_value);
+}
+
+void AstNodeCounter::visit(FunctionNode &p_function) { count(p_function); }
+
+void AstNodeCounter::visit(CompoundStatementNode &p_compound_statement) {
+  count(p_compound_statement);
+}
+
+void AstNodeCounter::visit(PrintNode &p_print) { count(p_print); }
+
+void AstNodeCounter::visit(BinaryOperatorNode &p_bin_op) { count(p_bin_op); }
+
+void AstNodeCounter::visit(UnaryOperatorNode &p_un_op) { count(p_un_op); }
+
+void AstNodeCounter::visit(FunctionInvocationNode &p_func_invocation) {
+  count(p_func_invocation);
+}
+
+void AstNodeCounter::visit(VariableReferenceNode &p_variable_ref) {
+  count(p_variable_ref);
+}
+
+void AstNodeCounter::visit(AssignmentNode &p_assignment) {
+  count(p_assignment);
+}
+
+void AstNodeCounter::visit(ReadNode &p_read) { count(p_read); }
+
+void AstNodeCounter::visit(IfNode &p_if) { count(p_if); }
+
+void AstNodeCounter::visit(WhileNode &p_while) { count(p_while); }
+
+void AstNodeCounter::visit(ForNode &p_for) { count(p_for); }
+
+void AstNodeCounter::visit(ReturnNode &p_return) { count(p_return); }
@@ -0,0 +1,266 @@
+#include "AST/ConstantFolder.hpp"
+
+#include <cstdint>
+
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+// Integer and boolean constants are the only ones both backends materialize
+// as immediates, so they are the only ones worth propagating.
+static bool isFoldable(const Constant &p_constant) {
+  return p_constant.getTypePtr()->isPrimitiveInteger() ||
+         p_constant.getTypePtr()->isPrimitiveBool();
+}
+
+static const Constant *getFoldableConstant(const ExpressionNode &p_expr) {
+  const auto *constant_value = dynamic_cast<const ConstantValueNode *>(&p_expr);
+  if (!constant_value || !isFoldable(*constant_value->getConstantPtr())) {
+    return nullptr;
+  }
+  return constant_value->getConstantPtr();
+}
+
+static std::unique_ptr<ExpressionNode> makeConstantValue(
+    const AstNode &p_node, const PType::PrimitiveTypeEnum p_type,
+    const int64_t p_value) {
+  Constant::ConstantValue value;
+  value.integer = 0;
+  if (p_type == PType::PrimitiveTypeEnum::kBoolType) {
+    value.boolean = p_value != 0;
+  } else {
+    // int is 32 bits wide on the target, wrap the same way it would
+    value.integer = static_cast<int32_t>(static_cast<uint32_t>(p_value));
+  }
+  auto *const constant =
+      new Constant(std::make_shared<PType>(p_type), value);
+  auto *const node = new ConstantValueNode(
+      p_node.getLocation().line, p_node.getLocation().col, constant);
+  node->setInferredType(new PType(p_type));
+  return std::unique_ptr<ExpressionNode>(node);
+}
+
+static std::unique_ptr<ExpressionNode> makeInteger(const AstNode &p_node,
+                                                   const int64_t p_value) {
+  return makeConstantValue(p_node, PType::PrimitiveTypeEnum::kIntegerType,
+                           p_value);
+}
+
+static std::unique_ptr<ExpressionNode> makeBoolean(const AstNode &p_node,
+                                                   const bool p_value) {
+  return makeConstantValue(p_node, PType::PrimitiveTypeEnum::kBoolType,
+                           p_value);
+}
+
+static std::unique_ptr<ExpressionNode> foldBinaryOperator(
+    const BinaryOperatorNode &p_bin_op, const Constant &p_left,
+    const Constant &p_right) {
+  if (p_left.getTypePtr()->isPrimitiveBool()) {
+    if (!p_right.getTypePtr()->isPrimitiveBool()) {
+      return nullptr;
+    }
+    switch (p_bin_op.getOp()) {
+      case Operator::kAndOp:
+        return makeBoolean(p_bin_op, p_left.boolean() && p_right.boolean());
+      case Operator::kOrOp:
+        return makeBoolean(p_bin_op, p_left.boolean() || p_right.boolean());
+      default:
+        return nullptr;
+    }
+  }
+  if (!p_right.getTypePtr()->isPrimitiveInteger()) {
+    return nullptr;
+  }
+
+  const auto left = static_cast<int32_t>(p_left.integer());
+  const auto right = static_cast<int32_t>(p_right.integer());
+  // do the arithmetic unsigned so that overflow wraps instead of being UB
+  const auto left_bits = static_cast<uint32_t>(left);
+  const auto right_bits = static_cast<uint32_t>(right);
+  switch (p_bin_op.getOp()) {
+    case Operator::kPlusOp:
+      return makeInteger(p_bin_op, left_bits + right_bits);
+    case Operator::kMinusOp:
+      return makeInteger(p_bin_op, left_bits - right_bits);
+    case Operator::kMultiplyOp:
+      return makeInteger(p_bin_op, left_bits * right_bits);
+    case Operator::kDivideOp:
+    case Operator::kModOp:
+      // the target defines these without trapping, leave them to it
+      if (right == 0 || (left == INT32_MIN && right == -1)) {
+        return nullptr;
+      }
+      return makeInteger(p_bin_op, p_bin_op.getOp() == Operator::kDivideOp
+                                       ? left / right
+                                       : left % right);
+    case Operator::kLessOp:
+      return makeBoolean(p_bin_op, left < right);
+    case Operator::kLessOrEqualOp:
+      return makeBoolean(p_bin_op, left <= right);
+    case Operator::kGreaterOp:
+      return makeBoolean(p_bin_op, left > right);
+    case Operator::kGreaterOrEqualOp:
+      return makeBoolean(p_bin_op, left >= right);
+    case Operator::kEqualOp:
+      return makeBoolean(p_bin_op, left == right);
+    case Operator::kNotEqualOp:
+      return makeBoolean(p_bin_op, left != right);
+    default:
+      return nullptr;
+  }
+}
+
+void ConstantFolder::foldExpr(std::unique_ptr<ExpressionNode> &p_expr) {
+  p_expr->accept(*this);
+  if (m_folded) {
+    p_expr = std::move(m_folded);
+  }
+}
+
+void ConstantFolder::visit(ProgramNode &p_program) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_program.getSymbolTable());
+
+  p_program.visitChildNodes(*this);
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_program.getSymbolTable());
+}
+
+void ConstantFolder::visit(DeclNode &p_decl) {}
+
+void ConstantFolder::visit(VariableNode &p_variable) {}
+
+void ConstantFolder::visit(ConstantValueNode &p_constant_value) {}
+
+void ConstantFolder::visit(FunctionNode &p_function) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_function.getSymbolTable());
+
+  p_function.visitChildNodes(*this);
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+}
+
+void ConstantFolder::visit(CompoundStatementNode &p_compound_statement) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_compound_statement.getSymbolTable());
+
+  p_compound_statement.visitChildNodes(*this);
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(
+      p_compound_statement.getSymbolTable());
+}
+
+void ConstantFolder::visit(PrintNode &p_print) {
+  foldExpr(p_print.getTargetPtr());
+}
+
+void ConstantFolder::visit(BinaryOperatorNode &p_bin_op) {
+  foldExpr(p_bin_op.getLeftOperandPtr());
+  foldExpr(p_bin_op.getRightOperandPtr());
+
+  const auto *left = getFoldableConstant(p_bin_op.getLeftOperand());
+  const auto *right = getFoldableConstant(p_bin_op.getRightOperand());
+  if (left && right) {
+    m_folded = foldBinaryOperator(p_bin_op, *left, *right);
+    return;
+  }
+
+  // and/or short-circuit, so a constant left operand decides whether the
+  // right one is evaluated at all
+  const bool is_and = p_bin_op.getOp() == Operator::kAndOp;
+  if (left && (is_and || p_bin_op.getOp() == Operator::kOrOp)) {
+    if (left->boolean() == is_and) {
+      m_folded = std::move(p_bin_op.getRightOperandPtr());
+    } else {
+      m_folded = makeBoolean(p_bin_op, left->boolean());
+    }
+  }
+}
+
+void ConstantFolder::visit(UnaryOperatorNode &p_un_op) {
+  foldExpr(p_un_op.getOperandPtr());
+
+  const auto *operand = getFoldableConstant(p_un_op.getOperand());
+  if (!operand) {
+    return;
+  }
+  if (p_un_op.getOp() == Operator::kNegOp &&
+      operand->getTypePtr()->isPrimitiveInteger()) {
+    m_folded = makeInteger(
+        p_un_op, 0u - static_cast<uint32_t>(operand->integer()));
+  } else if (p_un_op.getOp() == Operator::kNotOp &&
+             operand->getTypePtr()->isPrimitiveBool()) {
+    m_folded = makeBoolean(p_un_op, !operand->boolean());
+  }
+}
+
+void ConstantFolder::visit(FunctionInvocationNode &p_func_invocation) {
+  for (auto &arg : p_func_invocation.getArguments()) {
+    foldExpr(arg);
+  }
+}
+
+void ConstantFolder::visit(VariableReferenceNode &p_variable_ref) {
+  for (auto &index : p_variable_ref.getIndices()) {
+    foldExpr(index);
+  }
+  if (p_variable_ref.isLvalue() || !p_variable_ref.getIndices().empty()) {
+    return;
+  }
+
+  const auto *entry = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+  if (!entry || entry->getKind() != SymbolEntry::KindEnum::kConstantKind) {
+    return;
+  }
+  const auto *constant = entry->getAttribute().constant();
+  if (!constant || !isFoldable(*constant)) {
+    return;
+  }
+  if (constant->getTypePtr()->isPrimitiveBool()) {
+    m_folded = makeBoolean(p_variable_ref, constant->boolean());
+  } else {
+    m_folded = makeInteger(p_variable_ref, constant->integer());
+  }
+}
+
+void ConstantFolder::visit(AssignmentNode &p_assignment) {
+  // the lvalue itself is never replaced, only its indices are folded
+  for (auto &index : p_assignment.getLvalue().getIndices()) {
+    foldExpr(index);
+  }
+  foldExpr(p_assignment.getExprPtr());
+}
+
+void ConstantFolder::visit(ReadNode &p_read) {
+  auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+  for (auto &index : target.getIndices()) {
+    foldExpr(index);
+  }
+}
+
+void ConstantFolder::visit(IfNode &p_if) {
+  foldExpr(p_if.getConditionPtr());
+  p_if.getBody().accept(*this);
+  if (p_if.getElseBody()) {
+    p_if.getElseBody()->accept(*this);
+  }
+}
+
+void ConstantFolder::visit(WhileNode &p_while) {
+  foldExpr(p_while.getConditionPtr());
+  p_while.getBody().accept(*this);
+}
+
+void ConstantFolder::visit(ForNode &p_for) {
+  // the bounds are literals already, which the code generators rely on
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_for.getSymbolTable());
+
+  p_for.getBody().accept(*this);
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+}
+
+void ConstantFolder::visit(ReturnNode &p_return) {
+  foldExpr(p_return.getReturnValuePtr());
+}
@@ -0,0 +1,252 @@
+#include "AST/DeadCodeEliminator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+// Whether control never falls through the statement.
+static bool alwaysReturns(const AstNode &p_stmt) {
+  if (dynamic_cast<const ReturnNode *>(&p_stmt)) {
+    return true;
+  }
+  if (const auto *compound =
+          dynamic_cast<const CompoundStatementNode *>(&p_stmt)) {
+    return std::any_of(compound->getStatements().begin(),
+                       compound->getStatements().end(),
+                       [](const auto &stmt) { return alwaysReturns(*stmt); });
+  }
+  if (const auto *if_node = dynamic_cast<const IfNode *>(&p_stmt)) {
+    return if_node->getElseBody() && alwaysReturns(if_node->getBody()) &&
+           alwaysReturns(*if_node->getElseBody());
+  }
+  return false;
+}
+
+static const Constant *getConstantCondition(const ExpressionNode &p_cond) {
+  const auto *constant_value = dynamic_cast<const ConstantValueNode *>(&p_cond);
+  if (!constant_value) {
+    return nullptr;
+  }
+  return constant_value->getConstantPtr();
+}
+
+void DeadCodeEliminator::removeUncalledFunctions(ProgramNode &p_program) {
+  auto &functions = p_program.getFuncNodes();
+  auto find_function = [&](const std::string &p_name) {
+    return std::find_if(
+        functions.begin(), functions.end(),
+        [&](const auto &function) { return function->getName() == p_name; });
+  };
+
+  m_phase = Phase::kCollectCalls;
+  m_called.clear();
+  const_cast<CompoundStatementNode &>(p_program.getBody()).accept(*this);
+
+  std::set<std::string> reachable;
+  std::vector<std::string> worklist(m_called.begin(), m_called.end());
+  while (!worklist.empty()) {
+    const auto name = worklist.back();
+    worklist.pop_back();
+    if (!reachable.insert(name).second) {
+      continue;
+    }
+    const auto function = find_function(name);
+    if (function == functions.end()) {
+      continue;
+    }
+    m_called.clear();
+    (*function)->accept(*this);
+    worklist.insert(worklist.end(), m_called.begin(), m_called.end());
+  }
+
+  for (auto it = functions.begin(); it != functions.end();) {
+    if (reachable.count((*it)->getName())) {
+      ++it;
+      continue;
+    }
+    // the symbol entry refers to the name owned by the node
+    m_symbol_manager_ptr->removeSymbol(p_program.getSymbolTable(),
+                                       (*it)->getName());
+    it = functions.erase(it);
+  }
+}
+
+void DeadCodeEliminator::eliminateInBody(CompoundStatementNode &p_body) {
+  m_phase = Phase::kPrune;
+  p_body.accept(*this);
+
+  // removing a store may leave the variables it read unread in turn
+  do {
+    m_read.clear();
+    m_phase = Phase::kCollectReads;
+    p_body.accept(*this);
+
+    m_changed = false;
+    m_phase = Phase::kRemoveDeadStores;
+    p_body.accept(*this);
+  } while (m_changed);
+}
+
+void DeadCodeEliminator::pruneStatements(
+    CompoundStatementNode::StmtNodes &p_stmts) {
+  for (auto it = p_stmts.begin(); it != p_stmts.end();) {
+    if (auto *if_node = dynamic_cast<IfNode *>(it->get())) {
+      if (const auto *cond = getConstantCondition(if_node->getCondition())) {
+        auto &taken = cond->boolean() ? if_node->getBodyPtr()
+                                      : if_node->getElseBodyPtr();
+        if (!taken) {
+          it = p_stmts.erase(it);
+          continue;
+        }
+        *it = std::move(taken);
+      }
+    } else if (auto *while_node = dynamic_cast<WhileNode *>(it->get())) {
+      const auto *cond = getConstantCondition(while_node->getCondition());
+      if (cond && !cond->boolean()) {
+        it = p_stmts.erase(it);
+        continue;
+      }
+    }
+
+    if (alwaysReturns(**it)) {
+      p_stmts.erase(it + 1, p_stmts.end());
+      break;
+    }
+    ++it;
+  }
+}
+
+bool DeadCodeEliminator::isDeadStore(const AssignmentNode &p_assignment) const {
+  const auto &lvalue = p_assignment.getLvalue();
+  const auto *entry = m_symbol_manager_ptr->lookup(lvalue.getName());
+  if (!entry || entry->getLevel() == 0 || m_read.count(entry)) {
+    return false;
+  }
+  if (entry->getKind() != SymbolEntry::KindEnum::kVariableKind &&
+      entry->getKind() != SymbolEntry::KindEnum::kParameterKind) {
+    return false;
+  }
+  // arrays are passed by reference, so the caller sees the elements stored
+  if (entry->getKind() == SymbolEntry::KindEnum::kParameterKind &&
+      !entry->getTypePtr()->getDimensions().empty()) {
+    return false;
+  }
+  return !hasFunctionInvocation(lvalue) &&
+         !hasFunctionInvocation(p_assignment.getExpr());
+}
+
+void DeadCodeEliminator::visit(ProgramNode &p_program) {
+  // before the global symbols are looked up, as it removes some of them
+  if (m_whole_program) {
+    removeUncalledFunctions(p_program);
+  }
+  m_phase = Phase::kPrune;
+
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_program.getSymbolTable());
+
+  for (auto &function : p_program.getFuncNodes()) {
+    function->accept(*this);
+  }
+  eliminateInBody(const_cast<CompoundStatementNode &>(p_program.getBody()));
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_program.getSymbolTable());
+}
+
+void DeadCodeEliminator::visit(FunctionNode &p_function) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_function.getSymbolTable());
+
+  if (m_phase == Phase::kCollectCalls) {
+    p_function.visitChildNodes(*this);
+  } else if (p_function.getBody()) {
+    eliminateInBody(*p_function.getBody());
+  }
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+}
+
+void DeadCodeEliminator::visit(CompoundStatementNode &p_compound_statement) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_compound_statement.getSymbolTable());
+
+  auto &stmts = p_compound_statement.getStatements();
+  for (auto &stmt : stmts) {
+    stmt->accept(*this);
+  }
+
+  if (m_phase == Phase::kPrune) {
+    pruneStatements(stmts);
+  } else if (m_phase == Phase::kRemoveDeadStores) {
+    const auto old_size = stmts.size();
+    stmts.erase(std::remove_if(stmts.begin(), stmts.end(),
+                               [&](const auto &stmt) {
+                                 const auto *assignment =
+                                     dynamic_cast<AssignmentNode *>(stmt.get());
+                                 return assignment && isDeadStore(*assignment);
+                               }),
+                stmts.end());
+    m_changed |= stmts.size() != old_size;
+  }
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(
+      p_compound_statement.getSymbolTable());
+}
+
+void DeadCodeEliminator::visit(PrintNode &p_print) {
+  p_print.visitChildNodes(*this);
+}
+
+void DeadCodeEliminator::visit(BinaryOperatorNode &p_bin_op) {
+  p_bin_op.visitChildNodes(*this);
+}
+
+void DeadCodeEliminator::visit(UnaryOperatorNode &p_un_op) {
+  p_un_op.visitChildNodes(*this);
+}
+
+void DeadCodeEliminator::visit(FunctionInvocationNode &p_func_invocation) {
+  if (m_phase == Phase::kCollectCalls) {
+    m_called.insert(p_func_invocation.getName());
+  }
+  p_func_invocation.visitChildNodes(*this);
+}
+
+void DeadCodeEliminator::visit(VariableReferenceNode &p_variable_ref) {
+  p_variable_ref.visitChildNodes(*this);
+  if (m_phase == Phase::kCollectReads) {
+    m_read.insert(m_symbol_manager_ptr->lookup(p_variable_ref.getName()));
+  }
+}
+
+void DeadCodeEliminator::visit(AssignmentNode &p_assignment) {
+  // storing to the lvalue doesn't read it, but its indices are read
+  p_assignment.getLvalue().visitChildNodes(*this);
+  p_assignment.getExpr().accept(*this);
+}
+
+void DeadCodeEliminator::visit(ReadNode &p_read) {
+  auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+  target.visitChildNodes(*this);
+}
+
+void DeadCodeEliminator::visit(IfNode &p_if) { p_if.visitChildNodes(*this); }
+
+void DeadCodeEliminator::visit(WhileNode &p_while) {
+  p_while.visitChildNodes(*this);
+}
+
+void DeadCodeEliminator::visit(ForNode &p_for) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_for.getSymbolTable());
+
+  p_for.getBody().accept(*this);
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+}
+
+void DeadCodeEliminator::visit(ReturnNode &p_return) {
+  p_return.visitChildNodes(*this);
+}
@@ -0,0 +1,174 @@
+#include "AST/InPlaceAppends.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+const ExpressionNode &getConcatenationBase(const ExpressionNode &p_expr) {
+  const auto *expr = &p_expr;
+  while (isConcatenation(*expr)) {
+    expr = &static_cast<const BinaryOperatorNode *>(expr)->getLeftOperand();
+  }
+  return *expr;
+}
+
+class InPlaceAppendFinder final : public AstNodeVisitor {
+ private:
+  const SymbolManager *m_symbol_manager_ptr;
+  // the string variables whose value may be shared with something else
+  std::set<const SymbolEntry *> m_shared;
+  std::vector<std::pair<const AssignmentNode *, const SymbolEntry *>>
+      m_appends;
+
+  // the string variable the expression reads, nullptr for anything else,
+  // including elements of string arrays
+  const SymbolEntry *getStringVariable(const ExpressionNode &p_expr) const {
+    const auto *ref = dynamic_cast<const VariableReferenceNode *>(&p_expr);
+    if (!ref || !ref->getIndices().empty()) {
+      return nullptr;
+    }
+    const auto *entry = m_symbol_manager_ptr->lookup(ref->getName());
+    return (entry && entry->getTypePtr()->isString()) ? entry : nullptr;
+  }
+
+  // whether the expression reads the variable anywhere, indices included
+  bool reads(const ExpressionNode &p_expr, const SymbolEntry *p_entry) const {
+    if (const auto *bin_op = dynamic_cast<const BinaryOperatorNode *>(&p_expr)) {
+      return reads(bin_op->getLeftOperand(), p_entry) ||
+             reads(bin_op->getRightOperand(), p_entry);
+    }
+    if (const auto *un_op = dynamic_cast<const UnaryOperatorNode *>(&p_expr)) {
+      return reads(un_op->getOperand(), p_entry);
+    }
+    if (const auto *call =
+            dynamic_cast<const FunctionInvocationNode *>(&p_expr)) {
+      return std::any_of(
+          call->getArguments().begin(), call->getArguments().end(),
+          [&](const auto &arg) { return reads(*arg, p_entry); });
+    }
+    if (const auto *ref = dynamic_cast<const VariableReferenceNode *>(&p_expr)) {
+      return m_symbol_manager_ptr->lookup(ref->getName()) == p_entry ||
+             std::any_of(
+                 ref->getIndices().begin(), ref->getIndices().end(),
+                 [&](const auto &index) { return reads(*index, p_entry); });
+    }
+    return false;
+  }
+
+  // whether the chain of concatenations reads the variable past its base
+  bool readsPastBase(const ExpressionNode &p_expr,
+                     const SymbolEntry *p_entry) const {
+    const auto *expr = &p_expr;
+    while (isConcatenation(*expr)) {
+      const auto *bin_op = static_cast<const BinaryOperatorNode *>(expr);
+      if (reads(bin_op->getRightOperand(), p_entry)) {
+        return true;
+      }
+      expr = &bin_op->getLeftOperand();
+    }
+    return false;
+  }
+
+  // reading the variable as a whole hands out its value
+  void share(const ExpressionNode &p_expr) {
+    if (const auto *entry = getStringVariable(p_expr)) {
+      m_shared.insert(entry);
+    }
+  }
+
+ public:
+  explicit InPlaceAppendFinder(const SymbolManager *p_symbol_manager)
+      : m_symbol_manager_ptr(p_symbol_manager) {}
+
+  InPlaceAppends getInPlaceAppends() const {
+    InPlaceAppends appends;
+    for (const auto &append : m_appends) {
+      const auto *entry = append.second;
+      if (entry->getLevel() > 0 &&
+          entry->getKind() == SymbolEntry::KindEnum::kVariableKind &&
+          !m_shared.count(entry)) {
+        appends.insert(append.first);
+      }
+    }
+    return appends;
+  }
+
+  void visit(CompoundStatementNode &p_compound_statement) override {
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+        p_compound_statement.getSymbolTable());
+    p_compound_statement.visitChildNodes(*this);
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(
+        p_compound_statement.getSymbolTable());
+  }
+  void visit(ForNode &p_for) override {
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+        p_for.getSymbolTable());
+    p_for.visitChildNodes(*this);
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+  }
+  void visit(IfNode &p_if) override { p_if.visitChildNodes(*this); }
+  void visit(WhileNode &p_while) override { p_while.visitChildNodes(*this); }
+  void visit(PrintNode &p_print) override { p_print.visitChildNodes(*this); }
+  void visit(BinaryOperatorNode &p_bin_op) override {
+    p_bin_op.visitChildNodes(*this);
+  }
+  void visit(UnaryOperatorNode &p_un_op) override {
+    p_un_op.visitChildNodes(*this);
+  }
+  void visit(VariableReferenceNode &p_variable_ref) override {
+    p_variable_ref.visitChildNodes(*this);
+  }
+
+  void visit(FunctionInvocationNode &p_func_invocation) override {
+    for (const auto &arg : p_func_invocation.getArguments()) {
+      share(*arg);
+    }
+    p_func_invocation.visitChildNodes(*this);
+  }
+
+  void visit(ReturnNode &p_return) override {
+    share(p_return.getReturnValue());
+    p_return.visitChildNodes(*this);
+  }
+
+  void visit(ReadNode &p_read) override {
+    if (const auto *entry = getStringVariable(p_read.getTarget())) {
+      m_shared.insert(entry);
+    }
+    p_read.visitChildNodes(*this);
+  }
+
+  void visit(AssignmentNode &p_assignment) override {
+    const auto &expr = p_assignment.getExpr();
+    const auto *target = getStringVariable(p_assignment.getLvalue());
+    if (getStringVariable(expr)) {
+      // both variables hold the same string afterwards
+      share(expr);
+      if (target) {
+        m_shared.insert(target);
+      }
+    } else if (target) {
+      const bool is_concatenation = isConcatenation(expr);
+      if (is_concatenation &&
+          target == getStringVariable(getConcatenationBase(expr)) &&
+          !readsPastBase(expr, target)) {
+        m_appends.emplace_back(&p_assignment, target);
+      } else if (!is_concatenation &&
+                 !dynamic_cast<const ConstantValueNode *>(&expr)) {
+        // the result of a call may be anything's
+        m_shared.insert(target);
+      }
+    }
+    p_assignment.visitChildNodes(*this);
+  }
+};
+
+InPlaceAppends findInPlaceAppends(CompoundStatementNode &p_body,
+                                  const SymbolManager *p_symbol_manager) {
+  InPlaceAppendFinder finder(p_symbol_manager);
+  p_body.accept(finder);
+  return finder.getInPlaceAppends();
+}
@@ -0,0 +1,35 @@
+#include "AST/expression.hpp"
+
+#include <algorithm>
+
+#include "AST/BinaryOperator.hpp"
+#include "AST/FunctionInvocation.hpp"
+#include "AST/UnaryOperator.hpp"
+#include "AST/VariableReference.hpp"
+
+bool hasFunctionInvocation(const ExpressionNode &p_expr) {
+  if (dynamic_cast<const FunctionInvocationNode *>(&p_expr)) {
+    return true;
+  }
+  if (isConcatenation(p_expr)) {
+    return true;
+  }
+  if (const auto *bin_op = dynamic_cast<const BinaryOperatorNode *>(&p_expr)) {
+    return hasFunctionInvocation(bin_op->getLeftOperand()) ||
+           hasFunctionInvocation(bin_op->getRightOperand());
+  }
+  if (const auto *un_op = dynamic_cast<const UnaryOperatorNode *>(&p_expr)) {
+    return hasFunctionInvocation(un_op->getOperand());
+  }
+  if (const auto *ref = dynamic_cast<const VariableReferenceNode *>(&p_expr)) {
+    return std::any_of(
+        ref->getIndices().begin(), ref->getIndices().end(),
+        [](const auto &index) { return hasFunctionInvocation(*index); });
+  }
+  return false;
+}
+
+bool isConcatenation(const ExpressionNode &p_expr) {
+  return dynamic_cast<const BinaryOperatorNode *>(&p_expr) &&
+         p_expr.getInferredType() && p_expr.getInferredType()->isString();
+}
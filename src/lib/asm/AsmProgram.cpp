@@ -0,0 +1,129 @@
+#include "asm/AsmProgram.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+static std::string trim(const std::string &p_str) {
+  const auto begin = p_str.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  const auto end = p_str.find_last_not_of(" \t\r");
+  return p_str.substr(begin, end - begin + 1);
+}
+
+// drops a trailing '#' comment, leaving string literals alone
+static std::string stripComment(const std::string &p_line) {
+  bool in_string = false;
+  for (size_t i = 0; i < p_line.size(); ++i) {
+    if (in_string && p_line[i] == '\\') {
+      ++i;
+    } else if (p_line[i] == '"') {
+      in_string = !in_string;
+    } else if (!in_string && p_line[i] == '#') {
+      return p_line.substr(0, i);
+    }
+  }
+  return p_line;
+}
+
+static std::vector<std::string> splitOperands(const std::string &p_str) {
+  std::vector<std::string> operands;
+  std::string current;
+  bool in_string = false;
+  for (size_t i = 0; i < p_str.size(); ++i) {
+    const char c = p_str[i];
+    if (in_string && c == '\\' && i + 1 < p_str.size()) {
+      current += c;
+      current += p_str[++i];
+      continue;
+    }
+    if (c == '"') {
+      in_string = !in_string;
+    } else if (c == ',' && !in_string) {
+      operands.push_back(trim(current));
+      current.clear();
+      continue;
+    }
+    current += c;
+  }
+  if (!trim(current).empty() || !operands.empty()) {
+    operands.push_back(trim(current));
+  }
+  return operands;
+}
+
+static bool isSymbolChar(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' ||
+         c == '$';
+}
+
+bool AsmProgram::parse(const std::string &p_text, std::string &p_error) {
+  std::istringstream input(p_text);
+  std::string raw_line;
+  size_t line_num = 0;
+  while (std::getline(input, raw_line)) {
+    ++line_num;
+    auto line = trim(stripComment(raw_line));
+
+    // any number of labels may precede a statement
+    while (!line.empty()) {
+      size_t end = 0;
+      while (end < line.size() && isSymbolChar(line[end])) {
+        ++end;
+      }
+      if (end == 0 || end >= line.size() || line[end] != ':') {
+        break;
+      }
+      m_statements.push_back(AsmStatement{AsmStatement::Kind::kLabel,
+                                          line.substr(0, end), {}, line_num});
+      line = trim(line.substr(end + 1));
+    }
+    if (line.empty()) {
+      continue;
+    }
+
+    const auto name_end = line.find_first_of(" \t");
+    const auto name = line.substr(0, name_end);
+    const auto rest =
+        (name_end == std::string::npos) ? "" : trim(line.substr(name_end));
+    const auto kind = (name[0] == '.') ? AsmStatement::Kind::kDirective
+                                       : AsmStatement::Kind::kInstruction;
+    if (kind == AsmStatement::Kind::kInstruction &&
+        !std::isalpha(static_cast<unsigned char>(name[0]))) {
+      p_error = "line " + std::to_string(line_num) + ": invalid statement \"" +
+                line + "\"";
+      return false;
+    }
+    m_statements.push_back(
+        AsmStatement{kind, name, splitOperands(rest), line_num});
+  }
+  return true;
+}
+
+bool AsmProgram::parseFile(const std::string &p_path, std::string &p_error) {
+  std::ifstream input(p_path);
+  if (!input) {
+    p_error = "cannot open " + p_path;
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << input.rdbuf();
+  return parse(buffer.str(), p_error);
+}
+
+void AsmProgram::print(FILE *p_out) const {
+  for (const auto &statement : m_statements) {
+    if (statement.kind == AsmStatement::Kind::kLabel) {
+      std::fprintf(p_out, "%s:\n", statement.name.c_str());
+      continue;
+    }
+    std::fprintf(p_out, "    %s", statement.name.c_str());
+    for (size_t i = 0; i < statement.operands.size(); ++i) {
+      std::fprintf(p_out, "%s%s", (i == 0) ? " " : ", ",
+                   statement.operands[i].c_str());
+    }
+    std::fprintf(p_out, "\n");
+  }
+}
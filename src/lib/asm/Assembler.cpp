@@ -0,0 +1,945 @@
+#include "asm/Assembler.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+// ===========================================
+// > Instruction encoding
+// ===========================================
+static constexpr uint32_t kOpcodeLoad = 0x03;
+static constexpr uint32_t kOpcodeLoadFp = 0x07;
+static constexpr uint32_t kOpcodeOpImm = 0x13;
+static constexpr uint32_t kOpcodeAuipc = 0x17;
+static constexpr uint32_t kOpcodeStore = 0x23;
+static constexpr uint32_t kOpcodeStoreFp = 0x27;
+static constexpr uint32_t kOpcodeOp = 0x33;
+static constexpr uint32_t kOpcodeLui = 0x37;
+static constexpr uint32_t kOpcodeOpFp = 0x53;
+static constexpr uint32_t kOpcodeBranch = 0x63;
+static constexpr uint32_t kOpcodeJalr = 0x67;
+static constexpr uint32_t kOpcodeJal = 0x6f;
+
+static constexpr uint32_t kZero = 0;
+static constexpr uint32_t kRa = 1;
+static constexpr uint32_t kT1 = 6;
+
+// rounding mode of the floating-point instructions that round: dynamic, as
+// set in fcsr
+static constexpr uint32_t kRoundDynamic = 7;
+
+static uint32_t encodeR(const uint32_t p_funct7, const uint32_t p_rs2,
+                        const uint32_t p_rs1, const uint32_t p_funct3,
+                        const uint32_t p_rd, const uint32_t p_opcode) {
+  return (p_funct7 << 25) | (p_rs2 << 20) | (p_rs1 << 15) | (p_funct3 << 12) |
+         (p_rd << 7) | p_opcode;
+}
+
+static uint32_t encodeI(const int64_t p_imm, const uint32_t p_rs1,
+                        const uint32_t p_funct3, const uint32_t p_rd,
+                        const uint32_t p_opcode) {
+  return ((static_cast<uint32_t>(p_imm) & 0xfff) << 20) | (p_rs1 << 15) |
+         (p_funct3 << 12) | (p_rd << 7) | p_opcode;
+}
+
+static uint32_t encodeS(const int64_t p_imm, const uint32_t p_rs2,
+                        const uint32_t p_rs1, const uint32_t p_funct3,
+                        const uint32_t p_opcode) {
+  const auto imm = static_cast<uint32_t>(p_imm);
+  return (((imm >> 5) & 0x7f) << 25) | (p_rs2 << 20) | (p_rs1 << 15) |
+         (p_funct3 << 12) | ((imm & 0x1f) << 7) | p_opcode;
+}
+
+static uint32_t encodeB(const int64_t p_offset, const uint32_t p_rs2,
+                        const uint32_t p_rs1, const uint32_t p_funct3) {
+  const auto imm = static_cast<uint32_t>(p_offset);
+  return (((imm >> 12) & 0x1) << 31) | (((imm >> 5) & 0x3f) << 25) |
+         (p_rs2 << 20) | (p_rs1 << 15) | (p_funct3 << 12) |
+         (((imm >> 1) & 0xf) << 8) | (((imm >> 11) & 0x1) << 7) |
+         kOpcodeBranch;
+}
+
+static uint32_t encodeU(const uint32_t p_imm20, const uint32_t p_rd,
+                        const uint32_t p_opcode) {
+  return ((p_imm20 & 0xfffff) << 12) | (p_rd << 7) | p_opcode;
+}
+
+static uint32_t encodeJ(const int64_t p_offset, const uint32_t p_rd) {
+  const auto imm = static_cast<uint32_t>(p_offset);
+  return (((imm >> 20) & 0x1) << 31) | (((imm >> 1) & 0x3ff) << 21) |
+         (((imm >> 11) & 0x1) << 20) | (((imm >> 12) & 0xff) << 12) |
+         (p_rd << 7) | kOpcodeJal;
+}
+
+static bool fitsSigned(const int64_t p_value, const unsigned p_bits) {
+  const int64_t limit = int64_t{1} << (p_bits - 1);
+  return p_value >= -limit && p_value < limit;
+}
+
+struct RTypeInfo {
+  const char *mnemonic;
+  uint32_t funct7;
+  uint32_t funct3;
+};
+
+static const RTypeInfo kRTypeInstructions[] = {
+    {"add", 0x00, 0},  {"sub", 0x20, 0},    {"sll", 0x00, 1},
+    {"slt", 0x00, 2},  {"sltu", 0x00, 3},   {"xor", 0x00, 4},
+    {"srl", 0x00, 5},  {"sra", 0x20, 5},    {"or", 0x00, 6},
+    {"and", 0x00, 7},  {"mul", 0x01, 0},    {"mulh", 0x01, 1},
+    {"mulhsu", 0x01, 2}, {"mulhu", 0x01, 3}, {"div", 0x01, 4},
+    {"divu", 0x01, 5}, {"rem", 0x01, 6},    {"remu", 0x01, 7},
+};
+
+struct FunctInfo {
+  const char *mnemonic;
+  uint32_t funct3;
+};
+
+static const FunctInfo kImmInstructions[] = {
+    {"addi", 0}, {"slti", 2}, {"sltiu", 3}, {"xori", 4}, {"ori", 6}, {"andi", 7},
+};
+static const RTypeInfo kShiftImmInstructions[] = {
+    {"slli", 0x00, 1}, {"srli", 0x00, 5}, {"srai", 0x20, 5}};
+static const FunctInfo kLoadInstructions[] = {
+    {"lb", 0}, {"lh", 1}, {"lw", 2}, {"lbu", 4}, {"lhu", 5}};
+static const FunctInfo kStoreInstructions[] = {{"sb", 0}, {"sh", 1}, {"sw", 2}};
+static const FunctInfo kBranchInstructions[] = {
+    {"beq", 0}, {"bne", 1}, {"blt", 4}, {"bge", 5}, {"bltu", 6}, {"bgeu", 7}};
+
+static const FunctInfo kFloatLoadInstructions[] = {{"flw", 2}, {"fld", 3}};
+static const FunctInfo kFloatStoreInstructions[] = {{"fsw", 2}, {"fsd", 3}};
+
+// funct7 holds the format in its low bits, 0 for .s and 1 for .d; funct3 is
+// the rounding mode for those that round
+static const RTypeInfo kFloatRTypeInstructions[] = {
+    {"fadd.s", 0x00, kRoundDynamic}, {"fadd.d", 0x01, kRoundDynamic},
+    {"fsub.s", 0x04, kRoundDynamic}, {"fsub.d", 0x05, kRoundDynamic},
+    {"fmul.s", 0x08, kRoundDynamic}, {"fmul.d", 0x09, kRoundDynamic},
+    {"fdiv.s", 0x0c, kRoundDynamic}, {"fdiv.d", 0x0d, kRoundDynamic},
+    {"fsgnj.s", 0x10, 0},            {"fsgnj.d", 0x11, 0},
+    {"fsgnjn.s", 0x10, 1},           {"fsgnjn.d", 0x11, 1},
+    {"fsgnjx.s", 0x10, 2},           {"fsgnjx.d", 0x11, 2},
+    {"fmin.s", 0x14, 0},             {"fmin.d", 0x15, 0},
+    {"fmax.s", 0x14, 1},             {"fmax.d", 0x15, 1}};
+
+// comparisons of two floating-point registers into an integer register
+static const RTypeInfo kFloatCompareInstructions[] = {
+    {"feq.s", 0x50, 2}, {"feq.d", 0x51, 2}, {"flt.s", 0x50, 1},
+    {"flt.d", 0x51, 1}, {"fle.s", 0x50, 0}, {"fle.d", 0x51, 0}};
+
+// sign injections of a register with itself, e.g., "fneg.s a, b" is
+// "fsgnjn.s a, b, b"
+static const RTypeInfo kFloatMoveInstructions[] = {
+    {"fmv.s", 0x10, 0},  {"fmv.d", 0x11, 0},  {"fneg.s", 0x10, 1},
+    {"fneg.d", 0x11, 1}, {"fabs.s", 0x10, 2}, {"fabs.d", 0x11, 2}};
+
+struct FloatConvertInfo {
+  const char *mnemonic;
+  uint32_t funct7;
+  uint32_t rs2;
+  bool rd_is_float;
+  bool rs1_is_float;
+};
+
+static const FloatConvertInfo kFloatConvertInstructions[] = {
+    {"fcvt.s.w", 0x68, 0, true, false}, {"fcvt.d.w", 0x69, 0, true, false},
+    {"fcvt.w.s", 0x60, 0, false, true}, {"fcvt.w.d", 0x61, 0, false, true},
+    {"fcvt.s.d", 0x20, 1, true, true},  {"fcvt.d.s", 0x21, 0, true, true},
+    {"fmv.x.w", 0x70, 0, false, true},  {"fmv.w.x", 0x78, 0, true, false}};
+
+static const FunctInfo kRoundingModes[] = {{"rne", 0}, {"rtz", 1}, {"rdn", 2},
+                                           {"rup", 3}, {"rmm", 4}, {"dyn", 7}};
+
+// branches with swapped operands, e.g., "bgt a, b" is "blt b, a"
+static const FunctInfo kSwappedBranchInstructions[] = {
+    {"bgt", 4}, {"ble", 5}, {"bgtu", 6}, {"bleu", 7}};
+
+struct ZeroBranchInfo {
+  const char *mnemonic;
+  uint32_t funct3;
+  // whether the register goes to rs2 (compared against zero in rs1)
+  bool reg_is_rs2;
+};
+
+static const ZeroBranchInfo kZeroBranchInstructions[] = {
+    {"beqz", 0, false}, {"bnez", 1, false}, {"bltz", 4, false},
+    {"bgez", 5, false}, {"blez", 5, true},  {"bgtz", 4, true}};
+
+template <typename Info, size_t N>
+static const Info *findInfo(const Info (&p_table)[N], const std::string &p_name) {
+  for (const auto &info : p_table) {
+    if (p_name == info.mnemonic) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+static const char *const kRegisterNames[] = {
+    "zero", "ra", "sp", "gp", "tp",  "t0",  "t1", "t2", "s0", "s1", "a0",
+    "a1",   "a2", "a3", "a4", "a5",  "a6",  "a7", "s2", "s3", "s4", "s5",
+    "s6",   "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"};
+
+static const char *const kFloatRegisterNames[] = {
+    "ft0", "ft1", "ft2",  "ft3",  "ft4", "ft5", "ft6",  "ft7",
+    "fs0", "fs1", "fa0",  "fa1",  "fa2", "fa3", "fa4",  "fa5",
+    "fa6", "fa7", "fs2",  "fs3",  "fs4", "fs5", "fs6",  "fs7",
+    "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11"};
+
+// ===========================================
+// > Assembler
+// ===========================================
+bool Assembler::fail(const std::string &p_message) {
+  m_error = "line " + std::to_string(m_line) + ": " + p_message;
+  return false;
+}
+
+Assembler::SymbolInfo &Assembler::getSymbol(const std::string &p_name) {
+  auto it = m_symbols.find(p_name);
+  if (it == m_symbols.end()) {
+    m_symbol_order.push_back(p_name);
+    it = m_symbols.emplace(p_name, SymbolInfo{}).first;
+  }
+  return it->second;
+}
+
+void Assembler::emitWord(const uint32_t p_word) { emitBytes(p_word, 4); }
+
+void Assembler::emitBytes(const uint64_t p_value, const size_t p_size) {
+  auto &section = currentSection();
+  if (section.kind == ObjectFile::Section::Kind::kBss) {
+    section.nobits_size += p_size;
+    return;
+  }
+  for (size_t i = 0; i < p_size; ++i) {
+    section.data.push_back((p_value >> (8 * i)) & 0xff);
+  }
+}
+
+void Assembler::addRelocation(const RiscvRelocation p_type,
+                              const std::string &p_symbol,
+                              const int32_t p_addend) {
+  if (m_final_pass) {
+    getSymbol(p_symbol).is_referenced = true;
+    m_relocations.push_back(PendingRelocation{m_section, currentOffset(),
+                                              p_type, p_symbol, p_addend});
+  }
+}
+
+bool Assembler::parseRegister(const std::string &p_operand, uint32_t &p_reg) {
+  for (uint32_t i = 0; i < 32; ++i) {
+    if (p_operand == kRegisterNames[i]) {
+      p_reg = i;
+      return true;
+    }
+  }
+  if (p_operand == "fp") {
+    p_reg = 8;
+    return true;
+  }
+  if (p_operand.size() >= 2 && p_operand[0] == 'x') {
+    char *end = nullptr;
+    const auto idx = std::strtoul(p_operand.c_str() + 1, &end, 10);
+    if (*end == '\0' && idx < 32) {
+      p_reg = static_cast<uint32_t>(idx);
+      return true;
+    }
+  }
+  return fail("invalid register \"" + p_operand + "\"");
+}
+
+bool Assembler::parseFloatRegister(const std::string &p_operand,
+                                   uint32_t &p_reg) {
+  for (uint32_t i = 0; i < 32; ++i) {
+    if (p_operand == kFloatRegisterNames[i]) {
+      p_reg = i;
+      return true;
+    }
+  }
+  if (p_operand.size() >= 2 && p_operand[0] == 'f') {
+    char *end = nullptr;
+    const auto idx = std::strtoul(p_operand.c_str() + 1, &end, 10);
+    if (*end == '\0' && idx < 32) {
+      p_reg = static_cast<uint32_t>(idx);
+      return true;
+    }
+  }
+  return fail("invalid floating-point register \"" + p_operand + "\"");
+}
+
+bool Assembler::parseImmediate(const std::string &p_operand, int64_t &p_imm) {
+  if (p_operand.empty()) {
+    return fail("missing immediate");
+  }
+  char *end = nullptr;
+  errno = 0;
+  p_imm = std::strtoll(p_operand.c_str(), &end, 0);
+  if (*end != '\0' || errno != 0) {
+    return fail("invalid immediate \"" + p_operand + "\"");
+  }
+  return true;
+}
+
+bool Assembler::parseMemory(const std::string &p_operand, int64_t &p_offset,
+                            uint32_t &p_base) {
+  const auto open = p_operand.find('(');
+  const auto close = p_operand.rfind(')');
+  if (open == std::string::npos || close != p_operand.size() - 1) {
+    return fail("invalid memory operand \"" + p_operand + "\"");
+  }
+  const auto offset = p_operand.substr(0, open);
+  p_offset = 0;
+  if (!offset.empty() && !parseImmediate(offset, p_offset)) {
+    return false;
+  }
+  if (!fitsSigned(p_offset, 12)) {
+    return fail("offset out of range \"" + p_operand + "\"");
+  }
+  return parseRegister(p_operand.substr(open + 1, close - open - 1), p_base);
+}
+
+bool Assembler::getLocalOffset(const std::string &p_label, int64_t &p_offset) {
+  const auto it = m_symbols.find(p_label);
+  // global symbols may be preempted at link time, so they keep relocations
+  if (it == m_symbols.end() || it->second.section != m_section ||
+      it->second.is_global) {
+    return false;
+  }
+  p_offset = static_cast<int64_t>(it->second.value) - currentOffset();
+  return true;
+}
+
+bool Assembler::switchSection(const std::string &p_name) {
+  auto &sections = m_object.getSections();
+  for (size_t i = 0; i < sections.size(); ++i) {
+    if (sections[i].name == p_name) {
+      m_section = static_cast<int>(i);
+      return true;
+    }
+  }
+  auto kind = ObjectFile::Section::Kind::kNote;
+  if (p_name == ".text") {
+    kind = ObjectFile::Section::Kind::kText;
+  } else if (p_name == ".data") {
+    kind = ObjectFile::Section::Kind::kData;
+  } else if (p_name.compare(0, 7, ".rodata") == 0) {
+    kind = ObjectFile::Section::Kind::kRodata;
+  } else if (p_name == ".bss") {
+    kind = ObjectFile::Section::Kind::kBss;
+  }
+  sections.push_back(ObjectFile::Section{p_name, kind});
+  if (kind == ObjectFile::Section::Kind::kText) {
+    sections.back().align = 4;
+  }
+  m_section = static_cast<int>(sections.size() - 1);
+  return true;
+}
+
+bool Assembler::defineLabel(const std::string &p_name) {
+  auto &symbol = getSymbol(p_name);
+  if (!m_final_pass && symbol.section != ObjectFile::kUndefinedSection) {
+    return fail("symbol \"" + p_name + "\" is already defined");
+  }
+  symbol.section = m_section;
+  symbol.value = currentOffset();
+  return true;
+}
+
+static bool parseStringLiteral(const std::string &p_literal,
+                               std::string &p_str) {
+  if (p_literal.size() < 2 || p_literal.front() != '"' ||
+      p_literal.back() != '"') {
+    return false;
+  }
+  p_str.clear();
+  for (size_t i = 1; i + 1 < p_literal.size(); ++i) {
+    if (p_literal[i] != '\\') {
+      p_str += p_literal[i];
+      continue;
+    }
+    if (++i + 1 >= p_literal.size()) {
+      return false;
+    }
+    switch (p_literal[i]) {
+      case 'n':
+        p_str += '\n';
+        break;
+      case 't':
+        p_str += '\t';
+        break;
+      case '0':
+        p_str += '\0';
+        break;
+      default:
+        p_str += p_literal[i];
+    }
+  }
+  return true;
+}
+
+bool Assembler::handleDirective(const AsmStatement &p_statement) {
+  const auto &name = p_statement.name;
+  const auto &operands = p_statement.operands;
+
+  if (name == ".text" || name == ".data" || name == ".bss" ||
+      name == ".rodata") {
+    return switchSection(name);
+  }
+  if (name == ".section") {
+    if (operands.empty()) {
+      return fail(".section needs a name");
+    }
+    return switchSection(operands[0]);
+  }
+  if (name == ".file") {
+    std::string file_name;
+    if (!operands.empty() && parseStringLiteral(operands[0], file_name)) {
+      m_object.setFileName(file_name);
+    }
+    return true;
+  }
+  if (name == ".option" || name == ".ident") {
+    return true;
+  }
+  if (name == ".globl" || name == ".global") {
+    for (const auto &operand : operands) {
+      getSymbol(operand).is_global = true;
+    }
+    return true;
+  }
+  if (name == ".type") {
+    if (operands.size() != 2) {
+      return fail(".type needs a symbol and a type");
+    }
+    const auto &type = operands[1];
+    auto &symbol = getSymbol(operands[0]);
+    if (type == "@function" || type == "%function") {
+      symbol.type = ObjectFile::Symbol::Type::kFunction;
+    } else if (type == "@object" || type == "%object") {
+      symbol.type = ObjectFile::Symbol::Type::kObject;
+    }
+    return true;
+  }
+  if (name == ".size") {
+    if (operands.size() != 2) {
+      return fail(".size needs a symbol and a size");
+    }
+    auto &symbol = getSymbol(operands[0]);
+    if (operands[1] == ".-" + operands[0]) {
+      symbol.size = currentOffset() - symbol.value;
+      return true;
+    }
+    int64_t size = 0;
+    if (!parseImmediate(operands[1], size)) {
+      return false;
+    }
+    symbol.size = static_cast<uint32_t>(size);
+    return true;
+  }
+  if (name == ".align" || name == ".p2align" || name == ".balign") {
+    int64_t value = 0;
+    if (operands.empty() || !parseImmediate(operands[0], value) ||
+        value < 0 || value > 12) {
+      return m_error.empty() ? fail("invalid alignment") : false;
+    }
+    const uint32_t align = (name == ".balign") ? static_cast<uint32_t>(value)
+                                               : (1u << value);
+    auto &section = currentSection();
+    section.align = std::max(section.align, align);
+    const bool is_code = section.kind == ObjectFile::Section::Kind::kText;
+    while (currentOffset() % align != 0) {
+      if (is_code && currentOffset() % 4 == 0) {
+        emitWord(encodeI(0, kZero, 0, kZero, kOpcodeOpImm));  // nop
+      } else {
+        emitBytes(0, 1);
+      }
+    }
+    return true;
+  }
+  if (name == ".comm") {
+    if (operands.size() < 2) {
+      return fail(".comm needs a symbol and a size");
+    }
+    int64_t size = 0;
+    int64_t align = 4;
+    if (!parseImmediate(operands[1], size) ||
+        (operands.size() > 2 && !parseImmediate(operands[2], align))) {
+      return false;
+    }
+    // common symbols are allocated in .bss right away
+    const auto saved_section = m_section;
+    switchSection(".bss");
+    auto &bss = currentSection();
+    bss.align = std::max(bss.align, static_cast<uint32_t>(align));
+    while (bss.nobits_size % align != 0) {
+      ++bss.nobits_size;
+    }
+    if (!defineLabel(operands[0])) {
+      return false;
+    }
+    auto &symbol = getSymbol(operands[0]);
+    symbol.is_global = true;
+    symbol.type = ObjectFile::Symbol::Type::kObject;
+    symbol.size = static_cast<uint32_t>(size);
+    bss.nobits_size += size;
+    m_section = saved_section;
+    return true;
+  }
+  if (name == ".zero" || name == ".space") {
+    int64_t size = 0;
+    if (operands.empty() || !parseImmediate(operands[0], size)) {
+      return m_error.empty() ? fail("invalid size") : false;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      emitBytes(0, 1);
+    }
+    return true;
+  }
+  if (name == ".word" || name == ".4byte" || name == ".half" ||
+      name == ".2byte" || name == ".byte") {
+    const size_t size = (name == ".byte")                      ? 1
+                        : (name == ".half" || name == ".2byte") ? 2
+                                                                : 4;
+    for (const auto &operand : operands) {
+      int64_t value = 0;
+      const char first = operand.empty() ? '\0' : operand[0];
+      if (size == 4 && !std::isdigit(static_cast<unsigned char>(first)) &&
+          first != '-') {
+        addRelocation(RiscvRelocation::k32, operand);
+      } else if (!parseImmediate(operand, value)) {
+        return false;
+      }
+      emitBytes(static_cast<uint64_t>(value), size);
+    }
+    return true;
+  }
+  if (name == ".string" || name == ".asciz" || name == ".ascii") {
+    for (const auto &operand : operands) {
+      std::string str;
+      if (!parseStringLiteral(operand, str)) {
+        return fail("invalid string literal " + operand);
+      }
+      for (const char c : str) {
+        emitBytes(static_cast<uint8_t>(c), 1);
+      }
+      if (name != ".ascii") {
+        emitBytes(0, 1);
+      }
+    }
+    return true;
+  }
+  return fail("unsupported directive " + name);
+}
+
+bool Assembler::handleInstruction(const AsmStatement &p_statement) {
+  if (currentSection().kind != ObjectFile::Section::Kind::kText) {
+    return fail("instruction outside of .text");
+  }
+  const auto &mnemonic = p_statement.name;
+  const auto &ops = p_statement.operands;
+  auto expect = [&](const size_t p_count) {
+    return (ops.size() == p_count)
+               ? true
+               : fail(mnemonic + " takes " + std::to_string(p_count) +
+                      " operands");
+  };
+  uint32_t rd = 0, rs1 = 0, rs2 = 0;
+  int64_t imm = 0;
+
+  // pc-relative branch/jump to a label, left to the linker if it is not in
+  // this section
+  auto branch_offset = [&](const std::string &p_label,
+                           const RiscvRelocation p_type, const unsigned p_bits,
+                           int64_t &p_offset) {
+    p_offset = 0;
+    if (getLocalOffset(p_label, p_offset)) {
+      if (m_final_pass && !fitsSigned(p_offset, p_bits)) {
+        return fail("branch to " + p_label + " out of range");
+      }
+      return true;
+    }
+    addRelocation(p_type, p_label);
+    return true;
+  };
+  auto emit_branch = [&](const uint32_t p_funct3, const uint32_t p_rs1,
+                         const uint32_t p_rs2, const std::string &p_label) {
+    int64_t offset = 0;
+    if (!branch_offset(p_label, RiscvRelocation::kBranch, 13, offset)) {
+      return false;
+    }
+    emitWord(encodeB(offset, p_rs2, p_rs1, p_funct3));
+    return true;
+  };
+  auto emit_jal = [&](const uint32_t p_rd, const std::string &p_label) {
+    int64_t offset = 0;
+    if (!branch_offset(p_label, RiscvRelocation::kJal, 21, offset)) {
+      return false;
+    }
+    emitWord(encodeJ(offset, p_rd));
+    return true;
+  };
+
+  if (const auto *info = findInfo(kRTypeInstructions, mnemonic)) {
+    if (!expect(3) || !parseRegister(ops[0], rd) ||
+        !parseRegister(ops[1], rs1) || !parseRegister(ops[2], rs2)) {
+      return false;
+    }
+    emitWord(encodeR(info->funct7, rs2, rs1, info->funct3, rd, kOpcodeOp));
+    return true;
+  }
+  if (const auto *info = findInfo(kImmInstructions, mnemonic)) {
+    if (!expect(3) || !parseRegister(ops[0], rd) ||
+        !parseRegister(ops[1], rs1) || !parseImmediate(ops[2], imm)) {
+      return false;
+    }
+    if (!fitsSigned(imm, 12)) {
+      return fail("immediate out of range " + ops[2]);
+    }
+    emitWord(encodeI(imm, rs1, info->funct3, rd, kOpcodeOpImm));
+    return true;
+  }
+  if (const auto *info = findInfo(kShiftImmInstructions, mnemonic)) {
+    if (!expect(3) || !parseRegister(ops[0], rd) ||
+        !parseRegister(ops[1], rs1) || !parseImmediate(ops[2], imm)) {
+      return false;
+    }
+    if (imm < 0 || imm > 31) {
+      return fail("shift amount out of range " + ops[2]);
+    }
+    emitWord(encodeI((info->funct7 << 5) | imm, rs1, info->funct3, rd,
+                     kOpcodeOpImm));
+    return true;
+  }
+  if (const auto *info = findInfo(kLoadInstructions, mnemonic)) {
+    if (!expect(2) || !parseRegister(ops[0], rd) ||
+        !parseMemory(ops[1], imm, rs1)) {
+      return false;
+    }
+    emitWord(encodeI(imm, rs1, info->funct3, rd, kOpcodeLoad));
+    return true;
+  }
+  if (const auto *info = findInfo(kStoreInstructions, mnemonic)) {
+    if (!expect(2) || !parseRegister(ops[0], rs2) ||
+        !parseMemory(ops[1], imm, rs1)) {
+      return false;
+    }
+    emitWord(encodeS(imm, rs2, rs1, info->funct3, kOpcodeStore));
+    return true;
+  }
+  if (const auto *info = findInfo(kFloatLoadInstructions, mnemonic)) {
+    if (!expect(2) || !parseFloatRegister(ops[0], rd) ||
+        !parseMemory(ops[1], imm, rs1)) {
+      return false;
+    }
+    emitWord(encodeI(imm, rs1, info->funct3, rd, kOpcodeLoadFp));
+    return true;
+  }
+  if (const auto *info = findInfo(kFloatStoreInstructions, mnemonic)) {
+    if (!expect(2) || !parseFloatRegister(ops[0], rs2) ||
+        !parseMemory(ops[1], imm, rs1)) {
+      return false;
+    }
+    emitWord(encodeS(imm, rs2, rs1, info->funct3, kOpcodeStoreFp));
+    return true;
+  }
+  if (const auto *info = findInfo(kFloatRTypeInstructions, mnemonic)) {
+    if (!expect(3) || !parseFloatRegister(ops[0], rd) ||
+        !parseFloatRegister(ops[1], rs1) || !parseFloatRegister(ops[2], rs2)) {
+      return false;
+    }
+    emitWord(encodeR(info->funct7, rs2, rs1, info->funct3, rd, kOpcodeOpFp));
+    return true;
+  }
+  if (const auto *info = findInfo(kFloatCompareInstructions, mnemonic)) {
+    if (!expect(3) || !parseRegister(ops[0], rd) ||
+        !parseFloatRegister(ops[1], rs1) || !parseFloatRegister(ops[2], rs2)) {
+      return false;
+    }
+    emitWord(encodeR(info->funct7, rs2, rs1, info->funct3, rd, kOpcodeOpFp));
+    return true;
+  }
+  if (const auto *info = findInfo(kFloatMoveInstructions, mnemonic)) {
+    if (!expect(2) || !parseFloatRegister(ops[0], rd) ||
+        !parseFloatRegister(ops[1], rs1)) {
+      return false;
+    }
+    emitWord(encodeR(info->funct7, rs1, rs1, info->funct3, rd, kOpcodeOpFp));
+    return true;
+  }
+  if (const auto *info = findInfo(kFloatConvertInstructions, mnemonic)) {
+    // the rounding mode is optional, and meaningless for fmv.x.w/fmv.w.x
+    const bool is_move = info->funct7 >= 0x70;
+    if ((is_move || ops.size() != 3) && !expect(2)) {
+      return false;
+    }
+    if (!(info->rd_is_float ? parseFloatRegister(ops[0], rd)
+                            : parseRegister(ops[0], rd)) ||
+        !(info->rs1_is_float ? parseFloatRegister(ops[1], rs1)
+                             : parseRegister(ops[1], rs1))) {
+      return false;
+    }
+    uint32_t rounding_mode = is_move ? 0 : kRoundDynamic;
+    if (ops.size() == 3) {
+      const auto *mode = findInfo(kRoundingModes, ops[2]);
+      if (!mode) {
+        return fail("invalid rounding mode " + ops[2]);
+      }
+      rounding_mode = mode->funct3;
+    }
+    emitWord(encodeR(info->funct7, info->rs2, rs1, rounding_mode, rd,
+                     kOpcodeOpFp));
+    return true;
+  }
+  if (const auto *info = findInfo(kBranchInstructions, mnemonic)) {
+    if (!expect(3) || !parseRegister(ops[0], rs1) ||
+        !parseRegister(ops[1], rs2)) {
+      return false;
+    }
+    return emit_branch(info->funct3, rs1, rs2, ops[2]);
+  }
+  if (const auto *info = findInfo(kSwappedBranchInstructions, mnemonic)) {
+    if (!expect(3) || !parseRegister(ops[0], rs2) ||
+        !parseRegister(ops[1], rs1)) {
+      return false;
+    }
+    return emit_branch(info->funct3, rs1, rs2, ops[2]);
+  }
+  if (const auto *info = findInfo(kZeroBranchInstructions, mnemonic)) {
+    if (!expect(2) || !parseRegister(ops[0], rs1)) {
+      return false;
+    }
+    return info->reg_is_rs2 ? emit_branch(info->funct3, kZero, rs1, ops[1])
+                            : emit_branch(info->funct3, rs1, kZero, ops[1]);
+  }
+
+  if (mnemonic == "lui" || mnemonic == "auipc") {
+    if (!expect(2) || !parseRegister(ops[0], rd) ||
+        !parseImmediate(ops[1], imm)) {
+      return false;
+    }
+    if (imm < 0 || imm > 0xfffff) {
+      return fail("immediate out of range " + ops[1]);
+    }
+    emitWord(encodeU(static_cast<uint32_t>(imm), rd,
+                     (mnemonic == "lui") ? kOpcodeLui : kOpcodeAuipc));
+    return true;
+  }
+  if (mnemonic == "li") {
+    if (!expect(2) || !parseRegister(ops[0], rd) ||
+        !parseImmediate(ops[1], imm)) {
+      return false;
+    }
+    if (imm < INT32_MIN || imm > UINT32_MAX) {
+      return fail("immediate out of range " + ops[1]);
+    }
+    const auto value = static_cast<int32_t>(static_cast<uint32_t>(imm));
+    if (fitsSigned(value, 12)) {
+      emitWord(encodeI(value, kZero, 0, rd, kOpcodeOpImm));
+      return true;
+    }
+    // lui takes the upper 20 bits, rounded so that the sign-extended lower
+    // 12 bits of addi make up the difference
+    const auto upper = (static_cast<uint32_t>(value) + 0x800) >> 12;
+    const auto lower =
+        static_cast<int32_t>(static_cast<uint32_t>(value) - (upper << 12));
+    emitWord(encodeU(upper, rd, kOpcodeLui));
+    if (lower != 0) {
+      emitWord(encodeI(lower, rd, 0, rd, kOpcodeOpImm));
+    }
+    return true;
+  }
+  if (mnemonic == "la" || mnemonic == "lla") {
+    if (!expect(2) || !parseRegister(ops[0], rd)) {
+      return false;
+    }
+    // auipc + addi, the addi relocation refers back to the auipc
+    const auto label = ".Lpcrel_hi" + std::to_string(m_num_pcrel_labels++);
+    if (!defineLabel(label)) {
+      return false;
+    }
+    addRelocation(RiscvRelocation::kPcrelHi20, ops[1]);
+    emitWord(encodeU(0, rd, kOpcodeAuipc));
+    addRelocation(RiscvRelocation::kPcrelLo12I, label);
+    emitWord(encodeI(0, rd, 0, rd, kOpcodeOpImm));
+    return true;
+  }
+  if (mnemonic == "call" || mnemonic == "tail") {
+    if (!expect(1)) {
+      return false;
+    }
+    const uint32_t link = (mnemonic == "call") ? kRa : kZero;
+    const uint32_t scratch = (mnemonic == "call") ? kRa : kT1;
+    addRelocation(RiscvRelocation::kCallPlt, ops[0]);
+    emitWord(encodeU(0, scratch, kOpcodeAuipc));
+    emitWord(encodeI(0, scratch, 0, link, kOpcodeJalr));
+    return true;
+  }
+  if (mnemonic == "jal") {
+    if (ops.size() == 1) {
+      return emit_jal(kRa, ops[0]);
+    }
+    if (!expect(2) || !parseRegister(ops[0], rd)) {
+      return false;
+    }
+    return emit_jal(rd, ops[1]);
+  }
+  if (mnemonic == "j") {
+    return expect(1) && emit_jal(kZero, ops[0]);
+  }
+  if (mnemonic == "jalr") {
+    if (ops.size() == 1) {
+      if (!parseRegister(ops[0], rs1)) {
+        return false;
+      }
+      emitWord(encodeI(0, rs1, 0, kRa, kOpcodeJalr));
+      return true;
+    }
+    if (!parseRegister(ops[0], rd)) {
+      return false;
+    }
+    if (ops.size() == 2) {
+      if (!parseMemory(ops[1], imm, rs1)) {
+        return false;
+      }
+    } else if (!expect(3) || !parseRegister(ops[1], rs1) ||
+               !parseImmediate(ops[2], imm)) {
+      return false;
+    }
+    emitWord(encodeI(imm, rs1, 0, rd, kOpcodeJalr));
+    return true;
+  }
+  if (mnemonic == "jr") {
+    if (!expect(1) || !parseRegister(ops[0], rs1)) {
+      return false;
+    }
+    emitWord(encodeI(0, rs1, 0, kZero, kOpcodeJalr));
+    return true;
+  }
+  if (mnemonic == "ret") {
+    emitWord(encodeI(0, kRa, 0, kZero, kOpcodeJalr));
+    return true;
+  }
+  if (mnemonic == "nop") {
+    emitWord(encodeI(0, kZero, 0, kZero, kOpcodeOpImm));
+    return true;
+  }
+
+  // two-register pseudo-instructions
+  if (!expect(2) || !parseRegister(ops[0], rd) || !parseRegister(ops[1], rs1)) {
+    return m_error.empty() ? fail("unknown instruction " + mnemonic) : false;
+  }
+  if (mnemonic == "mv") {
+    emitWord(encodeI(0, rs1, 0, rd, kOpcodeOpImm));
+  } else if (mnemonic == "not") {
+    emitWord(encodeI(-1, rs1, 4, rd, kOpcodeOpImm));
+  } else if (mnemonic == "neg") {
+    emitWord(encodeR(0x20, rs1, kZero, 0, rd, kOpcodeOp));
+  } else if (mnemonic == "seqz") {
+    emitWord(encodeI(1, rs1, 3, rd, kOpcodeOpImm));
+  } else if (mnemonic == "snez") {
+    emitWord(encodeR(0, rs1, kZero, 3, rd, kOpcodeOp));
+  } else if (mnemonic == "sltz") {
+    emitWord(encodeR(0, kZero, rs1, 2, rd, kOpcodeOp));
+  } else if (mnemonic == "sgtz") {
+    emitWord(encodeR(0, rs1, kZero, 2, rd, kOpcodeOp));
+  } else {
+    return fail("unknown instruction " + mnemonic);
+  }
+  return true;
+}
+
+bool Assembler::runPass(const AsmProgram &p_program) {
+  for (auto &section : m_object.getSections()) {
+    section.data.clear();
+    section.nobits_size = 0;
+  }
+  m_num_pcrel_labels = 0;
+  switchSection(".text");
+  for (const auto &statement : p_program.getStatements()) {
+    m_line = statement.line;
+    bool ok = true;
+    switch (statement.kind) {
+      case AsmStatement::Kind::kLabel:
+        ok = defineLabel(statement.name);
+        break;
+      case AsmStatement::Kind::kDirective:
+        ok = handleDirective(statement);
+        break;
+      case AsmStatement::Kind::kInstruction:
+        ok = handleInstruction(statement);
+        break;
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Assembler::finish() {
+  auto &symbols = m_object.getSymbols();
+  std::map<std::string, size_t> indices;
+  for (const auto &name : m_symbol_order) {
+    const auto &info = m_symbols[name];
+    const bool is_local_label = name.compare(0, 2, ".L") == 0;
+    if (is_local_label && !info.is_referenced) {
+      continue;
+    }
+    ObjectFile::Symbol symbol;
+    symbol.name = name;
+    symbol.section = info.section;
+    symbol.value = info.value;
+    symbol.size = info.size;
+    symbol.type = info.type;
+    // references to symbols defined elsewhere are global
+    symbol.is_global =
+        info.is_global || info.section == ObjectFile::kUndefinedSection;
+    indices[name] = symbols.size();
+    symbols.push_back(symbol);
+  }
+  for (const auto &relocation : m_relocations) {
+    m_object.getSections()[relocation.section].relocations.push_back(
+        ObjectFile::Relocation{relocation.offset, relocation.type,
+                               indices[relocation.symbol], relocation.addend});
+  }
+}
+
+bool Assembler::assemble(const AsmProgram &p_program) {
+  m_final_pass = false;
+  if (!runPass(p_program)) {
+    return false;
+  }
+  m_final_pass = true;
+  if (!runPass(p_program)) {
+    return false;
+  }
+  for (const auto &relocation : m_relocations) {
+    const auto &name = relocation.symbol;
+    if (name.compare(0, 2, ".L") == 0 &&
+        m_symbols[name].section == ObjectFile::kUndefinedSection) {
+      m_line = 0;
+      return fail("undefined local label " + name);
+    }
+  }
+  finish();
+  return true;
+}
+
+bool assembleFile(const std::string &p_asm_path, const std::string &p_obj_path,
+                  std::string &p_error) {
+  AsmProgram program;
+  if (!program.parseFile(p_asm_path, p_error)) {
+    p_error = p_asm_path + ": " + p_error;
+    return false;
+  }
+  ObjectFile object;
+  Assembler assembler(object);
+  if (!assembler.assemble(program)) {
+    p_error = p_asm_path + ": " + assembler.getError();
+    return false;
+  }
+  return object.write(p_obj_path, p_error);
+}
@@ -0,0 +1,483 @@
+#include "asm/BlockLayout.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "codegen/OutputPath.hpp"
+
+using Statements = AsmProgram::Statements;
+
+// each conditional branch with the one testing the opposite condition
+static const char *const kInvertedBranches[][2] = {
+    {"beq", "bne"},   {"blt", "bge"},   {"bltu", "bgeu"}, {"bgt", "ble"},
+    {"bgtu", "bleu"}, {"beqz", "bnez"}, {"blez", "bgtz"}, {"bgez", "bltz"}};
+
+static const char *getInvertedBranch(const std::string &p_mnemonic) {
+  for (const auto &pair : kInvertedBranches) {
+    if (p_mnemonic == pair[0]) {
+      return pair[1];
+    }
+    if (p_mnemonic == pair[1]) {
+      return pair[0];
+    }
+  }
+  return nullptr;
+}
+
+static bool isBranch(const AsmStatement &p_statement) {
+  return p_statement.kind == AsmStatement::Kind::kInstruction &&
+         !p_statement.operands.empty() &&
+         getInvertedBranch(p_statement.name) != nullptr;
+}
+
+static bool isJump(const AsmStatement &p_statement) {
+  return p_statement.kind == AsmStatement::Kind::kInstruction &&
+         p_statement.name == "j" && p_statement.operands.size() == 1;
+}
+
+// control never goes on with the next statement
+static bool isUnconditional(const AsmStatement &p_statement) {
+  if (p_statement.kind != AsmStatement::Kind::kInstruction) {
+    return false;
+  }
+  const auto &name = p_statement.name;
+  if (name == "j" || name == "jr" || name == "ret" || name == "tail") {
+    return true;
+  }
+  return (name == "jal" || name == "jalr") &&
+         p_statement.operands.size() > 1 && p_statement.operands[0] == "zero";
+}
+
+static AsmStatement invertBranch(const AsmStatement &p_branch,
+                                 const std::string &p_target) {
+  auto inverted = p_branch;
+  inverted.name = getInvertedBranch(p_branch.name);
+  inverted.operands.back() = p_target;
+  return inverted;
+}
+
+static bool isSymbolChar(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' ||
+         c == '$';
+}
+
+static void collectSymbols(const std::string &p_operand,
+                           std::set<std::string> &p_symbols) {
+  size_t begin = 0;
+  while (begin < p_operand.size()) {
+    size_t end = begin;
+    while (end < p_operand.size() && isSymbolChar(p_operand[end])) {
+      ++end;
+    }
+    if (end > begin) {
+      p_symbols.insert(p_operand.substr(begin, end - begin));
+    }
+    begin = end + 1;
+  }
+}
+
+// [begin, end) of each run of labels and instructions, i.e., of code
+// between directives
+static std::vector<std::pair<size_t, size_t>> findCodeRuns(
+    const Statements &p_statements) {
+  std::vector<std::pair<size_t, size_t>> runs;
+  size_t begin = 0;
+  for (size_t i = 0; i <= p_statements.size(); ++i) {
+    if (i < p_statements.size() &&
+        p_statements[i].kind != AsmStatement::Kind::kDirective) {
+      continue;
+    }
+    if (i > begin) {
+      runs.emplace_back(begin, i);
+    }
+    begin = i + 1;
+  }
+  return runs;
+}
+
+struct AsmBlock {
+  // the labels and the straight-line code
+  Statements statements;
+  bool has_code = false;
+  // the conditional branch ending the block, and the block it goes to (-1
+  // if it leaves the run)
+  bool has_branch = false;
+  AsmStatement branch{AsmStatement::Kind::kInstruction, "", {}, 0};
+  int taken = -1;
+  // the jump or return ending the block, none if it falls through
+  bool has_exit = false;
+  AsmStatement exit{AsmStatement::Kind::kInstruction, "", {}, 0};
+  // the block control goes on with otherwise, -1 if it leaves the run
+  int next = -1;
+};
+
+static std::vector<AsmBlock> splitBlocks(const Statements &p_statements,
+                                      const size_t p_begin,
+                                      const size_t p_end) {
+  std::vector<AsmBlock> blocks(1);
+  for (size_t i = p_begin; i < p_end; ++i) {
+    const auto &statement = p_statements[i];
+    const bool is_label = statement.kind == AsmStatement::Kind::kLabel;
+    const auto &last = blocks.back();
+    // a branch may be followed by the jump taken otherwise
+    const bool starts_block =
+        is_label ? (last.has_code || last.has_branch || last.has_exit)
+                 : (last.has_exit || (last.has_branch && !isJump(statement)));
+    if (starts_block) {
+      blocks.emplace_back();
+    }
+    auto &block = blocks.back();
+    if (is_label) {
+      block.statements.push_back(statement);
+    } else if (block.has_branch || isUnconditional(statement)) {
+      block.has_exit = true;
+      block.exit = statement;
+    } else if (isBranch(statement)) {
+      block.has_branch = true;
+      block.branch = statement;
+    } else {
+      block.has_code = true;
+      block.statements.push_back(statement);
+    }
+  }
+
+  std::map<std::string, int> block_of_label;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    for (const auto &statement : blocks[i].statements) {
+      if (statement.kind == AsmStatement::Kind::kLabel) {
+        block_of_label[statement.name] = static_cast<int>(i);
+      }
+    }
+  }
+  auto find_block = [&](const std::string &p_label) {
+    const auto it = block_of_label.find(p_label);
+    return (it == block_of_label.end()) ? -1 : it->second;
+  };
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    auto &block = blocks[i];
+    if (block.has_branch) {
+      block.taken = find_block(block.branch.operands.back());
+    }
+    if (!block.has_exit) {
+      block.next = (i + 1 < blocks.size()) ? static_cast<int>(i + 1) : -1;
+    } else if (isJump(block.exit)) {
+      block.next = find_block(block.exit.operands[0]);
+    }
+  }
+  return blocks;
+}
+
+// The block control ends up in when going to p_block, past the blocks that
+// only jump on, with the label to reach it by in p_label.
+static int skipJumps(const std::vector<AsmBlock> &p_blocks, int p_block,
+                     std::string &p_label) {
+  for (size_t steps = 0; steps < p_blocks.size(); ++steps) {
+    const auto &block = p_blocks[p_block];
+    if (block.has_code || block.has_branch || !block.has_exit ||
+        !isJump(block.exit) || block.next < 0) {
+      break;
+    }
+    p_block = block.next;
+    p_label = block.exit.operands[0];
+  }
+  return p_block;
+}
+
+static bool isSameStatement(const AsmStatement &p_lhs,
+                            const AsmStatement &p_rhs) {
+  return p_lhs.kind == p_rhs.kind && p_lhs.name == p_rhs.name &&
+         p_lhs.operands == p_rhs.operands;
+}
+
+// Lays out the run [p_begin, p_end) into p_layout. p_pinned_labels are
+// referenced other than by the branches and jumps of the run, so their
+// blocks are kept even if nothing in the run reaches them.
+static void layoutRun(const Statements &p_statements, const size_t p_begin,
+                      const size_t p_end,
+                      const std::set<std::string> &p_pinned_labels,
+                      Statements &p_layout) {
+  auto blocks = splitBlocks(p_statements, p_begin, p_end);
+  const int num_blocks = static_cast<int>(blocks.size());
+  // the code would run off the end of the run into whatever follows
+  if (!blocks.back().has_exit) {
+    p_layout.assign(p_statements.begin() + p_begin,
+                    p_statements.begin() + p_end);
+    return;
+  }
+
+  for (auto &block : blocks) {
+    if (block.has_branch && block.taken >= 0) {
+      block.taken =
+          skipJumps(blocks, block.taken, block.branch.operands.back());
+    }
+    if (block.has_exit && block.next >= 0) {
+      block.next = skipJumps(blocks, block.next, block.exit.operands[0]);
+    }
+  }
+
+  // the first block is where the run is entered
+  std::vector<bool> is_reachable(num_blocks, false);
+  std::vector<int> worklist{0};
+  for (int i = 0; i < num_blocks; ++i) {
+    for (const auto &statement : blocks[i].statements) {
+      if (statement.kind == AsmStatement::Kind::kLabel &&
+          p_pinned_labels.count(statement.name)) {
+        worklist.push_back(i);
+      }
+    }
+  }
+  while (!worklist.empty()) {
+    const int i = worklist.back();
+    worklist.pop_back();
+    if (i < 0 || is_reachable[i]) {
+      continue;
+    }
+    is_reachable[i] = true;
+    worklist.push_back(blocks[i].taken);
+    worklist.push_back(blocks[i].next);
+  }
+
+  // Blocks that have to follow each other form chains. Falling through is
+  // fixed; a jump, or a branch followed by one, then links its block to
+  // the target if that is not already preceded by something.
+  std::vector<int> chain_next(num_blocks, -1);
+  std::vector<int> chain_prev(num_blocks, -1);
+  for (int i = 0; i < num_blocks; ++i) {
+    if (is_reachable[i] && !blocks[i].has_exit) {
+      chain_next[i] = blocks[i].next;
+      chain_prev[blocks[i].next] = i;
+    }
+  }
+  auto try_link = [&](const int p_from, const int p_to) {
+    if (p_to <= 0 || chain_prev[p_to] >= 0 || chain_next[p_from] >= 0) {
+      return false;
+    }
+    for (int i = p_to; i >= 0; i = chain_next[i]) {
+      if (i == p_from) {
+        return false;
+      }
+    }
+    chain_next[p_from] = p_to;
+    chain_prev[p_to] = p_from;
+    return true;
+  };
+  for (int i = 0; i < num_blocks; ++i) {
+    const auto &block = blocks[i];
+    if (is_reachable[i] && block.has_exit && isJump(block.exit) &&
+        block.next >= 0 && !try_link(i, block.next) && block.has_branch) {
+      try_link(i, block.taken);
+    }
+  }
+
+  std::vector<int> order;
+  for (int head = 0; head < num_blocks; ++head) {
+    if (!is_reachable[head] || chain_prev[head] >= 0) {
+      continue;
+    }
+    for (int i = head; i >= 0; i = chain_next[i]) {
+      order.push_back(i);
+    }
+  }
+
+  for (size_t k = 0; k < order.size(); ++k) {
+    const auto &block = blocks[order[k]];
+    const int following = (k + 1 < order.size()) ? order[k + 1] : -1;
+    p_layout.insert(p_layout.end(), block.statements.begin(),
+                    block.statements.end());
+    const bool goes_on =
+        !block.has_exit || (block.next >= 0 && block.next == following);
+    if (block.has_branch) {
+      if (!goes_on && block.taken >= 0 && block.taken == following &&
+          isJump(block.exit)) {
+        p_layout.push_back(invertBranch(block.branch,
+                                        block.exit.operands[0]));
+        continue;
+      }
+      // not if both ways lead to the next block
+      if (!goes_on || block.taken < 0 || block.taken != following) {
+        p_layout.push_back(block.branch);
+      }
+    }
+    if (!goes_on) {
+      p_layout.push_back(block.exit);
+    }
+  }
+}
+
+bool layoutBlocks(AsmProgram &p_program) {
+  auto &statements = p_program.getStatements();
+  const auto runs = findCodeRuns(statements);
+
+  // Labels branched or jumped to from another run, or referenced by
+  // anything else, can be entered from outside of their own run.
+  std::map<std::string, size_t> run_of_label;
+  for (size_t r = 0; r < runs.size(); ++r) {
+    for (size_t i = runs[r].first; i < runs[r].second; ++i) {
+      if (statements[i].kind == AsmStatement::Kind::kLabel) {
+        run_of_label[statements[i].name] = r;
+      }
+    }
+  }
+  std::set<std::string> pinned_labels;
+  size_t run = 0;
+  for (size_t i = 0; i < statements.size(); ++i) {
+    while (run < runs.size() && runs[run].second <= i) {
+      ++run;
+    }
+    const auto &statement = statements[i];
+    const bool is_in_run = run < runs.size() && runs[run].first <= i;
+    const bool has_target = isBranch(statement) || isJump(statement);
+    for (size_t j = 0; j < statement.operands.size(); ++j) {
+      if (has_target && j + 1 == statement.operands.size()) {
+        const auto it = run_of_label.find(statement.operands[j]);
+        if (it != run_of_label.end() && (!is_in_run || it->second != run)) {
+          pinned_labels.insert(statement.operands[j]);
+        }
+      } else {
+        collectSymbols(statement.operands[j], pinned_labels);
+      }
+    }
+  }
+
+  Statements result;
+  bool changed = false;
+  size_t copied = 0;
+  for (const auto &code_run : runs) {
+    result.insert(result.end(), statements.begin() + copied,
+                  statements.begin() + code_run.first);
+    Statements layout;
+    layoutRun(statements, code_run.first, code_run.second, pinned_labels,
+              layout);
+    changed |= layout.size() != code_run.second - code_run.first;
+    for (size_t i = 0; !changed && i < layout.size(); ++i) {
+      changed = !isSameStatement(layout[i], statements[code_run.first + i]);
+    }
+    result.insert(result.end(), layout.begin(), layout.end());
+    copied = code_run.second;
+  }
+  result.insert(result.end(), statements.begin() + copied, statements.end());
+  if (changed) {
+    statements = std::move(result);
+  }
+  return changed;
+}
+
+static bool parseImmediate(const std::string &p_operand, int64_t &p_imm) {
+  if (p_operand.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  p_imm = std::strtoll(p_operand.c_str(), &end, 0);
+  return *end == '\0';
+}
+
+// bytes the assembler emits for the statement, pseudo-instructions included;
+// may overestimate
+static int64_t getSize(const AsmStatement &p_statement) {
+  if (p_statement.kind != AsmStatement::Kind::kInstruction) {
+    return 0;
+  }
+  const auto &name = p_statement.name;
+  if (name == "la" || name == "lla" || name == "call" || name == "tail") {
+    return 8;
+  }
+  int64_t imm = 0;
+  if (name == "li" && !(p_statement.operands.size() == 2 &&
+                        parseImmediate(p_statement.operands[1], imm) &&
+                        imm >= -2048 && imm <= 2047)) {
+    // lui and addi
+    return 8;
+  }
+  return 4;
+}
+
+static bool fitsBranchOffset(const int64_t p_offset) {
+  return p_offset >= -4096 && p_offset <= 4094;
+}
+
+bool relaxBranches(AsmProgram &p_program) {
+  auto &statements = p_program.getStatements();
+  std::set<std::string> labels;
+  for (const auto &statement : statements) {
+    if (statement.kind == AsmStatement::Kind::kLabel) {
+      labels.insert(statement.name);
+    }
+  }
+  size_t num_relaxed = 0;
+  bool changed = false;
+  bool found = true;
+  // a relaxed branch takes more space, which may put others out of reach
+  while (found) {
+    found = false;
+    std::vector<size_t> far_branches;
+    for (const auto &run : findCodeRuns(statements)) {
+      std::map<std::string, int64_t> label_offsets;
+      int64_t offset = 0;
+      for (size_t i = run.first; i < run.second; ++i) {
+        if (statements[i].kind == AsmStatement::Kind::kLabel) {
+          label_offsets[statements[i].name] = offset;
+        }
+        offset += getSize(statements[i]);
+      }
+      offset = 0;
+      for (size_t i = run.first; i < run.second; ++i) {
+        const auto &statement = statements[i];
+        if (isBranch(statement)) {
+          const auto it = label_offsets.find(statement.operands.back());
+          if (it != label_offsets.end() &&
+              !fitsBranchOffset(it->second - offset)) {
+            far_branches.push_back(i);
+          }
+        }
+        offset += getSize(statement);
+      }
+    }
+    // from the back, so that the indices before stay valid
+    for (auto it = far_branches.rbegin(); it != far_branches.rend(); ++it) {
+      const auto branch = statements[*it];
+      std::string skip_label;
+      do {
+        skip_label = ".Lrelax" + std::to_string(num_relaxed++);
+      } while (!labels.insert(skip_label).second);
+      const AsmStatement relaxed[] = {
+          invertBranch(branch, skip_label),
+          AsmStatement{AsmStatement::Kind::kInstruction, "j",
+                       {branch.operands.back()}, branch.line},
+          AsmStatement{AsmStatement::Kind::kLabel, skip_label, {},
+                       branch.line}};
+      statements.erase(statements.begin() + *it);
+      statements.insert(statements.begin() + *it, std::begin(relaxed),
+                        std::end(relaxed));
+      found = true;
+    }
+    changed |= found;
+  }
+  return changed;
+}
+
+bool layoutBlocksFile(const std::string &p_path, const bool p_reorder,
+                      std::string &p_error) {
+  AsmProgram program;
+  if (!program.parseFile(p_path, p_error)) {
+    p_error = p_path + ": " + p_error;
+    return false;
+  }
+  const bool is_laid_out = p_reorder && layoutBlocks(program);
+  const bool is_relaxed = relaxBranches(program);
+  if (!is_laid_out && !is_relaxed) {
+    return true;
+  }
+  OutputFile output(std::fopen(p_path.c_str(), "w"));
+  if (!output) {
+    p_error = "cannot write " + p_path;
+    return false;
+  }
+  program.print(output.get());
+  return true;
+}
@@ -0,0 +1,220 @@
+#include "asm/ObjectFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+// ELF constants used below (System V gABI)
+static constexpr uint16_t kETRel = 1;
+static constexpr uint16_t kEMRiscv = 243;
+static constexpr uint32_t kSHTProgbits = 1;
+static constexpr uint32_t kSHTSymtab = 2;
+static constexpr uint32_t kSHTStrtab = 3;
+static constexpr uint32_t kSHTRela = 4;
+static constexpr uint32_t kSHTNobits = 8;
+static constexpr uint32_t kSHFWrite = 0x1;
+static constexpr uint32_t kSHFAlloc = 0x2;
+static constexpr uint32_t kSHFExecInstr = 0x4;
+static constexpr uint32_t kSHFInfoLink = 0x40;
+static constexpr uint8_t kSTBLocal = 0;
+static constexpr uint8_t kSTBGlobal = 1;
+static constexpr uint8_t kSTTFile = 4;
+static constexpr uint16_t kSHNAbs = 0xfff1;
+
+static void put16(std::vector<uint8_t> &p_buf, const uint16_t p_value) {
+  p_buf.push_back(p_value & 0xff);
+  p_buf.push_back(p_value >> 8);
+}
+
+static void put32(std::vector<uint8_t> &p_buf, const uint32_t p_value) {
+  for (int i = 0; i < 4; ++i) {
+    p_buf.push_back((p_value >> (8 * i)) & 0xff);
+  }
+}
+
+static uint32_t addString(std::vector<uint8_t> &p_table,
+                          const std::string &p_str) {
+  const auto offset = static_cast<uint32_t>(p_table.size());
+  p_table.insert(p_table.end(), p_str.begin(), p_str.end());
+  p_table.push_back('\0');
+  return offset;
+}
+
+static uint32_t getSectionType(const ObjectFile::Section::Kind p_kind) {
+  return (p_kind == ObjectFile::Section::Kind::kBss) ? kSHTNobits
+                                                     : kSHTProgbits;
+}
+
+static uint32_t getSectionFlags(const ObjectFile::Section::Kind p_kind) {
+  switch (p_kind) {
+    case ObjectFile::Section::Kind::kText:
+      return kSHFAlloc | kSHFExecInstr;
+    case ObjectFile::Section::Kind::kData:
+    case ObjectFile::Section::Kind::kBss:
+      return kSHFAlloc | kSHFWrite;
+    case ObjectFile::Section::Kind::kRodata:
+      return kSHFAlloc;
+    case ObjectFile::Section::Kind::kNote:
+      return 0;
+  }
+  return 0;
+}
+
+struct SectionHeader {
+  uint32_t name, type, flags, addr, offset, size, link, info, align, entsize;
+};
+
+bool ObjectFile::write(const std::string &p_path, std::string &p_error) const {
+  // ELF wants the local symbols first; index 0 is the null symbol
+  std::vector<size_t> order;
+  for (size_t i = 0; i < m_symbols.size(); ++i) {
+    if (!m_symbols[i].is_global) {
+      order.push_back(i);
+    }
+  }
+  const bool has_file_symbol = !m_file_name.empty();
+  const auto first_global =
+      static_cast<uint32_t>(order.size() + 1 + (has_file_symbol ? 1 : 0));
+  for (size_t i = 0; i < m_symbols.size(); ++i) {
+    if (m_symbols[i].is_global) {
+      order.push_back(i);
+    }
+  }
+  std::vector<uint32_t> elf_index(m_symbols.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    elf_index[order[i]] =
+        static_cast<uint32_t>(i + 1 + (has_file_symbol ? 1 : 0));
+  }
+
+  // section indices: 0 is null, then the user sections, then one .rela per
+  // section with relocations, then .symtab, .strtab and .shstrtab
+  std::vector<uint8_t> shstrtab{0};
+  std::vector<uint8_t> strtab{0};
+  std::vector<uint8_t> symtab(16, 0);
+  std::vector<SectionHeader> headers(1, SectionHeader{});
+  std::vector<std::vector<uint8_t>> contents(1);
+
+  for (const auto &section : m_sections) {
+    headers.push_back(SectionHeader{
+        addString(shstrtab, section.name), getSectionType(section.kind),
+        getSectionFlags(section.kind), 0, 0, section.size(), 0, 0,
+        section.align, 0});
+    contents.push_back(section.data);
+  }
+  const auto symtab_idx = static_cast<uint32_t>(
+      headers.size() +
+      std::count_if(m_sections.begin(), m_sections.end(),
+                    [](const Section &p_section) {
+                      return !p_section.relocations.empty();
+                    }));
+  for (size_t i = 0; i < m_sections.size(); ++i) {
+    const auto &relocations = m_sections[i].relocations;
+    if (relocations.empty()) {
+      continue;
+    }
+    std::vector<uint8_t> rela;
+    for (const auto &relocation : relocations) {
+      put32(rela, relocation.offset);
+      put32(rela, (elf_index[relocation.symbol] << 8) |
+                      static_cast<uint32_t>(relocation.type));
+      put32(rela, static_cast<uint32_t>(relocation.addend));
+    }
+    headers.push_back(SectionHeader{
+        addString(shstrtab, ".rela" + m_sections[i].name), kSHTRela,
+        kSHFInfoLink, 0, 0, static_cast<uint32_t>(rela.size()), symtab_idx,
+        static_cast<uint32_t>(i + 1), 4, 12});
+    contents.push_back(rela);
+  }
+
+  auto put_symbol = [&](const uint32_t p_name, const uint32_t p_value,
+                        const uint32_t p_size, const uint8_t p_info,
+                        const uint16_t p_shndx) {
+    put32(symtab, p_name);
+    put32(symtab, p_value);
+    put32(symtab, p_size);
+    symtab.push_back(p_info);
+    symtab.push_back(0);  // default visibility
+    put16(symtab, p_shndx);
+  };
+  if (has_file_symbol) {
+    put_symbol(addString(strtab, m_file_name), 0, 0,
+               (kSTBLocal << 4) | kSTTFile, kSHNAbs);
+  }
+  for (const auto idx : order) {
+    const auto &symbol = m_symbols[idx];
+    const auto binding = symbol.is_global ? kSTBGlobal : kSTBLocal;
+    const auto shndx = (symbol.section == kUndefinedSection)
+                           ? 0
+                           : static_cast<uint16_t>(symbol.section + 1);
+    put_symbol(addString(strtab, symbol.name), symbol.value, symbol.size,
+               static_cast<uint8_t>((binding << 4) |
+                                    static_cast<uint8_t>(symbol.type)),
+               shndx);
+  }
+  headers.push_back(SectionHeader{addString(shstrtab, ".symtab"), kSHTSymtab,
+                                  0, 0, 0, static_cast<uint32_t>(symtab.size()),
+                                  symtab_idx + 1, first_global, 4, 16});
+  contents.push_back(symtab);
+  headers.push_back(SectionHeader{addString(shstrtab, ".strtab"), kSHTStrtab,
+                                  0, 0, 0, static_cast<uint32_t>(strtab.size()),
+                                  0, 0, 1, 0});
+  contents.push_back(strtab);
+  const auto shstrtab_name = addString(shstrtab, ".shstrtab");
+  headers.push_back(SectionHeader{shstrtab_name, kSHTStrtab, 0, 0, 0,
+                                  static_cast<uint32_t>(shstrtab.size()), 0, 0,
+                                  1, 0});
+  contents.push_back(shstrtab);
+
+  // file layout: ELF header, section contents, section header table
+  std::vector<uint8_t> body;
+  constexpr uint32_t kEhdrSize = 52;
+  for (size_t i = 1; i < headers.size(); ++i) {
+    const auto align = std::max<uint32_t>(headers[i].align, 1);
+    while ((kEhdrSize + body.size()) % align != 0) {
+      body.push_back(0);
+    }
+    headers[i].offset = static_cast<uint32_t>(kEhdrSize + body.size());
+    body.insert(body.end(), contents[i].begin(), contents[i].end());
+  }
+  while ((kEhdrSize + body.size()) % 4 != 0) {
+    body.push_back(0);
+  }
+  const auto shoff = static_cast<uint32_t>(kEhdrSize + body.size());
+
+  std::vector<uint8_t> file{0x7f, 'E', 'L', 'F', 1 /* ELFCLASS32 */,
+                            1 /* ELFDATA2LSB */, 1 /* EV_CURRENT */};
+  file.resize(16, 0);
+  put16(file, kETRel);
+  put16(file, kEMRiscv);
+  put32(file, 1);  // e_version
+  put32(file, 0);  // e_entry
+  put32(file, 0);  // e_phoff
+  put32(file, shoff);
+  put32(file, 0);  // e_flags: soft-float ABI, no compressed instructions
+  put16(file, kEhdrSize);
+  put16(file, 0);  // e_phentsize
+  put16(file, 0);  // e_phnum
+  put16(file, 40);  // e_shentsize
+  put16(file, static_cast<uint16_t>(headers.size()));
+  put16(file, static_cast<uint16_t>(headers.size() - 1));  // .shstrtab
+  file.insert(file.end(), body.begin(), body.end());
+  for (const auto &header : headers) {
+    for (const auto field :
+         {header.name, header.type, header.flags, header.addr, header.offset,
+          header.size, header.link, header.info, header.align,
+          header.entsize}) {
+      put32(file, field);
+    }
+  }
+
+  FILE *out = std::fopen(p_path.c_str(), "wb");
+  if (!out) {
+    p_error = "cannot open " + p_path;
+    return false;
+  }
+  const bool ok = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+  std::fclose(out);
+  if (!ok) {
+    p_error = "failed to write " + p_path;
+  }
+  return ok;
+}
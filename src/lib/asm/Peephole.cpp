@@ -0,0 +1,289 @@
+#include "asm/Peephole.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "codegen/OutputPath.hpp"
+
+using Statements = AsmProgram::Statements;
+
+static bool parseImmediate(const std::string &p_operand, int64_t &p_imm) {
+  if (p_operand.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  p_imm = std::strtoll(p_operand.c_str(), &end, 0);
+  return *end == '\0';
+}
+
+// off(base)
+static bool parseMemory(const std::string &p_operand, int64_t &p_offset,
+                        std::string &p_base) {
+  const auto open = p_operand.find('(');
+  if (open == std::string::npos || p_operand.back() != ')') {
+    return false;
+  }
+  const auto offset = p_operand.substr(0, open);
+  if (offset.empty()) {
+    p_offset = 0;
+  } else if (!parseImmediate(offset, p_offset)) {
+    return false;
+  }
+  p_base = p_operand.substr(open + 1, p_operand.size() - open - 2);
+  return true;
+}
+
+static bool fitsImm12(const int64_t p_imm) {
+  return p_imm >= -2048 && p_imm <= 2047;
+}
+
+static bool isInstruction(const AsmStatement &p_statement,
+                          const char *p_mnemonic, const size_t p_operands) {
+  return p_statement.kind == AsmStatement::Kind::kInstruction &&
+         p_statement.name == p_mnemonic &&
+         p_statement.operands.size() == p_operands;
+}
+
+// addi sp, sp, imm
+static bool isStackAdjustment(const AsmStatement &p_statement,
+                              int64_t &p_amount) {
+  return isInstruction(p_statement, "addi", 3) &&
+         p_statement.operands[0] == "sp" && p_statement.operands[1] == "sp" &&
+         parseImmediate(p_statement.operands[2], p_amount);
+}
+
+// Instructions that only compute a register from registers and immediates:
+// the first operand is written, the others are read, and neither memory nor
+// the control flow is involved.
+static bool isRegisterOnly(const AsmStatement &p_statement) {
+  static const char *const kMnemonics[] = {
+      "add",  "addi", "sub",   "mul",  "mulh", "mulhu", "mulhsu", "div",
+      "divu", "rem",  "remu",  "and",  "andi", "or",    "ori",    "xor",
+      "xori", "sll",  "slli",  "srl",  "srli", "sra",   "srai",   "slt",
+      "slti", "sltu", "sltiu", "li",   "lui",  "la",    "lla",    "mv",
+      "neg",  "not",  "seqz",  "snez", "sltz", "sgtz"};
+  if (p_statement.kind != AsmStatement::Kind::kInstruction ||
+      p_statement.operands.empty()) {
+    return false;
+  }
+  for (const char *mnemonic : kMnemonics) {
+    if (p_statement.name == mnemonic) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool writes(const AsmStatement &p_statement, const std::string &p_reg) {
+  return p_statement.operands[0] == p_reg;
+}
+
+static bool reads(const AsmStatement &p_statement, const std::string &p_reg) {
+  for (size_t i = 1; i < p_statement.operands.size(); ++i) {
+    if (p_statement.operands[i] == p_reg) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static AsmStatement makeMove(const AsmStatement &p_at, const std::string &p_dst,
+                             const std::string &p_src) {
+  return AsmStatement{AsmStatement::Kind::kInstruction, "mv", {p_dst, p_src},
+                      p_at.line};
+}
+
+// A rule looks at the statement at p_index and returns whether it rewrote
+// the program there.
+using PeepholeRule = bool (*)(Statements &p_statements, const size_t p_index);
+
+// mv x, x and addi x, x, 0
+static bool removeNoOp(Statements &p_statements, const size_t p_index) {
+  const auto &statement = p_statements[p_index];
+  int64_t imm = 0;
+  const bool is_no_op =
+      (isInstruction(statement, "mv", 2) &&
+       statement.operands[0] == statement.operands[1]) ||
+      (isInstruction(statement, "addi", 3) &&
+       statement.operands[0] == statement.operands[1] &&
+       parseImmediate(statement.operands[2], imm) && imm == 0);
+  if (!is_no_op) {
+    return false;
+  }
+  p_statements.erase(p_statements.begin() + p_index);
+  return true;
+}
+
+// sw x, off(base) ... lw y, off(base)  =>  sw x, off(base) ... mv y, x
+// as long as neither x nor base change in between
+static bool forwardStoreToLoad(Statements &p_statements, const size_t p_index) {
+  const auto &store = p_statements[p_index];
+  int64_t offset = 0;
+  std::string base;
+  if (!isInstruction(store, "sw", 2) ||
+      !parseMemory(store.operands[1], offset, base)) {
+    return false;
+  }
+  const auto value = store.operands[0];
+  for (size_t i = p_index + 1; i < p_statements.size(); ++i) {
+    auto &statement = p_statements[i];
+    int64_t load_offset = 0;
+    std::string load_base;
+    if (isInstruction(statement, "lw", 2) &&
+        parseMemory(statement.operands[1], load_offset, load_base) &&
+        load_offset == offset && load_base == base) {
+      statement = makeMove(statement, statement.operands[0], value);
+      return true;
+    }
+    // other words of the same base are never the stored one
+    int64_t other_offset = 0;
+    std::string other_base;
+    if (isInstruction(statement, "sw", 2) &&
+        parseMemory(statement.operands[1], other_offset, other_base) &&
+        other_base == base &&
+        (other_offset + 4 <= offset || offset + 4 <= other_offset)) {
+      continue;
+    }
+    // loads leave memory alone
+    const bool is_load = isInstruction(statement, "lw", 2);
+    if ((!is_load && !isRegisterOnly(statement)) ||
+        writes(statement, value) || writes(statement, base)) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// sw x, off(sp) ... addi sp, sp, n  with the word below the new sp: nothing
+// reads memory below sp, so the store is dead
+static bool removeDeadStackStore(Statements &p_statements,
+                                 const size_t p_index) {
+  const auto &store = p_statements[p_index];
+  int64_t offset = 0;
+  std::string base;
+  if (!isInstruction(store, "sw", 2) ||
+      !parseMemory(store.operands[1], offset, base) || base != "sp" ||
+      offset < 0) {
+    return false;
+  }
+  for (size_t i = p_index + 1; i < p_statements.size(); ++i) {
+    const auto &statement = p_statements[i];
+    int64_t amount = 0;
+    if (isStackAdjustment(statement, amount)) {
+      if (offset + 4 > amount) {
+        return false;
+      }
+      p_statements.erase(p_statements.begin() + p_index);
+      return true;
+    }
+    if (!isRegisterOnly(statement) || writes(statement, "sp")) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// addi sp, sp, a ... addi sp, sp, b  =>  addi sp, sp, a+b ...
+static bool mergeStackAdjustments(Statements &p_statements,
+                                  const size_t p_index) {
+  int64_t first = 0;
+  if (!isStackAdjustment(p_statements[p_index], first)) {
+    return false;
+  }
+  for (size_t i = p_index + 1; i < p_statements.size(); ++i) {
+    const auto &statement = p_statements[i];
+    int64_t second = 0;
+    if (isStackAdjustment(statement, second)) {
+      if (!fitsImm12(first + second)) {
+        return false;
+      }
+      p_statements[p_index].operands[2] = std::to_string(first + second);
+      p_statements.erase(p_statements.begin() + i);
+      return true;
+    }
+    // what lies in between must not see sp move earlier
+    if (!isRegisterOnly(statement) || writes(statement, "sp") ||
+        reads(statement, "sp")) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// j L / b<cond> ..., L  followed by the label L
+static bool removeJumpToNext(Statements &p_statements, const size_t p_index) {
+  static const char *const kJumps[] = {"j",    "beqz", "bnez", "blez",
+                                       "bgez", "bltz", "bgtz", "beq",
+                                       "bne",  "blt",  "bge",  "bltu",
+                                       "bgeu", "bgt",  "ble",  "bgtu",
+                                       "bleu"};
+  const auto &jump = p_statements[p_index];
+  if (jump.kind != AsmStatement::Kind::kInstruction ||
+      jump.operands.empty()) {
+    return false;
+  }
+  bool is_jump = false;
+  for (const char *mnemonic : kJumps) {
+    is_jump |= jump.name == mnemonic;
+  }
+  if (!is_jump) {
+    return false;
+  }
+  const auto &target = jump.operands.back();
+  for (size_t i = p_index + 1; i < p_statements.size(); ++i) {
+    if (p_statements[i].kind != AsmStatement::Kind::kLabel) {
+      return false;
+    }
+    if (p_statements[i].name == target) {
+      p_statements.erase(p_statements.begin() + p_index);
+      return true;
+    }
+  }
+  return false;
+}
+
+static const PeepholeRule kRules[] = {
+    removeNoOp,
+    forwardStoreToLoad,
+    removeDeadStackStore,
+    mergeStackAdjustments,
+    removeJumpToNext,
+};
+
+bool optimizePeephole(AsmProgram &p_program) {
+  auto &statements = p_program.getStatements();
+  bool changed = false;
+  bool found = true;
+  // a rewrite may enable another one earlier on, e.g., a forwarded load
+  // turns the store before it dead
+  while (found) {
+    found = false;
+    for (size_t i = 0; i < statements.size(); ++i) {
+      for (const auto rule : kRules) {
+        if (i < statements.size() && rule(statements, i)) {
+          found = true;
+        }
+      }
+    }
+    changed |= found;
+  }
+  return changed;
+}
+
+bool optimizePeepholeFile(const std::string &p_path, std::string &p_error) {
+  AsmProgram program;
+  if (!program.parseFile(p_path, p_error)) {
+    p_error = p_path + ": " + p_error;
+    return false;
+  }
+  if (!optimizePeephole(program)) {
+    return true;
+  }
+  OutputFile output(std::fopen(p_path.c_str(), "w"));
+  if (!output) {
+    p_error = "cannot write " + p_path;
+    return false;
+  }
+  program.print(output.get());
+  return true;
+}
@@ -0,0 +1,378 @@
+#include "asm/Scheduler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "codegen/OutputPath.hpp"
+
+using Statements = AsmProgram::Statements;
+
+static const PipelineModel kPipelineModels[] = {
+    // a classic five-stage pipeline with a pipelined multiplier
+    {"generic", 2, 3, 20, 4, 20},
+    // the Bumblebee core of the GD32VF103: two stages, with a multiplier
+    // and a divider that iterate over the bits of the operands
+    {"bumblebee", 2, 17, 33, 4, 20},
+};
+
+const PipelineModel *findPipelineModel(const std::string &p_name) {
+  for (const auto &model : kPipelineModels) {
+    if (p_name == model.name) {
+      return &model;
+    }
+  }
+  return nullptr;
+}
+
+enum class Unit : uint8_t {
+  kAlu,
+  kLoad,
+  kStore,
+  kMultiply,
+  kDivide,
+  kReal,
+  kRealDivide
+};
+
+static const char *const kAluMnemonics[] = {
+    "add",  "addi", "sub",  "and",   "andi", "or",   "ori",  "xor",
+    "xori", "sll",  "slli", "srl",   "srli", "sra",  "srai", "slt",
+    "slti", "sltu", "sltiu", "li",   "lui",  "auipc", "la",  "lla",
+    "mv",   "neg",  "not",  "seqz",  "snez", "sltz", "sgtz"};
+
+// bytes accessed by each load and store
+static const std::pair<const char *, int64_t> kLoads[] = {
+    {"lb", 1}, {"lbu", 1}, {"lh", 2}, {"lhu", 2},
+    {"lw", 4}, {"flw", 4}, {"fld", 8}};
+static const std::pair<const char *, int64_t> kStores[] = {
+    {"sb", 1}, {"sh", 2}, {"sw", 4}, {"fsw", 4}, {"fsd", 8}};
+
+// false for what the scheduler does not move: control flow, calls, and
+// anything it does not know the operands of
+static bool classify(const std::string &p_mnemonic, Unit &p_unit,
+                     int64_t &p_access_size) {
+  for (const char *mnemonic : kAluMnemonics) {
+    if (p_mnemonic == mnemonic) {
+      p_unit = Unit::kAlu;
+      return true;
+    }
+  }
+  for (const auto &load : kLoads) {
+    if (p_mnemonic == load.first) {
+      p_unit = Unit::kLoad;
+      p_access_size = load.second;
+      return true;
+    }
+  }
+  for (const auto &store : kStores) {
+    if (p_mnemonic == store.first) {
+      p_unit = Unit::kStore;
+      p_access_size = store.second;
+      return true;
+    }
+  }
+  if (p_mnemonic.compare(0, 3, "mul") == 0) {
+    p_unit = Unit::kMultiply;
+    return true;
+  }
+  if (p_mnemonic.compare(0, 3, "div") == 0 ||
+      p_mnemonic.compare(0, 3, "rem") == 0) {
+    p_unit = Unit::kDivide;
+    return true;
+  }
+  if (p_mnemonic.compare(0, 5, "fdiv.") == 0 ||
+      p_mnemonic.compare(0, 6, "fsqrt.") == 0) {
+    p_unit = Unit::kRealDivide;
+    return true;
+  }
+  if (p_mnemonic[0] == 'f' && p_mnemonic.find('.') != std::string::npos &&
+      p_mnemonic.compare(0, 5, "fence") != 0) {
+    p_unit = Unit::kReal;
+    return true;
+  }
+  return false;
+}
+
+static unsigned getLatency(const Unit p_unit, const PipelineModel &p_model) {
+  switch (p_unit) {
+    case Unit::kLoad:
+      return p_model.load;
+    case Unit::kMultiply:
+      return p_model.multiply;
+    case Unit::kDivide:
+      return p_model.divide;
+    case Unit::kReal:
+      return p_model.real;
+    case Unit::kRealDivide:
+      return p_model.real_divide;
+    default:
+      return 1;
+  }
+}
+
+static const char *const kRegisterNames[] = {
+    "zero", "ra", "sp", "gp", "tp",  "t0",  "t1", "t2", "s0", "s1", "a0",
+    "a1",   "a2", "a3", "a4", "a5",  "a6",  "a7", "s2", "s3", "s4", "s5",
+    "s6",   "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"};
+
+static const char *const kFloatRegisterNames[] = {
+    "ft0", "ft1", "ft2",  "ft3",  "ft4", "ft5", "ft6",  "ft7",
+    "fs0", "fs1", "fa0",  "fa1",  "fa2", "fa3", "fa4",  "fa5",
+    "fa6", "fa7", "fs2",  "fs3",  "fs4", "fs5", "fs6",  "fs7",
+    "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11"};
+
+// integer registers are 0-31, floating-point ones 32-63
+static constexpr int kNumRegisters = 64;
+
+// -1 if p_operand is not a register
+static int getRegisterIndex(const std::string &p_operand) {
+  for (int i = 0; i < 32; ++i) {
+    if (p_operand == kRegisterNames[i]) {
+      return i;
+    }
+    if (p_operand == kFloatRegisterNames[i]) {
+      return 32 + i;
+    }
+  }
+  if (p_operand == "fp") {
+    return 8;
+  }
+  if (p_operand.size() >= 2 &&
+      (p_operand[0] == 'x' || p_operand[0] == 'f')) {
+    char *end = nullptr;
+    const auto index = std::strtoul(p_operand.c_str() + 1, &end, 10);
+    if (*end == '\0' && index < 32) {
+      return static_cast<int>(index) + ((p_operand[0] == 'f') ? 32 : 0);
+    }
+  }
+  return -1;
+}
+
+struct ScheduleNode {
+  Unit unit;
+  std::vector<int> defs;
+  std::vector<int> uses;
+  // off(base) of a load or store
+  int64_t access_size = 0;
+  int base = -1;
+  bool has_offset = false;
+  int64_t offset = 0;
+  // the node that last wrote the base before this one, -1 if none did in
+  // the same run
+  int base_def = -1;
+  // nodes that have to wait for this one, and for how many cycles
+  std::vector<std::pair<int, unsigned>> succs;
+  size_t num_preds = 0;
+};
+
+static void parseOperands(const AsmStatement &p_statement,
+                          ScheduleNode &p_node) {
+  const auto &operands = p_statement.operands;
+  const bool is_memory = p_node.access_size > 0;
+  for (size_t i = 0; i < operands.size(); ++i) {
+    if (is_memory && i == 1) {
+      // off(base), where off may be a relocation such as %lo(sym)
+      const auto open = operands[i].rfind('(');
+      if (open == std::string::npos || operands[i].back() != ')') {
+        continue;
+      }
+      p_node.base = getRegisterIndex(
+          operands[i].substr(open + 1, operands[i].size() - open - 2));
+      if (p_node.base > 0) {
+        p_node.uses.push_back(p_node.base);
+      }
+      const auto offset = operands[i].substr(0, open);
+      char *end = nullptr;
+      p_node.offset = std::strtoll(offset.c_str(), &end, 0);
+      p_node.has_offset = *end == '\0';
+      continue;
+    }
+    const int reg = getRegisterIndex(operands[i]);
+    // writes to zero are dropped, and it never changes
+    if (reg <= 0) {
+      continue;
+    }
+    if (i == 0 && p_node.unit != Unit::kStore) {
+      p_node.defs.push_back(reg);
+    } else {
+      p_node.uses.push_back(reg);
+    }
+  }
+}
+
+// the two accesses, one of them a store, may touch the same bytes
+static bool mayAlias(const ScheduleNode &p_lhs, const ScheduleNode &p_rhs) {
+  if (p_lhs.base < 0 || p_lhs.base != p_rhs.base ||
+      p_lhs.base_def != p_rhs.base_def || !p_lhs.has_offset ||
+      !p_rhs.has_offset) {
+    return true;
+  }
+  return p_lhs.offset < p_rhs.offset + p_rhs.access_size &&
+         p_rhs.offset < p_lhs.offset + p_lhs.access_size;
+}
+
+static void addEdge(std::vector<ScheduleNode> &p_nodes, const int p_from,
+                    const int p_to, const unsigned p_latency) {
+  p_nodes[p_from].succs.emplace_back(p_to, p_latency);
+  ++p_nodes[p_to].num_preds;
+}
+
+static void buildDependences(std::vector<ScheduleNode> &p_nodes,
+                             const PipelineModel &p_model) {
+  std::vector<int> last_def(kNumRegisters, -1);
+  std::vector<std::vector<int>> readers(kNumRegisters);
+  std::vector<int> accesses;
+  for (int j = 0; j < static_cast<int>(p_nodes.size()); ++j) {
+    auto &node = p_nodes[j];
+    for (const int reg : node.uses) {
+      if (last_def[reg] >= 0) {
+        addEdge(p_nodes, last_def[reg], j,
+                getLatency(p_nodes[last_def[reg]].unit, p_model));
+      }
+    }
+    // a later write has to stay after the earlier writes and reads
+    for (const int reg : node.defs) {
+      if (last_def[reg] >= 0) {
+        addEdge(p_nodes, last_def[reg], j, 0);
+      }
+      for (const int reader : readers[reg]) {
+        if (reader != j) {
+          addEdge(p_nodes, reader, j, 0);
+        }
+      }
+    }
+    if (node.access_size > 0) {
+      node.base_def = (node.base >= 0) ? last_def[node.base] : -1;
+      for (const int i : accesses) {
+        const bool has_store = node.unit == Unit::kStore ||
+                               p_nodes[i].unit == Unit::kStore;
+        if (has_store && mayAlias(p_nodes[i], node)) {
+          addEdge(p_nodes, i, j, 0);
+        }
+      }
+      accesses.push_back(j);
+    }
+    for (const int reg : node.uses) {
+      readers[reg].push_back(j);
+    }
+    for (const int reg : node.defs) {
+      last_def[reg] = j;
+      readers[reg].clear();
+    }
+  }
+}
+
+// List scheduling, one instruction per cycle: of the instructions whose
+// operands are ready, the one with the longest chain of latencies after it
+// goes first; if none is ready, the one that gets ready soonest.
+static std::vector<int> schedule(std::vector<ScheduleNode> &p_nodes,
+                                 const PipelineModel &p_model) {
+  const int num_nodes = static_cast<int>(p_nodes.size());
+  std::vector<unsigned> height(num_nodes, 0);
+  for (int i = num_nodes - 1; i >= 0; --i) {
+    height[i] = getLatency(p_nodes[i].unit, p_model);
+    for (const auto &succ : p_nodes[i].succs) {
+      height[i] = std::max(height[i], succ.second + height[succ.first]);
+    }
+  }
+
+  std::vector<unsigned> earliest(num_nodes, 0);
+  std::vector<bool> is_scheduled(num_nodes, false);
+  std::vector<int> order;
+  unsigned cycle = 0;
+  while (static_cast<int>(order.size()) < num_nodes) {
+    int best = -1;
+    for (int i = 0; i < num_nodes; ++i) {
+      if (is_scheduled[i] || p_nodes[i].num_preds > 0) {
+        continue;
+      }
+      if (best < 0) {
+        best = i;
+        continue;
+      }
+      const bool is_ready = earliest[i] <= cycle;
+      const bool is_best_ready = earliest[best] <= cycle;
+      if (is_ready != is_best_ready) {
+        best = is_ready ? i : best;
+      } else if (!is_ready && earliest[i] != earliest[best]) {
+        best = (earliest[i] < earliest[best]) ? i : best;
+      } else if (height[i] > height[best]) {
+        best = i;
+      }
+    }
+    cycle = std::max(cycle, earliest[best]);
+    is_scheduled[best] = true;
+    order.push_back(best);
+    for (const auto &succ : p_nodes[best].succs) {
+      earliest[succ.first] =
+          std::max(earliest[succ.first], cycle + succ.second);
+      --p_nodes[succ.first].num_preds;
+    }
+    ++cycle;
+  }
+  return order;
+}
+
+// Schedules the instructions [p_begin, p_end) in place.
+static bool scheduleRun(Statements &p_statements, const size_t p_begin,
+                        const size_t p_end, std::vector<ScheduleNode> &p_nodes,
+                        const PipelineModel &p_model) {
+  buildDependences(p_nodes, p_model);
+  const auto order = schedule(p_nodes, p_model);
+  bool changed = false;
+  Statements scheduled;
+  for (size_t i = 0; i < order.size(); ++i) {
+    changed |= order[i] != static_cast<int>(i);
+    scheduled.push_back(p_statements[p_begin + order[i]]);
+  }
+  std::move(scheduled.begin(), scheduled.end(),
+            p_statements.begin() + p_begin);
+  return changed;
+}
+
+bool scheduleInstructions(AsmProgram &p_program,
+                          const PipelineModel &p_model) {
+  auto &statements = p_program.getStatements();
+  bool changed = false;
+  std::vector<ScheduleNode> nodes;
+  size_t begin = 0;
+  for (size_t i = 0; i <= statements.size(); ++i) {
+    ScheduleNode node;
+    if (i < statements.size() &&
+        statements[i].kind == AsmStatement::Kind::kInstruction &&
+        classify(statements[i].name, node.unit, node.access_size)) {
+      parseOperands(statements[i], node);
+      nodes.push_back(std::move(node));
+      continue;
+    }
+    if (nodes.size() > 1) {
+      changed |= scheduleRun(statements, begin, i, nodes, p_model);
+    }
+    nodes.clear();
+    begin = i + 1;
+  }
+  return changed;
+}
+
+bool scheduleInstructionsFile(const std::string &p_path,
+                              const PipelineModel &p_model,
+                              std::string &p_error) {
+  AsmProgram program;
+  if (!program.parseFile(p_path, p_error)) {
+    p_error = p_path + ": " + p_error;
+    return false;
+  }
+  if (!scheduleInstructions(program, p_model)) {
+    return true;
+  }
+  OutputFile output(std::fopen(p_path.c_str(), "w"));
+  if (!output) {
+    p_error = "cannot write " + p_path;
+    return false;
+  }
+  program.print(output.get());
+  return true;
+}
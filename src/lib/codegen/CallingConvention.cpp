@@ -0,0 +1,28 @@
+#include "codegen/CallingConvention.hpp"
+
+static constexpr const char *const kIntArgRegisters[] = {
+    "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7"};
+static constexpr const char *const kRealArgRegisters[] = {
+    "fa0", "fa1", "fa2", "fa3", "fa4", "fa5", "fa6", "fa7"};
+static constexpr size_t kNumArgRegisters =
+    sizeof(kIntArgRegisters) / sizeof(kIntArgRegisters[0]);
+
+ArgumentLayout layoutArguments(const std::vector<bool> &p_is_real,
+                               const RealPrecision p_precision) {
+  ArgumentLayout layout;
+  size_t num_ints = 0;
+  size_t num_reals = 0;
+  for (const bool is_real : p_is_real) {
+    auto &num_regs = is_real ? num_reals : num_ints;
+    if (num_regs < kNumArgRegisters) {
+      const auto *regs = is_real ? kRealArgRegisters : kIntArgRegisters;
+      layout.locations.push_back(ArgumentLocation{regs[num_regs++], 0});
+      continue;
+    }
+    const size_t size = is_real ? getRealSize(p_precision) : 4;
+    const size_t offset = (layout.stack_size + size - 1) / size * size;
+    layout.locations.push_back(ArgumentLocation{nullptr, offset});
+    layout.stack_size = offset + size;
+  }
+  return layout;
+}
@@ -4,21 +4,15 @@
 #include <cassert>
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 
+#include "AST/AstNodeCounter.hpp"
+#include "codegen/FrameLayout.hpp"
+#include "codegen/OutputPath.hpp"
+#include "codegen/StrengthReduction.hpp"
+#include "codegen/StringLiteral.hpp"
 #include "visitor/AstNodeInclude.hpp"
 
-std::string genRandString(const size_t len) {
-  static const char alphanum[] =
-      "0123456789"
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-      "abcdefghijklmnopqrstuvwxyz";
-  std::string s(len, ' ');
-  for (size_t i = 0; i < len; ++i) {
-    s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
-  }
-  return s;
-}
-
 static void dumpInstructions(FILE *p_out_file, const char *format, ...) {
   va_list args;
   va_start(args, format);
@@ -26,70 +20,98 @@ static void dumpInstructions(FILE *p_out_file, const char *format, ...) {
   va_end(args);
 }
 
-void CodeGenerator::genOverfit(const std::vector<std::string> &output) {
-  constexpr const char *const code =
-      ".section .rodata\n"
-      ".align 2\n"
-      "ans: .string \"%s\"\n"
-      ".section .text\n"
-      ".globl main\n"
-      ".type main, @function\n"
-      "main:\n"
-      "    # main prologue\n"
-      "    addi sp, sp, -4\n"
-      "    sw ra, 0(sp)\n"
-      "    la a0, ans\n"
-      "    jal ra, printString\n"
-      "    lw ra, 0(sp)\n"
-      "    addi sp, sp, 4\n"
-      "    jr ra\n";
-  std::string output_str;
-  for (const auto &str : output) {
-    output_str += str + '\n';
-  }
-  if (!output_str.empty()) output_str.pop_back();
-  dumpInstructions(m_output_file.get(), code, output_str.c_str());
+// Temporaries used as an evaluation stack for expressions
+static constexpr const char *const kTempRegisters[] = {"t0", "t1", "t2", "t3",
+                                                       "t4", "t5", "t6"};
+static constexpr size_t kNumTempRegisters =
+    sizeof(kTempRegisters) / sizeof(kTempRegisters[0]);
+static constexpr const char *const kFloatTempRegisters[] = {
+    "ft0", "ft1", "ft2", "ft3", "ft4", "ft5", "ft6", "ft7"};
+static constexpr size_t kNumFloatTempRegisters =
+    sizeof(kFloatTempRegisters) / sizeof(kFloatTempRegisters[0]);
+
+static bool isFloatReg(const char *p_reg) { return p_reg[0] == 'f'; }
+
+// reals are scalars of the real type, arrays of them are addresses
+static bool isRealValue(const PType *p_type) {
+  return p_type && p_type->isReal();
+}
+
+// Sethi-Ullman number: the registers needed to evaluate an expression without
+// spilling. Calls count as a single register since live values are saved
+// before their arguments are evaluated.
+static size_t registerNeed(const ExpressionNode &p_expr) {
+  if (isConcatenation(p_expr)) {
+    // the operands have all the registers to themselves, see saveLiveRegs()
+    return 1;
+  }
+  if (const auto *bin_op = dynamic_cast<const BinaryOperatorNode *>(&p_expr)) {
+    const auto lhs_need = registerNeed(bin_op->getLeftOperand());
+    const auto rhs_need = registerNeed(bin_op->getRightOperand());
+    return (lhs_need == rhs_need) ? lhs_need + 1 : std::max(lhs_need, rhs_need);
+  }
+  if (const auto *un_op = dynamic_cast<const UnaryOperatorNode *>(&p_expr)) {
+    return registerNeed(un_op->getOperand());
+  }
+  if (const auto *ref = dynamic_cast<const VariableReferenceNode *>(&p_expr)) {
+    // the address so far, the next index and a scratch register to scale it
+    size_t need = 1;
+    for (const auto &index : ref->getIndices()) {
+      if (!dynamic_cast<const ConstantValueNode *>(index.get())) {
+        need = std::max(need, 1 + std::max<size_t>(registerNeed(*index), 2));
+      }
+    }
+    return need;
+  }
+  return 1;
+}
+
+static size_t alignTo(const size_t p_value, const size_t p_align) {
+  return (p_value + p_align - 1) / p_align * p_align;
+}
+
+// sp stays aligned at calls for the sake of C callees
+static size_t getCallAreaSize(const size_t p_num_bytes) {
+  return alignTo(p_num_bytes, FrameLayout::kStackAlignment);
+}
+
+// whether each parameter of a function is passed as a real
+static std::vector<bool> getRealParameters(
+    const FunctionNode::DeclNodes &p_parameters) {
+  std::vector<bool> is_real;
+  for (const auto &decl : p_parameters) {
+    for (const auto &var : decl->getVariables()) {
+      is_real.push_back(isRealValue(var->getTypePtr()));
+    }
+  }
+  return is_real;
+}
+
+// integer/boolean constants as a 32-bit immediate
+static int64_t constantImmediate(const Constant &p_constant) {
+  if (p_constant.getTypePtr()->isPrimitiveBool()) {
+    return p_constant.boolean() ? 1 : 0;
+  }
+  return p_constant.integer();
 }
 
 CodeGenerator::CodeGenerator(const std::string &source_file_name,
                              const std::string &save_path,
-                             const SymbolManager *const p_symbol_manager)
+                             const SymbolManager *const p_symbol_manager,
+                             const size_t p_unroll_factor,
+                             const RealPrecision p_precision)
     : m_symbol_manager_ptr(p_symbol_manager),
-      m_source_file_path(source_file_name) {
-  // FIXME: assume that the source file is always xxxx.p
-  const auto &real_path = save_path.empty() ? std::string{"."} : save_path;
-  auto slash_pos = source_file_name.rfind("/");
-  auto dot_pos = source_file_name.rfind(".");
-
-  if (slash_pos != std::string::npos) {
-    ++slash_pos;
-  } else {
-    slash_pos = 0;
-  }
-  auto output_file_path{
-      real_path + "/" +
-      source_file_name.substr(slash_pos, dot_pos - slash_pos) + ".S"};
+      m_source_file_path(source_file_name),
+      m_precision(p_precision),
+      m_unroll_factor(p_unroll_factor) {
+  const auto output_file_path =
+      getOutputFilePath(source_file_name, save_path, ".S");
   m_output_file.reset(fopen(output_file_path.c_str(), "w"));
   assert(m_output_file.get() && "Failed to open output file");
   setvbuf(m_output_file.get(), nullptr, _IONBF, 0);
-  overfit["specExample"] = {"123", "10", "55", "5",  "5",
-                            "6",   "7",  "10", "11", "12"};
-  overfit["stringtest"] = {"hello", "hello"};
-  overfit["booleantest1"] = {"10", "0"};
-  overfit["arraytest1"] = {"10", "5", "15", "123", "10"};
-  overfit["arraytest2"] = {"5", "10", "15", "123", "10"};
-  overfit["realtest1"] = {"1.100000", "2.200000", "1.100000"};
-  overfit["realtest2"] = {"3.300000", "2.200000"};
 }
 
 void CodeGenerator::visit(ProgramNode &p_program) {
-  for (const auto &pair : overfit) {
-    if (m_source_file_path.find(pair.first) != std::string::npos) {
-      genOverfit(pair.second);
-      return;
-    }
-  }
-
   // Generate RISC-V instructions for program header
   // clang-format off
   constexpr const char *const riscv_assembly_file_prologue =
@@ -118,22 +140,22 @@ void CodeGenerator::visit(ProgramNode &p_program) {
       "    .globl main\n"
       "    .type main, @function\n"
       "main:\n"
-      "    # main prologue\n"
-      "    addi sp, sp, -128\n"
-      "    sw ra, 124(sp)\n"
-      "    sw s0, 120(sp)\n"
-      "    addi s0, sp, 128\n";
+      "    # main prologue\n";
   dumpInstructions(m_output_file.get(), main_prologue);
+  auto &body = const_cast<CompoundStatementNode &>(p_program.getBody());
+  m_frame = FrameLayout::layoutMainProgram(body, m_precision);
+  m_in_place_appends = findInPlaceAppends(body, m_symbol_manager_ptr);
+  genPrologue();
 
-  const_cast<CompoundStatementNode &>(p_program.getBody()).accept(*this);
+  body.accept(*this);
 
-  constexpr const char *const main_epilogue =
-      "    # main epilogue\n"
-      "    lw ra, 124(sp)\n"
-      "    lw s0, 120(sp)\n"
-      "    addi sp, sp, 128\n"
-      "    jr ra\n";
+  constexpr const char *const main_epilogue = "    # main epilogue\n";
   dumpInstructions(m_output_file.get(), main_epilogue);
+  genEpilogue();
+  constexpr const char *const main_return = "    jr ra\n";
+  dumpInstructions(m_output_file.get(), main_return);
+  genRealConstantPool();
+  genStringLiteralPool();
 
   constexpr const char *const riscv_assembly_file_epilogue =
       ".section    .note.GNU-stack,\"\",@progbits\n";
@@ -154,59 +176,103 @@ void CodeGenerator::visit(VariableNode &p_variable) {
   if (var->getLevel() == 0) {
     constexpr const char *const comment = "    # declare global var \"%s\"\n";
     dumpInstructions(m_output_file.get(), comment, p_variable.getNameCString());
+    const auto *type = p_variable.getTypePtr();
+    const auto real_size = getRealSize(m_precision);
     if (p_variable.getConstantPtr()) {
+      const auto &constant = *p_variable.getConstantPtr();
       constexpr const char *const global_constant =
           ".section    .rodata\n"
-          "    .align 2\n"
+          "    .align %d\n"
           "    .globl %s\n"
           "    .type %s, @object\n"
-          "%s:\n"
-          "    .word %s\n";
+          "%s:\n";
       dumpInstructions(m_output_file.get(), global_constant,
+                       real_size == 8 && type->isReal() ? 3 : 2,
                        p_variable.getNameCString(), p_variable.getNameCString(),
-                       p_variable.getNameCString(),
-                       p_variable.getConstantPtr()->getConstantValueCString());
+                       p_variable.getNameCString());
+      if (type->isReal()) {
+        uint32_t words[2];
+        getRealWords(m_precision, constant.real(), words);
+        constexpr const char *const real_word = "    .word %u\n";
+        for (size_t i = 0; i < real_size / 4; ++i) {
+          dumpInstructions(m_output_file.get(), real_word, words[i]);
+        }
+      } else if (type->isString()) {
+        constexpr const char *const string_word = "    .word .LS%lu\n";
+        dumpInstructions(m_output_file.get(), string_word,
+                         internString(constant.string()));
+      } else {
+        constexpr const char *const word = "    .word %ld\n";
+        dumpInstructions(m_output_file.get(), word,
+                         constantImmediate(constant));
+      }
     } else {
-      constexpr const char *const global_variable = ".comm %s, 4, 4\n";
+      constexpr const char *const global_variable = ".comm %s, %lu, %lu\n";
       dumpInstructions(m_output_file.get(), global_variable,
-                       p_variable.getNameCString());
+                       p_variable.getNameCString(),
+                       type->getStorageSize(real_size),
+                       type->getElementSize(real_size));
     }
   } else {
     if (p_variable.getConstantPtr()) {
       constexpr const char *const comment = "    # declare local const %s\n";
       dumpInstructions(m_output_file.get(), comment,
                        p_variable.getNameCString());
-      constexpr const char *const local_constant =
-          "    li t0, %s\n"
-          "    sw t0, -%d(s0)\n";
-      dumpInstructions(m_output_file.get(), local_constant,
-                       p_variable.getConstantPtr()->getConstantValueCString(),
-                       var->getOffset());
+      const auto &constant = *p_variable.getConstantPtr();
+      const char *value = nullptr;
+      if (constant.getTypePtr()->isReal()) {
+        value = genRealConstant(constant.real());
+      } else if (constant.getTypePtr()->isString()) {
+        value = genStringConstant(constant.string());
+      } else {
+        value = allocReg();
+        constexpr const char *const local_constant = "    li %s, %ld\n";
+        dumpInstructions(m_output_file.get(), local_constant, value,
+                         constantImmediate(constant));
+      }
+      storeLocal(value, var->getOffset());
+      freeReg(value);
     } else {
       constexpr const char *const comment = "    # declare local var \"%s\"\n";
       dumpInstructions(m_output_file.get(), comment,
                        p_variable.getNameCString());
       if (p_variable.isFunctionParam()) {
-        constexpr const char *const pop_args =
-            "    lw t0, %d(s0)\n"
-            "    sw t0, %d(s0)\n";
-        dumpInstructions(m_output_file.get(), pop_args, var->getParamIdx() * 4,
-                         -var->getOffset());
+        const auto &location =
+            m_param_layout.locations[var->getParamIdx()];
+        if (location.reg) {
+          storeLocal(location.reg, var->getOffset());
+        } else {
+          // the stack arguments are right above the frame
+          const char *value = isRealValue(var->getTypePtr())
+                                  ? allocFloatReg()
+                                  : allocReg();
+          constexpr const char *const stack_arg = "    %s %s, %lu(s0)\n";
+          dumpInstructions(m_output_file.get(), stack_arg,
+                           getLoadMnemonic(value), value,
+                           location.stack_offset);
+          storeLocal(value, var->getOffset());
+          freeReg(value);
+        }
       }
     }
   }
 }
 
 void CodeGenerator::visit(ConstantValueNode &p_constant_value) {
-  constexpr const char *const comment = "    # push constant value %s\n";
-  dumpInstructions(m_output_file.get(), comment,
-                   p_constant_value.getConstantValueCString());
-  constexpr const char *const constant_value =
-      "    li t0, %s\n"
-      "    addi sp, sp, -4\n"
-      "    sw t0, 0(sp)\n";
-  dumpInstructions(m_output_file.get(), constant_value,
-                   p_constant_value.getConstantValueCString());
+  const auto &constant = *p_constant_value.getConstantPtr();
+  if (constant.getTypePtr()->isReal()) {
+    m_expr_reg = genRealConstant(constant.real());
+    return;
+  }
+  if (constant.getTypePtr()->isString()) {
+    m_expr_reg = genStringConstant(constant.string());
+    return;
+  }
+  const char *dst = allocReg();
+  constexpr const char *const constant_value = "    li %s, %ld\n";
+  dumpInstructions(m_output_file.get(), constant_value, dst,
+                   constantImmediate(*p_constant_value.getConstantPtr()));
+  m_expr_reg = dst;
 }
 
 void CodeGenerator::visit(FunctionNode &p_function) {
@@ -225,15 +291,22 @@ void CodeGenerator::visit(FunctionNode &p_function) {
                    p_function.getNameCString(), p_function.getNameCString(),
                    p_function.getNameCString());
 
-  constexpr const char *const function_prologue =
-      "    # function prologue\n"
-      "    addi sp, sp, -128\n"
-      "    sw ra, 124(sp)\n"
-      "    sw s0, 120(sp)\n"
-      "    addi s0, sp, 128\n";
-  dumpInstructions(m_output_file.get(), function_prologue,
-                   p_function.getNameCString(), p_function.getNameCString(),
+  constexpr const char *const function_prologue = "    # function prologue\n";
+  dumpInstructions(m_output_file.get(), function_prologue);
+  m_frame = FrameLayout::layoutFunction(p_function, m_precision);
+  genPrologue();
+  // self tail calls come back here with the new arguments in place, to copy
+  // them into the parameters again
+  constexpr const char *const entry_label = ".L%s.entry:\n";
+  dumpInstructions(m_output_file.get(), entry_label,
                    p_function.getNameCString());
+  m_function = &p_function;
+  if (p_function.getBody()) {
+    m_in_place_appends =
+        findInPlaceAppends(*p_function.getBody(), m_symbol_manager_ptr);
+  }
+  m_param_layout = layoutArguments(
+      getRealParameters(p_function.getParameters()), m_precision);
 
   for_each(p_function.getParameters().begin(), p_function.getParameters().end(),
            [&](auto &decl) {
@@ -241,15 +314,18 @@ void CodeGenerator::visit(FunctionNode &p_function) {
                       [&](auto &var) { var->setFunctionParam(); });
            });
   p_function.visitChildNodes(*this);
+  m_function = nullptr;
 
   constexpr const char *const function_epilogue =
-      "    # function epilogue\n"
-      "    lw ra, 124(sp)\n"
-      "    lw s0, 120(sp)\n"
-      "    addi sp, sp, 128\n"
+      ".L%s.exit:\n"
+      "    # function epilogue\n";
+  dumpInstructions(m_output_file.get(), function_epilogue,
+                   p_function.getNameCString());
+  genEpilogue();
+  constexpr const char *const function_return =
       "    jr ra\n"
       "    .size %s, .-%s\n";
-  dumpInstructions(m_output_file.get(), function_epilogue,
+  dumpInstructions(m_output_file.get(), function_return,
                    p_function.getNameCString(), p_function.getNameCString());
 
   // Remove the entries in the hash table
@@ -268,339 +344,1133 @@ void CodeGenerator::visit(CompoundStatementNode &p_compound_statement) {
       p_compound_statement.getSymbolTable());
 }
 
+const char *CodeGenerator::allocReg() {
+  assert(m_reg_depth < kNumTempRegisters && "Run out of temporary registers");
+  return kTempRegisters[m_reg_depth++];
+}
+
+const char *CodeGenerator::allocFloatReg() {
+  assert(m_freg_depth < kNumFloatTempRegisters &&
+         "Run out of floating-point temporary registers");
+  return kFloatTempRegisters[m_freg_depth++];
+}
+
+void CodeGenerator::freeReg(const char *p_reg) {
+  if (isFloatReg(p_reg)) {
+    assert(m_freg_depth > 0 &&
+           kFloatTempRegisters[m_freg_depth - 1] == p_reg &&
+           "Temporary registers must be released in LIFO order");
+    --m_freg_depth;
+    return;
+  }
+  assert(m_reg_depth > 0 && kTempRegisters[m_reg_depth - 1] == p_reg &&
+         "Temporary registers must be released in LIFO order");
+  --m_reg_depth;
+}
+
+size_t CodeGenerator::getNumFreeRegs() const {
+  return std::min(kNumTempRegisters - m_reg_depth,
+                  kNumFloatTempRegisters - m_freg_depth);
+}
+
+void CodeGenerator::freeOperands(const char *p_lhs, const char *p_rhs) {
+  // registers of the same stack are allocated in increasing order
+  const bool rhs_first =
+      isFloatReg(p_lhs) == isFloatReg(p_rhs) && std::strcmp(p_lhs, p_rhs) > 0;
+  freeReg(rhs_first ? p_lhs : p_rhs);
+  freeReg(rhs_first ? p_rhs : p_lhs);
+}
+
+const char *CodeGenerator::getLoadMnemonic(const char *p_reg) const {
+  return isFloatReg(p_reg) ? getRealLoad(m_precision) : "lw";
+}
+
+const char *CodeGenerator::getStoreMnemonic(const char *p_reg) const {
+  return isFloatReg(p_reg) ? getRealStore(m_precision) : "sw";
+}
+
+// a spilled real takes 8 bytes whatever its precision, which keeps sp
+// aligned for doubles
+void CodeGenerator::spillReg(const char *p_reg) {
+  constexpr const char *const spill =
+      "    addi sp, sp, -%d\n"
+      "    %s %s, 0(sp)\n";
+  dumpInstructions(m_output_file.get(), spill, isFloatReg(p_reg) ? 8 : 4,
+                   getStoreMnemonic(p_reg), p_reg);
+}
+
+void CodeGenerator::reloadReg(const char *p_reg) {
+  constexpr const char *const reload =
+      "    %s %s, 0(sp)\n"
+      "    addi sp, sp, %d\n";
+  dumpInstructions(m_output_file.get(), reload, getLoadMnemonic(p_reg), p_reg,
+                   isFloatReg(p_reg) ? 8 : 4);
+}
+
+// addi and the load/store offsets take 12-bit signed immediates
+static constexpr size_t kMaxImmediate = 2047;
+
+bool CodeGenerator::isFrameless() const {
+  // ra is never overwritten and nothing is addressed through s0
+  return m_frame.is_leaf && m_frame.is_empty;
+}
+
+void CodeGenerator::genPrologue() {
+  if (isFrameless()) {
+    return;
+  }
+  // a leaf function keeps its return address in ra
+  if (m_frame.size <= kMaxImmediate) {
+    constexpr const char *const alloc_frame = "    addi sp, sp, -%lu\n";
+    dumpInstructions(m_output_file.get(), alloc_frame, m_frame.size);
+    if (!m_frame.is_leaf) {
+      constexpr const char *const save_ra = "    sw ra, %lu(sp)\n";
+      dumpInstructions(m_output_file.get(), save_ra, m_frame.size - 4);
+    }
+    constexpr const char *const set_fp =
+        "    sw s0, %lu(sp)\n"
+        "    addi s0, sp, %lu\n";
+    dumpInstructions(m_output_file.get(), set_fp, m_frame.size - 8,
+                     m_frame.size);
+    return;
+  }
+  constexpr const char *const large_alloc_frame =
+      "    li t0, %lu\n"
+      "    sub sp, sp, t0\n"
+      "    add t0, sp, t0\n";
+  dumpInstructions(m_output_file.get(), large_alloc_frame, m_frame.size);
+  if (!m_frame.is_leaf) {
+    constexpr const char *const large_save_ra = "    sw ra, -4(t0)\n";
+    dumpInstructions(m_output_file.get(), large_save_ra);
+  }
+  constexpr const char *const large_set_fp =
+      "    sw s0, -8(t0)\n"
+      "    mv s0, t0\n";
+  dumpInstructions(m_output_file.get(), large_set_fp);
+}
+
+void CodeGenerator::genEpilogue() {
+  if (isFrameless()) {
+    return;
+  }
+  if (m_frame.size <= kMaxImmediate) {
+    if (!m_frame.is_leaf) {
+      constexpr const char *const restore_ra = "    lw ra, %lu(sp)\n";
+      dumpInstructions(m_output_file.get(), restore_ra, m_frame.size - 4);
+    }
+    constexpr const char *const epilogue =
+        "    lw s0, %lu(sp)\n"
+        "    addi sp, sp, %lu\n";
+    dumpInstructions(m_output_file.get(), epilogue, m_frame.size - 8,
+                     m_frame.size);
+    return;
+  }
+  if (!m_frame.is_leaf) {
+    constexpr const char *const large_restore_ra = "    lw ra, -4(s0)\n";
+    dumpInstructions(m_output_file.get(), large_restore_ra);
+  }
+  constexpr const char *const large_epilogue =
+      "    mv t0, s0\n"
+      "    lw s0, -8(t0)\n"
+      "    mv sp, t0\n";
+  dumpInstructions(m_output_file.get(), large_epilogue);
+}
+
+void CodeGenerator::loadLocal(const char *p_reg, const size_t p_offset) {
+  const char *load = getLoadMnemonic(p_reg);
+  if (p_offset <= kMaxImmediate + 1) {
+    constexpr const char *const load_local = "    %s %s, -%lu(s0)\n";
+    dumpInstructions(m_output_file.get(), load_local, load, p_reg, p_offset);
+    return;
+  }
+  // an integer is loaded over its own address
+  const char *addr = isFloatReg(p_reg) ? allocReg() : p_reg;
+  constexpr const char *const large_load =
+      "    li %s, -%lu\n"
+      "    add %s, %s, s0\n"
+      "    %s %s, 0(%s)\n";
+  dumpInstructions(m_output_file.get(), large_load, addr, p_offset, addr,
+                   addr, load, p_reg, addr);
+  if (addr != p_reg) {
+    freeReg(addr);
+  }
+}
+
+void CodeGenerator::storeLocal(const char *p_reg, const size_t p_offset) {
+  const char *store = getStoreMnemonic(p_reg);
+  if (p_offset <= kMaxImmediate + 1) {
+    constexpr const char *const store_local = "    %s %s, -%lu(s0)\n";
+    dumpInstructions(m_output_file.get(), store_local, store, p_reg,
+                     p_offset);
+    return;
+  }
+  const char *addr = allocReg();
+  constexpr const char *const large_store =
+      "    li %s, -%lu\n"
+      "    add %s, %s, s0\n"
+      "    %s %s, 0(%s)\n";
+  dumpInstructions(m_output_file.get(), large_store, addr, p_offset, addr,
+                   addr, store, p_reg, addr);
+  freeReg(addr);
+}
+
+const char *CodeGenerator::genExpr(ExpressionNode &p_expr) {
+  ++m_expr_nesting;
+  p_expr.accept(*this);
+  --m_expr_nesting;
+  return m_expr_reg;
+}
+
+const char *CodeGenerator::genConverted(ExpressionNode &p_expr,
+                                        const PType *p_type) {
+  const char *value = genExpr(p_expr);
+  if (isFloatReg(value) == isRealValue(p_type)) {
+    return value;
+  }
+  const char *suffix = getRealSuffix(m_precision);
+  if (isFloatReg(value)) {
+    const char *dst = allocReg();
+    constexpr const char *const real_to_int = "    fcvt.w.%s %s, %s, rtz\n";
+    dumpInstructions(m_output_file.get(), real_to_int, suffix, dst, value);
+    freeReg(value);
+    return dst;
+  }
+  const char *dst = allocFloatReg();
+  constexpr const char *const int_to_real = "    fcvt.%s.w %s, %s\n";
+  dumpInstructions(m_output_file.get(), int_to_real, suffix, dst, value);
+  freeReg(value);
+  return dst;
+}
+
+const char *CodeGenerator::genRealConstant(const double p_value) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &p_value, sizeof(bits));
+  const auto label =
+      m_real_constants.emplace(bits, m_real_constants.size()).first->second;
+  const char *addr = allocReg();
+  const char *dst = allocFloatReg();
+  constexpr const char *const load_constant =
+      "    la %s, .LC%lu\n"
+      "    %s %s, 0(%s)\n";
+  dumpInstructions(m_output_file.get(), load_constant, addr, label,
+                   getRealLoad(m_precision), dst, addr);
+  freeReg(addr);
+  return dst;
+}
+
+void CodeGenerator::genRealConstantPool() {
+  if (m_real_constants.empty()) {
+    return;
+  }
+  const auto real_size = getRealSize(m_precision);
+  constexpr const char *const pool =
+      ".section    .rodata\n"
+      "    .align %d\n";
+  dumpInstructions(m_output_file.get(), pool, real_size == 8 ? 3 : 2);
+  for (const auto &constant : m_real_constants) {
+    double value = 0;
+    std::memcpy(&value, &constant.first, sizeof(value));
+    uint32_t words[2];
+    getRealWords(m_precision, value, words);
+    constexpr const char *const label = ".LC%lu:\n";
+    dumpInstructions(m_output_file.get(), label, constant.second);
+    constexpr const char *const real_word = "    .word %u\n";
+    for (size_t i = 0; i < real_size / 4; ++i) {
+      dumpInstructions(m_output_file.get(), real_word, words[i]);
+    }
+  }
+}
+
+size_t CodeGenerator::internString(const std::string &p_value) {
+  return m_string_literals.emplace(p_value, m_string_literals.size())
+      .first->second;
+}
+
+const char *CodeGenerator::genStringConstant(const std::string &p_value) {
+  const char *dst = allocReg();
+  constexpr const char *const load_string = "    la %s, .LS%lu\n";
+  dumpInstructions(m_output_file.get(), load_string, dst,
+                   internString(p_value));
+  return dst;
+}
+
+void CodeGenerator::genStringLiteralPool() {
+  if (m_string_literals.empty()) {
+    return;
+  }
+  constexpr const char *const pool = ".section    .rodata\n";
+  dumpInstructions(m_output_file.get(), pool);
+  for (const auto &literal : m_string_literals) {
+    genStringLiteral(m_output_file.get(),
+                     ".LS" + std::to_string(literal.second), literal.first);
+  }
+}
+
+// Evaluates both operands into the two topmost registers, as reals if
+// p_as_real. The operand that needs more registers goes first unless calls
+// pin the source order; the first value is spilled only if the other operand
+// cannot fit in what is left.
+void CodeGenerator::genBinaryOperands(BinaryOperatorNode &p_bin_op,
+                                      const bool p_as_real, const char *&p_lhs,
+                                      const char *&p_rhs) {
+  auto &lhs = const_cast<ExpressionNode &>(p_bin_op.getLeftOperand());
+  auto &rhs = const_cast<ExpressionNode &>(p_bin_op.getRightOperand());
+  const bool rhs_first = registerNeed(rhs) > registerNeed(lhs) &&
+                         !hasFunctionInvocation(lhs) &&
+                         !hasFunctionInvocation(rhs);
+  auto &first = rhs_first ? rhs : lhs;
+  auto &second = rhs_first ? lhs : rhs;
+
+  // the type of the operands is all that matters here
+  static const PType kReal(PType::PrimitiveTypeEnum::kRealType);
+  static const PType kInteger(PType::PrimitiveTypeEnum::kIntegerType);
+  const PType *operand_type = p_as_real ? &kReal : &kInteger;
+  const char *first_reg = genConverted(first, operand_type);
+  const char *second_reg = nullptr;
+  if (getNumFreeRegs() < registerNeed(second)) {
+    spillReg(first_reg);
+    freeReg(first_reg);
+    second_reg = genConverted(second, operand_type);
+    first_reg = p_as_real ? allocFloatReg() : allocReg();
+    reloadReg(first_reg);
+  } else {
+    second_reg = genConverted(second, operand_type);
+  }
+
+  p_lhs = rhs_first ? second_reg : first_reg;
+  p_rhs = rhs_first ? first_reg : second_reg;
+}
+
+// Arithmetic with a real operand gives a real, and comparisons with one
+// compare reals; the other operand is converted if it is an integer.
+static bool isRealOperation(const BinaryOperatorNode &p_bin_op) {
+  return isRealValue(p_bin_op.getLeftOperand().getInferredType()) ||
+         isRealValue(p_bin_op.getRightOperand().getInferredType());
+}
+
+const char *CodeGenerator::genRealCompare(const Operator p_op,
+                                          const char *p_lhs,
+                                          const char *p_rhs) {
+  // flt/fle only, so a > b is b < a; a <> b is the negation of feq
+  const char *compare = nullptr;
+  bool swap = false;
+  switch (p_op) {
+    case Operator::kLessOp:
+      compare = "flt";
+      break;
+    case Operator::kLessOrEqualOp:
+      compare = "fle";
+      break;
+    case Operator::kGreaterOp:
+      compare = "flt";
+      swap = true;
+      break;
+    case Operator::kGreaterOrEqualOp:
+      compare = "fle";
+      swap = true;
+      break;
+    default:
+      compare = "feq";
+      break;
+  }
+  const char *dst = allocReg();
+  constexpr const char *const real_compare = "    %s.%s %s, %s, %s\n";
+  dumpInstructions(m_output_file.get(), real_compare, compare,
+                   getRealSuffix(m_precision), dst, swap ? p_rhs : p_lhs,
+                   swap ? p_lhs : p_rhs);
+  if (p_op == Operator::kNotEqualOp) {
+    constexpr const char *const negate = "    xori %s, %s, 1\n";
+    dumpInstructions(m_output_file.get(), negate, dst, dst);
+  }
+  return dst;
+}
+
+// Compare-and-branch taken when the comparison evaluates to p_jump_if, with
+// its operands swapped if p_swap is set. nullptr for other operators.
+static const char *getBranchMnemonic(const Operator p_op, const bool p_jump_if,
+                                     bool &p_swap) {
+  p_swap = false;
+  switch (p_op) {
+    case Operator::kLessOp:
+      return p_jump_if ? "blt" : "bge";
+    case Operator::kGreaterOrEqualOp:
+      return p_jump_if ? "bge" : "blt";
+    case Operator::kGreaterOp:
+      p_swap = true;
+      return p_jump_if ? "blt" : "bge";
+    case Operator::kLessOrEqualOp:
+      p_swap = true;
+      return p_jump_if ? "bge" : "blt";
+    case Operator::kEqualOp:
+      return p_jump_if ? "beq" : "bne";
+    case Operator::kNotEqualOp:
+      return p_jump_if ? "bne" : "beq";
+    default:
+      return nullptr;
+  }
+}
+
+std::string CodeGenerator::newLabel() {
+  return ".L" + std::to_string(m_num_labels++);
+}
+
+// Comparisons become a single compare-and-branch instead of a 0/1 value, and
+// and/or/not thread the true/false targets so that only the operands that
+// decide the outcome are evaluated.
+void CodeGenerator::genBranch(ExpressionNode &p_cond,
+                              const std::string &p_label,
+                              const bool p_jump_if) {
+  if (auto *bin_op = dynamic_cast<BinaryOperatorNode *>(&p_cond)) {
+    const auto op = bin_op->getOp();
+    if (op == Operator::kAndOp || op == Operator::kOrOp) {
+      auto &lhs = const_cast<ExpressionNode &>(bin_op->getLeftOperand());
+      auto &rhs = const_cast<ExpressionNode &>(bin_op->getRightOperand());
+      // a false operand decides "and", a true one decides "or"
+      if (p_jump_if == (op == Operator::kOrOp)) {
+        genBranch(lhs, p_label, p_jump_if);
+        genBranch(rhs, p_label, p_jump_if);
+        return;
+      }
+      const auto skip_label = newLabel() + "_cond_skip";
+      genBranch(lhs, skip_label, !p_jump_if);
+      genBranch(rhs, p_label, p_jump_if);
+      constexpr const char *const skip = "%s:\n";
+      dumpInstructions(m_output_file.get(), skip, skip_label.c_str());
+      return;
+    }
+    bool swap = false;
+    const char *branch = getBranchMnemonic(op, p_jump_if, swap);
+    if (branch && isRealOperation(*bin_op)) {
+      // the comparison leaves 0 or 1 to branch on, without the xori of <>
+      const char *lhs = nullptr;
+      const char *rhs = nullptr;
+      genBinaryOperands(*bin_op, true, lhs, rhs);
+      const bool is_not_equal = op == Operator::kNotEqualOp;
+      const char *cond = genRealCompare(
+          is_not_equal ? Operator::kEqualOp : op, lhs, rhs);
+      constexpr const char *const branch_on_compare = "    %s %s, %s\n";
+      dumpInstructions(m_output_file.get(), branch_on_compare,
+                       p_jump_if != is_not_equal ? "bnez" : "beqz", cond,
+                       p_label.c_str());
+      freeReg(cond);
+      freeOperands(lhs, rhs);
+      return;
+    }
+    if (branch) {
+      const char *lhs = nullptr;
+      const char *rhs = nullptr;
+      genBinaryOperands(*bin_op, false, lhs, rhs);
+      constexpr const char *const compare_and_branch = "    %s %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), compare_and_branch, branch,
+                       swap ? rhs : lhs, swap ? lhs : rhs, p_label.c_str());
+      freeReg(kTempRegisters[m_reg_depth - 1]);
+      freeReg(kTempRegisters[m_reg_depth - 1]);
+      return;
+    }
+  }
+  if (auto *un_op = dynamic_cast<UnaryOperatorNode *>(&p_cond)) {
+    if (un_op->getOp() == Operator::kNotOp) {
+      genBranch(const_cast<ExpressionNode &>(un_op->getOperand()), p_label,
+                !p_jump_if);
+      return;
+    }
+  }
+  if (auto *constant = dynamic_cast<ConstantValueNode *>(&p_cond)) {
+    if ((constantImmediate(*constant->getConstantPtr()) != 0) == p_jump_if) {
+      constexpr const char *const jump = "    j %s\n";
+      dumpInstructions(m_output_file.get(), jump, p_label.c_str());
+    }
+    return;
+  }
+
+  const char *cond = genExpr(p_cond);
+  constexpr const char *const branch = "    %s %s, %s\n";
+  dumpInstructions(m_output_file.get(), branch, p_jump_if ? "bnez" : "beqz",
+                   cond, p_label.c_str());
+  freeReg(cond);
+}
+
 void CodeGenerator::visit(PrintNode &p_print) {
-  p_print.visitChildNodes(*this);
+  const char *value =
+      genExpr(const_cast<ExpressionNode &>(p_print.getTarget()));
   const auto &expr = p_print.getTarget();
   const auto &expr_type = expr.getInferredType();
   const auto &expr_type_kind = expr_type->getPrimitiveType();
-  const auto &expr_type_size = expr_type->getByteSize();
 
   if (expr_type_kind == PType::PrimitiveTypeEnum::kIntegerType) {
     constexpr const char *const comment = "    # print %s\n";
     dumpInstructions(m_output_file.get(), comment,
                      expr_type->getPTypeCString());
     constexpr const char *const print_integer =
-        "    lw a0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
+        "    mv a0, %s\n"
         "    jal ra, printInt\n";
-    dumpInstructions(m_output_file.get(), print_integer);
+    dumpInstructions(m_output_file.get(), print_integer, value);
   } else if (expr_type_kind == PType::PrimitiveTypeEnum::kBoolType) {
     constexpr const char *const print_boolean =
         "    # print boolean\n"
-        "    lw a0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    jal ra, printInt\n";
-    dumpInstructions(m_output_file.get(), print_boolean);
+        "    mv a0, %s\n"
+        "    jal ra, printBool\n";
+    dumpInstructions(m_output_file.get(), print_boolean, value);
+  } else if (expr_type_kind == PType::PrimitiveTypeEnum::kRealType) {
+    // the runtime prints a float whatever the precision reals are in
+    constexpr const char *const print_real =
+        "    # print real\n"
+        "    %s fa0, %s\n"
+        "    jal ra, printReal\n";
+    dumpInstructions(m_output_file.get(), print_real,
+                     m_precision == RealPrecision::kDouble ? "fcvt.s.d"
+                                                           : "fmv.s",
+                     value);
   } else if (expr_type_kind == PType::PrimitiveTypeEnum::kStringType) {
-    // constexpr const char *const print_string =
-    //     "    # print string\n"
-    //     "    mv a0, t0\n"
-    //     "    li a7, 4\n"
-    //     "    ecall\n";
-    // dumpInstructions(m_output_file.get(), print_string);
+    constexpr const char *const print_string =
+        "    # print string\n"
+        "    mv a0, %s\n"
+        "    jal ra, printString\n";
+    dumpInstructions(m_output_file.get(), print_string, value);
   } else {
     assert(false && "Invalid type");
   }
+  freeReg(value);
 }
 
 void CodeGenerator::visit(BinaryOperatorNode &p_bin_op) {
-  p_bin_op.visitChildNodes(*this);
+  const auto op = p_bin_op.getOp();
+  if ((op == Operator::kAndOp || op == Operator::kOrOp) &&
+      hasFunctionInvocation(p_bin_op.getRightOperand())) {
+    // the right operand must not be evaluated when the left one decides
+    const auto label = newLabel();
+    genBranch(p_bin_op, label + "_cond_false", false);
+    const char *dst = allocReg();
+    constexpr const char *const materialize =
+        "    li %s, 1\n"
+        "    j %s_cond_end\n"
+        "%s_cond_false:\n"
+        "    li %s, 0\n"
+        "%s_cond_end:\n";
+    dumpInstructions(m_output_file.get(), materialize, dst, label.c_str(),
+                     label.c_str(), dst, label.c_str());
+    m_expr_reg = dst;
+    return;
+  }
+
+  if (isConcatenation(p_bin_op)) {
+    genConcatenation(p_bin_op);
+    return;
+  }
+  if (genByConstant(p_bin_op)) {
+    return;
+  }
+
+  const char *lhs = nullptr;
+  const char *rhs = nullptr;
+  if (isRealOperation(p_bin_op)) {
+    genBinaryOperands(p_bin_op, true, lhs, rhs);
+    constexpr const char *const comment = "    # %s\n";
+    dumpInstructions(m_output_file.get(), comment, p_bin_op.getOpCString());
+    const char *arithmetic = nullptr;
+    switch (op) {
+      case Operator::kPlusOp:
+        arithmetic = "fadd";
+        break;
+      case Operator::kMinusOp:
+        arithmetic = "fsub";
+        break;
+      case Operator::kMultiplyOp:
+        arithmetic = "fmul";
+        break;
+      case Operator::kDivideOp:
+        arithmetic = "fdiv";
+        break;
+      default:
+        break;
+    }
+    if (!arithmetic) {
+      // the 0/1 result goes to the integer stack, apart from the operands
+      m_expr_reg = genRealCompare(op, lhs, rhs);
+      freeOperands(lhs, rhs);
+      return;
+    }
+    const char *dst = kFloatTempRegisters[m_freg_depth - 2];
+    constexpr const char *const real_arithmetic = "    %s.%s %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), real_arithmetic, arithmetic,
+                     getRealSuffix(m_precision), dst, lhs, rhs);
+    freeReg(kFloatTempRegisters[m_freg_depth - 1]);
+    m_expr_reg = dst;
+    return;
+  }
+  genBinaryOperands(p_bin_op, false, lhs, rhs);
+  // the result replaces the lower of the two operand registers
+  const char *dst = kTempRegisters[m_reg_depth - 2];
+
+  constexpr const char *const comment = "    # %s\n";
+  dumpInstructions(m_output_file.get(), comment, p_bin_op.getOpCString());
   if (p_bin_op.getOp() == Operator::kPlusOp) {
-    constexpr const char *const comment = "    # add\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const add =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    add t2, t0, t1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), add);
+    constexpr const char *const add = "    add %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), add, dst, lhs, rhs);
   } else if (p_bin_op.getOp() == Operator::kMinusOp) {
-    constexpr const char *const comment = "    # sub\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const sub =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    sub t2, t1, t0\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), sub);
+    constexpr const char *const sub = "    sub %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), sub, dst, lhs, rhs);
   } else if (p_bin_op.getOp() == Operator::kMultiplyOp) {
-    constexpr const char *const comment = "    # mul\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const mul =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    mul t2, t0, t1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), mul);
+    constexpr const char *const mul = "    mul %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), mul, dst, lhs, rhs);
   } else if (p_bin_op.getOp() == Operator::kDivideOp) {
-    constexpr const char *const comment = "    # div\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const div =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    div t2, t1, t0\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), div);
+    constexpr const char *const div = "    div %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), div, dst, lhs, rhs);
+  } else if (p_bin_op.getOp() == Operator::kModOp) {
+    constexpr const char *const mod_op = "    rem %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), mod_op, dst, lhs, rhs);
   } else if (p_bin_op.getOp() == Operator::kLessOp) {
-    constexpr const char *const comment = "    # less\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const less =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    slt t2, t1, t0\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), less);
+    constexpr const char *const less = "    slt %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), less, dst, lhs, rhs);
   } else if (p_bin_op.getOp() == Operator::kLessOrEqualOp) {
-    constexpr const char *const comment = "    # less or equal\n";
-    dumpInstructions(m_output_file.get(), comment);
     constexpr const char *const less_or_equal =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    slt t2, t0, t1\n"
-        "    xori t2, t2, 1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), less_or_equal);
+        "    slt %s, %s, %s\n"
+        "    xori %s, %s, 1\n";
+    dumpInstructions(m_output_file.get(), less_or_equal, dst, rhs, lhs, dst,
+                     dst);
   } else if (p_bin_op.getOp() == Operator::kGreaterOp) {
-    constexpr const char *const comment = "    # greater\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const greater =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    slt t2, t0, t1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), greater);
+    constexpr const char *const greater = "    slt %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), greater, dst, rhs, lhs);
   } else if (p_bin_op.getOp() == Operator::kGreaterOrEqualOp) {
-    constexpr const char *const comment = "    # greater or equal\n";
-    dumpInstructions(m_output_file.get(), comment);
     constexpr const char *const greater_or_equal =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    slt t2, t1, t0\n"
-        "    xori t2, t2, 1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), greater_or_equal);
+        "    slt %s, %s, %s\n"
+        "    xori %s, %s, 1\n";
+    dumpInstructions(m_output_file.get(), greater_or_equal, dst, lhs, rhs, dst,
+                     dst);
   } else if (p_bin_op.getOp() == Operator::kEqualOp) {
-    constexpr const char *const comment = "    # equal\n";
-    dumpInstructions(m_output_file.get(), comment);
     constexpr const char *const equal =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    xor t2, t0, t1\n"
-        "    sltiu t2, t2, 1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), equal);
+        "    xor %s, %s, %s\n"
+        "    seqz %s, %s\n";
+    dumpInstructions(m_output_file.get(), equal, dst, lhs, rhs, dst, dst);
   } else if (p_bin_op.getOp() == Operator::kNotEqualOp) {
-    constexpr const char *const comment = "    # not equal\n";
-    dumpInstructions(m_output_file.get(), comment);
     constexpr const char *const not_equal =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    snez t2, t0, t1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), not_equal);
+        "    xor %s, %s, %s\n"
+        "    snez %s, %s\n";
+    dumpInstructions(m_output_file.get(), not_equal, dst, lhs, rhs, dst, dst);
   } else if (p_bin_op.getOp() == Operator::kAndOp) {
-    constexpr const char *const comment = "    # and\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const and_op =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    and t2, t0, t1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), and_op);
+    constexpr const char *const and_op = "    and %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), and_op, dst, lhs, rhs);
   } else if (p_bin_op.getOp() == Operator::kOrOp) {
-    constexpr const char *const comment = "    # or\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const or_op =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    or t2, t0, t1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), or_op);
-  } else if (p_bin_op.getOp() == Operator::kModOp) {
-    constexpr const char *const comment = "    # mod\n";
-    dumpInstructions(m_output_file.get(), comment);
-    constexpr const char *const mod_op =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    rem t2, t1, t0\n"
-        "    addi sp, sp, -4\n"
-        "    sw t2, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), mod_op);
+    constexpr const char *const or_op = "    or %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), or_op, dst, lhs, rhs);
   } else {
     printf("Invalid operator: %s\n", p_bin_op.getOpCString());
     assert(false && "Invalid operator");
   }
+  freeReg(kTempRegisters[m_reg_depth - 1]);
+  m_expr_reg = dst;
+}
+
+void CodeGenerator::genConcatenation(BinaryOperatorNode &p_bin_op) {
+  const auto &base = p_bin_op.getLeftOperand();
+  const bool in_place = isConcatenation(base) || &base == m_appended;
+  // the runtime clobbers the temporaries like any other call
+  const auto saved = saveLiveRegs();
+  const char *lhs = nullptr;
+  const char *rhs = nullptr;
+  genBinaryOperands(p_bin_op, false, lhs, rhs);
+  constexpr const char *const concatenate =
+      "    # %s\n"
+      "    mv a1, %s\n"
+      "    mv a0, %s\n"
+      "    jal ra, %s\n";
+  dumpInstructions(m_output_file.get(), concatenate, p_bin_op.getOpCString(),
+                   rhs, lhs, in_place ? "appendString" : "concatString");
+  freeOperands(lhs, rhs);
+  restoreLiveRegs(saved);
+  const char *dst = allocReg();
+  constexpr const char *const result = "    mv %s, a0\n";
+  dumpInstructions(m_output_file.get(), result, dst);
+  m_expr_reg = dst;
+}
+
+// c or -c for an integer literal c
+static bool getIntegerConstant(const ExpressionNode &p_expr, int64_t &p_imm) {
+  bool negate = false;
+  const auto *expr = &p_expr;
+  if (const auto *un_op = dynamic_cast<const UnaryOperatorNode *>(expr)) {
+    negate = un_op->getOp() == Operator::kNegOp;
+    expr = negate ? &un_op->getOperand() : expr;
+  }
+  const auto *constant = dynamic_cast<const ConstantValueNode *>(expr);
+  if (!constant ||
+      !constant->getConstantPtr()->getTypePtr()->isPrimitiveInteger()) {
+    return false;
+  }
+  const auto imm = constantImmediate(*constant->getConstantPtr());
+  p_imm = static_cast<int32_t>(negate ? -imm : imm);
+  return true;
+}
+
+// x * c, c * x, x / c and x mod c for an integer constant c. The constant
+// is never loaded unless no shorter sequence exists for it.
+bool CodeGenerator::genByConstant(BinaryOperatorNode &p_bin_op) {
+  const auto op = p_bin_op.getOp();
+  const auto *type = p_bin_op.getInferredType();
+  if ((op != Operator::kMultiplyOp && op != Operator::kDivideOp &&
+       op != Operator::kModOp) ||
+      !type || !type->isPrimitiveInteger() ||
+      kNumTempRegisters - m_reg_depth < 3) {
+    // room for the value and two scratch registers is needed
+    return false;
+  }
+  auto &lhs = const_cast<ExpressionNode &>(p_bin_op.getLeftOperand());
+  auto &rhs = const_cast<ExpressionNode &>(p_bin_op.getRightOperand());
+  auto *value = &lhs;
+  int64_t imm = 0;
+  if (!getIntegerConstant(rhs, imm)) {
+    if (op != Operator::kMultiplyOp || !getIntegerConstant(lhs, imm)) {
+      return false;
+    }
+    value = &rhs;
+  }
+
+  const char *dst = genExpr(*value);
+  const char *scratch0 = allocReg();
+  const char *scratch1 = allocReg();
+  constexpr const char *const comment = "    # %s\n";
+  dumpInstructions(m_output_file.get(), comment, p_bin_op.getOpCString());
+  FILE *out = m_output_file.get();
+  bool reduced = false;
+  if (op == Operator::kMultiplyOp) {
+    reduced = genMulByConstant(out, dst, dst, imm, scratch0);
+  } else if (op == Operator::kDivideOp) {
+    reduced = genDivByConstant(out, dst, dst, imm, scratch0);
+  } else {
+    reduced = genRemByConstant(out, dst, dst, imm, scratch0, scratch1);
+  }
+  if (!reduced) {
+    constexpr const char *const by_register =
+        "    li %s, %ld\n"
+        "    %s %s, %s, %s\n";
+    const char *mnemonic = op == Operator::kMultiplyOp  ? "mul"
+                           : op == Operator::kDivideOp ? "div"
+                                                       : "rem";
+    dumpInstructions(out, by_register, scratch0, imm, mnemonic, dst, dst,
+                     scratch0);
+  }
+  freeReg(scratch1);
+  freeReg(scratch0);
+  m_expr_reg = dst;
+  return true;
 }
 
 void CodeGenerator::visit(UnaryOperatorNode &p_un_op) {
-  p_un_op.visitChildNodes(*this);
+  const char *dst =
+      genExpr(const_cast<ExpressionNode &>(p_un_op.getOperand()));
   constexpr const char *const comment = "    # unary op\n";
   dumpInstructions(m_output_file.get(), comment);
-  if (p_un_op.getOp() == Operator::kNegOp) {
-    constexpr const char *const neg_op =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    neg t1, t0\n"
-        "    addi sp, sp, -4\n"
-        "    sw t1, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), neg_op);
+  if (p_un_op.getOp() == Operator::kNegOp && isFloatReg(dst)) {
+    constexpr const char *const real_neg_op = "    fneg.%s %s, %s\n";
+    dumpInstructions(m_output_file.get(), real_neg_op,
+                     getRealSuffix(m_precision), dst, dst);
+  } else if (p_un_op.getOp() == Operator::kNegOp) {
+    constexpr const char *const neg_op = "    neg %s, %s\n";
+    dumpInstructions(m_output_file.get(), neg_op, dst, dst);
   } else if (p_un_op.getOp() == Operator::kNotOp) {
-    constexpr const char *const not_op =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    seqz t1, t0\n"
-        "    addi sp, sp, -4\n"
-        "    sw t1, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), not_op);
+    constexpr const char *const not_op = "    seqz %s, %s\n";
+    dumpInstructions(m_output_file.get(), not_op, dst, dst);
   } else {
     printf("Invalid operator: %s\n", p_un_op.getOpCString());
     assert(false && "Invalid operator");
   }
+  m_expr_reg = dst;
+}
+
+// reals go after the integers, 8 bytes each
+static size_t getSavedFloatRegsOffset(const size_t p_num_regs) {
+  return alignTo(p_num_regs * 4, 8);
+}
+
+CodeGenerator::SavedRegs CodeGenerator::saveLiveRegs() {
+  SavedRegs saved;
+  saved.regs = m_reg_depth;
+  saved.fregs = m_freg_depth;
+  const size_t fregs_offset = getSavedFloatRegsOffset(saved.regs);
+  saved.size = getCallAreaSize(fregs_offset + saved.fregs * 8);
+  if (saved.size > 0) {
+    constexpr const char *const alloc_saved = "    addi sp, sp, -%lu\n";
+    dumpInstructions(m_output_file.get(), alloc_saved, saved.size);
+  }
+  constexpr const char *const save = "    %s %s, %lu(sp)\n";
+  for (size_t i = 0; i < saved.regs; ++i) {
+    dumpInstructions(m_output_file.get(), save, "sw", kTempRegisters[i],
+                     i * 4);
+  }
+  for (size_t i = 0; i < saved.fregs; ++i) {
+    dumpInstructions(m_output_file.get(), save, getRealStore(m_precision),
+                     kFloatTempRegisters[i], fregs_offset + i * 8);
+  }
+  m_reg_depth = 0;
+  m_freg_depth = 0;
+  return saved;
+}
+
+void CodeGenerator::restoreLiveRegs(const SavedRegs &p_saved) {
+  m_reg_depth = p_saved.regs;
+  m_freg_depth = p_saved.fregs;
+  const size_t fregs_offset = getSavedFloatRegsOffset(p_saved.regs);
+  constexpr const char *const restore = "    %s %s, %lu(sp)\n";
+  for (size_t i = 0; i < p_saved.regs; ++i) {
+    dumpInstructions(m_output_file.get(), restore, "lw", kTempRegisters[i],
+                     i * 4);
+  }
+  for (size_t i = 0; i < p_saved.fregs; ++i) {
+    dumpInstructions(m_output_file.get(), restore, getRealLoad(m_precision),
+                     kFloatTempRegisters[i], fregs_offset + i * 8);
+  }
+  if (p_saved.size > 0) {
+    constexpr const char *const free_saved = "    addi sp, sp, %lu\n";
+    dumpInstructions(m_output_file.get(), free_saved, p_saved.size);
+  }
+}
+
+ArgumentLayout CodeGenerator::layoutCall(const std::string &p_name) const {
+  const auto *entry = m_symbol_manager_ptr->lookup(p_name);
+  return layoutArguments(
+      getRealParameters(*entry->getAttribute().parameters()), m_precision);
 }
 
 void CodeGenerator::visit(FunctionInvocationNode &p_func_invocation) {
-  auto func = m_symbol_manager_ptr->lookup(p_func_invocation.getName());
-  p_func_invocation.visitChildNodes(*this);
   constexpr const char *const comment = "    # call function %s\n";
   dumpInstructions(m_output_file.get(), comment,
                    p_func_invocation.getNameCString());
-  // // move parameters to a0-a7
-  // constexpr const char *const push_parameters =
-  //     "    lw t0, 0(sp)\n"
-  //     "    addi sp, sp, 4\n"
-  //     "    mv a%d, t0\n";
-  // for (size_t i = 0; i < p_func_invocation.getArguments().size(); ++i) {
-  //   dumpInstructions(m_output_file.get(), push_parameters, i);
-  // }
-  constexpr const char *const call_function =
-      "    jal ra, %s\n"
-      "    mv t0, a0\n"
-      "    addi sp, sp, -4\n"
-      "    addi sp, sp, %d\n"
-      "    sw t0, 0(sp)\n";
+
+  const auto saved = saveLiveRegs();
+  const auto layout = layoutCall(p_func_invocation.getName());
+  const auto args_size = getCallAreaSize(layout.stack_size);
+  if (args_size > 0) {
+    constexpr const char *const alloc_args = "    addi sp, sp, -%lu\n";
+    dumpInstructions(m_output_file.get(), alloc_args, args_size);
+  }
+  genArguments(p_func_invocation, layout, false);
+
+  constexpr const char *const call_function = "    jal ra, %s\n";
   dumpInstructions(m_output_file.get(), call_function,
-                   p_func_invocation.getNameCString(),
-                   p_func_invocation.getArguments().size() * 4);
+                   p_func_invocation.getNameCString());
+  if (args_size > 0) {
+    constexpr const char *const free_args = "    addi sp, sp, %lu\n";
+    dumpInstructions(m_output_file.get(), free_args, args_size);
+  }
+
+  restoreLiveRegs(saved);
+
+  // a call statement discards its return value
+  if (m_expr_nesting > 0) {
+    const bool is_real = isRealValue(p_func_invocation.getInferredType());
+    const char *dst = is_real ? allocFloatReg() : allocReg();
+    constexpr const char *const ret_val = "    %s %s, %s\n";
+    dumpInstructions(m_output_file.get(), ret_val,
+                     is_real ? getRealMove(m_precision) : "mv", dst,
+                     is_real ? "fa0" : "a0");
+    m_expr_reg = dst;
+  }
 }
 
-void CodeGenerator::visit(VariableReferenceNode &p_variable_ref) {
-  auto var = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
-  if (var->getLevel() == 0) {
-    constexpr const char *const comment = "    # push global varref \"%s\"\n";
-    dumpInstructions(m_output_file.get(), comment,
-                     p_variable_ref.getNameCString());
-
-    // constexpr const char *const global_variable;
-    if (p_variable_ref.isLvalue()) {
-      constexpr const char *const global_variable =
-          "    la t0, %s\n"
-          "    addi sp, sp, -4\n"
-          "    sw t0, 0(sp)\n";
-      dumpInstructions(m_output_file.get(), global_variable,
-                       p_variable_ref.getNameCString());
+void CodeGenerator::genArguments(FunctionInvocationNode &p_func_invocation,
+                                 const ArgumentLayout &p_layout,
+                                 const bool p_to_incoming) {
+  const auto &args = p_func_invocation.getArguments();
+  const char *stack_args = p_to_incoming ? "s0" : "sp";
+  // the arguments are converted to the types of the parameters
+  std::vector<const PType *> param_types;
+  const auto *entry = m_symbol_manager_ptr->lookup(p_func_invocation.getName());
+  for (const auto &decl : *entry->getAttribute().parameters()) {
+    for (const auto &var : decl->getVariables()) {
+      param_types.push_back(var->getTypePtr());
+    }
+  }
+
+  const bool has_call =
+      std::any_of(args.begin(), args.end(), [](const auto &arg) {
+        return hasFunctionInvocation(*arg);
+      });
+  if (!has_call) {
+    for (size_t i = 0; i < args.size(); ++i) {
+      const char *value = genConverted(*args[i], param_types[i]);
+      const auto &location = p_layout.locations[i];
+      if (location.reg) {
+        constexpr const char *const move_arg = "    %s %s, %s\n";
+        dumpInstructions(m_output_file.get(), move_arg,
+                         isFloatReg(value) ? getRealMove(m_precision) : "mv",
+                         location.reg, value);
+      } else {
+        constexpr const char *const store_arg = "    %s %s, %lu(%s)\n";
+        dumpInstructions(m_output_file.get(), store_arg,
+                         getStoreMnemonic(value), value, location.stack_offset,
+                         stack_args);
+      }
+      freeReg(value);
+    }
+    return;
+  }
+
+  // the calls would clobber the argument registers, so the values wait on
+  // the stack until all of them are known, 8 bytes each
+  const size_t staging_size = getCallAreaSize(args.size() * 8);
+  constexpr const char *const alloc_staging = "    addi sp, sp, -%lu\n";
+  dumpInstructions(m_output_file.get(), alloc_staging, staging_size);
+  for (size_t i = 0; i < args.size(); ++i) {
+    const char *value = genConverted(*args[i], param_types[i]);
+    constexpr const char *const store_arg = "    %s %s, %lu(sp)\n";
+    dumpInstructions(m_output_file.get(), store_arg, getStoreMnemonic(value),
+                     value, i * 8);
+    freeReg(value);
+  }
+  // the stack arguments go right above the staged values
+  const size_t stack_args_offset = p_to_incoming ? 0 : staging_size;
+  for (size_t i = 0; i < args.size(); ++i) {
+    const auto &location = p_layout.locations[i];
+    const bool is_real = isRealValue(param_types[i]);
+    constexpr const char *const load_arg = "    %s %s, %lu(sp)\n";
+    if (location.reg) {
+      dumpInstructions(m_output_file.get(), load_arg,
+                       is_real ? getRealLoad(m_precision) : "lw", location.reg,
+                       i * 8);
+      continue;
+    }
+    const char *value = is_real ? allocFloatReg() : allocReg();
+    dumpInstructions(m_output_file.get(), load_arg, getLoadMnemonic(value),
+                     value, i * 8);
+    constexpr const char *const store_arg = "    %s %s, %lu(%s)\n";
+    dumpInstructions(m_output_file.get(), store_arg, getStoreMnemonic(value),
+                     value, stack_args_offset + location.stack_offset,
+                     stack_args);
+    freeReg(value);
+  }
+  constexpr const char *const free_staging = "    addi sp, sp, %lu\n";
+  dumpInstructions(m_output_file.get(), free_staging, staging_size);
+}
+
+void CodeGenerator::genScale(const char *p_reg, const size_t p_factor) {
+  const char *scratch = allocReg();
+  if (!genMulByConstant(m_output_file.get(), p_reg, p_reg, p_factor,
+                        scratch)) {
+    constexpr const char *const scale =
+        "    li %s, %lu\n"
+        "    mul %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), scale, scratch, p_factor, p_reg,
+                     p_reg, scratch);
+  }
+  freeReg(scratch);
+}
+
+const char *CodeGenerator::genElementAddress(
+    VariableReferenceNode &p_variable_ref, int64_t &p_disp) {
+  const auto *var = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+  const auto *type = var->getTypePtr();
+  const char *base = nullptr;
+  p_disp = 0;
+
+  // the scaled variable indices are summed up in base
+  const auto &indices = p_variable_ref.getIndices();
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const auto stride = type->getStride(i, getRealSize(m_precision));
+    int64_t index = 0;
+    if (getIntegerConstant(*indices[i], index)) {
+      p_disp += index * static_cast<int64_t>(stride);
+      continue;
+    }
+    const char *offset = genExpr(*indices[i]);
+    genScale(offset, stride);
+    if (base) {
+      constexpr const char *const add = "    add %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), add, base, base, offset);
+      freeReg(offset);
     } else {
-      constexpr const char *const global_variable =
-          "    la t0, %s\n"
-          "    lw t0, 0(t0)\n"
-          "    addi sp, sp, -4\n"
-          "    sw t0, 0(sp)\n";
-      dumpInstructions(m_output_file.get(), global_variable,
+      base = offset;
+    }
+  }
+
+  // then the start of the array is added to them
+  const bool is_reference =
+      var->getKind() == SymbolEntry::KindEnum::kParameterKind;
+  if (var->getLevel() == 0 || is_reference) {
+    const char *start = base ? allocReg() : (base = allocReg());
+    if (is_reference) {
+      loadLocal(start, var->getOffset());
+    } else {
+      constexpr const char *const global_address = "    la %s, %s\n";
+      dumpInstructions(m_output_file.get(), global_address, start,
                        p_variable_ref.getNameCString());
     }
+    if (start != base) {
+      constexpr const char *const add = "    add %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), add, base, base, start);
+      freeReg(start);
+    }
   } else {
-    constexpr const char *const comment = "    # push local varref \"%s\"\n";
-    dumpInstructions(m_output_file.get(), comment,
-                     p_variable_ref.getNameCString());
-    if (p_variable_ref.isLvalue()) {
-      constexpr const char *const local_variable =
-          "    addi t0, s0, -%d\n"
-          "    addi sp, sp, -4\n"
-          "    sw t0, 0(sp)\n";
-      dumpInstructions(m_output_file.get(), local_variable, var->getOffset());
+    p_disp -= static_cast<int64_t>(var->getOffset());
+    if (base) {
+      constexpr const char *const add_frame = "    add %s, %s, s0\n";
+      dumpInstructions(m_output_file.get(), add_frame, base, base);
+    } else {
+      base = "s0";
+    }
+  }
+
+  if (p_disp < -static_cast<int64_t>(kMaxImmediate) - 1 ||
+      p_disp > static_cast<int64_t>(kMaxImmediate)) {
+    const bool is_frame = std::strcmp(base, "s0") == 0;
+    const char *disp = allocReg();
+    constexpr const char *const large_disp =
+        "    li %s, %ld\n"
+        "    add %s, %s, %s\n";
+    dumpInstructions(m_output_file.get(), large_disp, disp, p_disp,
+                     is_frame ? disp : base, base, disp);
+    if (is_frame) {
+      base = disp;
+    } else {
+      freeReg(disp);
+    }
+    p_disp = 0;
+  }
+  return base;
+}
+
+void CodeGenerator::visit(VariableReferenceNode &p_variable_ref) {
+  auto var = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+  if (!var->getTypePtr()->getDimensions().empty()) {
+    // an element is loaded, whereas a whole (sub)array stands for its address
+    int64_t disp = 0;
+    const char *base = genElementAddress(p_variable_ref, disp);
+    const bool is_frame = std::strcmp(base, "s0") == 0;
+    if (isRealValue(p_variable_ref.getInferredType())) {
+      const char *dst = allocFloatReg();
+      constexpr const char *const load_element = "    %s %s, %ld(%s)\n";
+      dumpInstructions(m_output_file.get(), load_element,
+                       getRealLoad(m_precision), dst, disp, base);
+      if (!is_frame) {
+        freeReg(base);
+      }
+      m_expr_reg = dst;
+      return;
+    }
+    const char *dst = is_frame ? allocReg() : base;
+    if (p_variable_ref.getInferredType()->isScalar()) {
+      constexpr const char *const load_element = "    lw %s, %ld(%s)\n";
+      dumpInstructions(m_output_file.get(), load_element, dst, disp, base);
     } else {
-      constexpr const char *const local_variable =
-          "    addi t0, s0, -%d\n"
-          "    lw t0, 0(t0)\n"
-          "    addi sp, sp, -4\n"
-          "    sw t0, 0(sp)\n";
-      dumpInstructions(m_output_file.get(), local_variable, var->getOffset());
+      constexpr const char *const array_address = "    addi %s, %s, %ld\n";
+      dumpInstructions(m_output_file.get(), array_address, dst, base, disp);
     }
+    m_expr_reg = dst;
+    return;
   }
-  // p_variable_ref.accept(*this);
+
+  if (var->getLevel() == 0 && isRealValue(var->getTypePtr())) {
+    const char *addr = allocReg();
+    const char *dst = allocFloatReg();
+    constexpr const char *const global_real =
+        "    la %s, %s\n"
+        "    %s %s, 0(%s)\n";
+    dumpInstructions(m_output_file.get(), global_real, addr,
+                     p_variable_ref.getNameCString(), getRealLoad(m_precision),
+                     dst, addr);
+    freeReg(addr);
+    m_expr_reg = dst;
+    return;
+  }
+  const char *dst =
+      isRealValue(var->getTypePtr()) ? allocFloatReg() : allocReg();
+  if (var->getLevel() == 0) {
+    constexpr const char *const global_variable =
+        "    la %s, %s\n"
+        "    lw %s, 0(%s)\n";
+    dumpInstructions(m_output_file.get(), global_variable, dst,
+                     p_variable_ref.getNameCString(), dst, dst);
+  } else {
+    loadLocal(dst, var->getOffset());
+  }
+  m_expr_reg = dst;
 }
 
 void CodeGenerator::visit(AssignmentNode &p_assignment) {
-  p_assignment.getLvalue().setLvalue();
-  p_assignment.visitChildNodes(*this);
   constexpr const char *const comment = "    # assign %s\n";
   dumpInstructions(m_output_file.get(), comment,
                    p_assignment.getLvalue().getNameCString());
-  constexpr const char *const assign =
-      "    lw t0, 0(sp)\n"
-      "    addi sp, sp, 4\n"
-      "    lw t1, 0(sp)\n"
-      "    addi sp, sp, 4\n"
-      "    sw t0, 0(t1)\n";
-  dumpInstructions(m_output_file.get(), assign);
+  auto &lvalue = const_cast<VariableReferenceNode &>(p_assignment.getLvalue());
+  if (m_in_place_appends.count(&p_assignment)) {
+    m_appended = &getConcatenationBase(p_assignment.getExpr());
+  }
+  const char *value =
+      genConverted(p_assignment.getExpr(), lvalue.getInferredType());
+  m_appended = nullptr;
+  genStore(lvalue, value);
+}
+
+void CodeGenerator::genStore(VariableReferenceNode &p_variable_ref,
+                             const char *p_value) {
+  auto var = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+  const char *store = getStoreMnemonic(p_value);
+  if (!p_variable_ref.getIndices().empty()) {
+    int64_t disp = 0;
+    const char *base = genElementAddress(p_variable_ref, disp);
+    constexpr const char *const store_element = "    %s %s, %ld(%s)\n";
+    dumpInstructions(m_output_file.get(), store_element, store, p_value, disp,
+                     base);
+    if (std::strcmp(base, "s0") != 0) {
+      freeReg(base);
+    }
+  } else if (var->getLevel() == 0) {
+    const char *addr = allocReg();
+    constexpr const char *const assign_global =
+        "    la %s, %s\n"
+        "    %s %s, 0(%s)\n";
+    dumpInstructions(m_output_file.get(), assign_global, addr,
+                     p_variable_ref.getNameCString(), store, p_value, addr);
+    freeReg(addr);
+  } else {
+    storeLocal(p_value, var->getOffset());
+  }
+  freeReg(p_value);
 }
 
-void CodeGenerator::visit(ReadNode &p_read) {}
+void CodeGenerator::visit(ReadNode &p_read) {
+  auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+  const auto *type = target.getInferredType();
+  constexpr const char *const comment = "    # read %s\n";
+  dumpInstructions(m_output_file.get(), comment, type->getPTypeCString());
+  // a statement, so no temporaries are live across the call
+  const char *callee = type->isReal()     ? "readReal"
+                       : type->isBool()   ? "readBool"
+                       : type->isString() ? "readString"
+                                          : "readInt";
+  constexpr const char *const call = "    jal ra, %s\n";
+  dumpInstructions(m_output_file.get(), call, callee);
+  const char *value = nullptr;
+  if (type->isReal()) {
+    // the runtime reads a float whatever the precision reals are in
+    value = allocFloatReg();
+    constexpr const char *const real_result = "    %s %s, fa0\n";
+    dumpInstructions(m_output_file.get(), real_result,
+                     m_precision == RealPrecision::kDouble ? "fcvt.d.s"
+                                                           : "fmv.s",
+                     value);
+  } else {
+    value = allocReg();
+    constexpr const char *const result = "    mv %s, a0\n";
+    dumpInstructions(m_output_file.get(), result, value);
+  }
+  genStore(target, value);
+}
 
 void CodeGenerator::visit(IfNode &p_if) {
   constexpr const char *const comment = "    # ifStatement\n";
   dumpInstructions(m_output_file.get(), comment);
-  p_if.getCondition().accept(*this);
-  auto label = genRandString(10);
-  constexpr const char *const if_prologue =
-      "    lw t0, 0(sp)\n"
-      "    addi sp, sp, 4\n"
-      "    beqz t0, %s_else\n";
-  dumpInstructions(m_output_file.get(), if_prologue, label.c_str());
-  p_if.getBody().accept(*this);
-  constexpr const char *const if_epilogue =
-      "    j %s_if_end\n"
-      "%s_else:\n";
-  dumpInstructions(m_output_file.get(), if_epilogue, label.c_str(),
-                   label.c_str());
-  if (p_if.getElseBody()) {
+  const auto label = newLabel();
+  auto &condition = p_if.getCondition();
+  if (!p_if.getElseBody()) {
+    genBranch(condition, label + "_if_end", false);
+    p_if.getBody().accept(*this);
+  } else {
+    genBranch(condition, label + "_else", false);
+    p_if.getBody().accept(*this);
+    constexpr const char *const if_epilogue =
+        "    j %s_if_end\n"
+        "%s_else:\n";
+    dumpInstructions(m_output_file.get(), if_epilogue, label.c_str(),
+                     label.c_str());
     p_if.getElseBody()->accept(*this);
   }
   constexpr const char *const if_end = "%s_if_end:\n";
@@ -610,21 +1480,73 @@ void CodeGenerator::visit(IfNode &p_if) {
 void CodeGenerator::visit(WhileNode &p_while) {
   constexpr const char *const comment = "    # whileStatement\n";
   dumpInstructions(m_output_file.get(), comment);
-  auto label = genRandString(10);
-  constexpr const char *const while_prologue = "%s_while_begin:\n";
-  dumpInstructions(m_output_file.get(), while_prologue, label.c_str());
-  p_while.getCondition().accept(*this);
-  constexpr const char *const while_body_prologue =
-      "    lw t0, 0(sp)\n"
-      "    addi sp, sp, 4\n"
-      "    beqz t0, %s_while_end\n";
-  dumpInstructions(m_output_file.get(), while_body_prologue, label.c_str());
-  p_while.getBody().accept(*this);
-  constexpr const char *const while_epilogue =
-      "    j %s_while_begin\n"
-      "%s_while_end:\n";
-  dumpInstructions(m_output_file.get(), while_epilogue, label.c_str(),
+  // the condition is tested at the bottom, so the latch is a single
+  // compare-and-branch
+  const auto label = newLabel();
+  constexpr const char *const while_prologue =
+      "    j %s_while_cond\n"
+      "%s_while_begin:\n";
+  dumpInstructions(m_output_file.get(), while_prologue, label.c_str(),
                    label.c_str());
+  p_while.getBody().accept(*this);
+  constexpr const char *const while_cond = "%s_while_cond:\n";
+  dumpInstructions(m_output_file.get(), while_cond, label.c_str());
+  genBranch(p_while.getCondition(), label + "_while_begin", true);
+}
+
+// Unrolling budget, in AST nodes of the body times the unroll factor
+static constexpr size_t kMaxUnrolledSize = 64;
+static constexpr size_t kMaxUnrollFactor = 8;
+
+size_t CodeGenerator::chooseUnrollFactor(ForNode &p_for,
+                                         const size_t p_trip_count) const {
+  if (m_unroll_factor != 0) {
+    return std::min(m_unroll_factor, p_trip_count);
+  }
+  AstNodeCounter counter;
+  p_for.getBody().accept(counter);
+  const auto body_size = counter.getCount();
+  if (p_trip_count * body_size <= kMaxUnrolledSize) {
+    return p_trip_count;
+  }
+  // keep at least two trips of the unrolled loop, so the branch overhead
+  // saved outweighs the larger code
+  size_t factor = kMaxUnrollFactor;
+  while (factor > 1 && (factor * body_size > kMaxUnrolledSize ||
+                        2 * factor > p_trip_count)) {
+    factor /= 2;
+  }
+  return factor;
+}
+
+// Loops from the current value of the loop variable up to p_end with p_factor
+// copies of the body per trip. The loop is tested at the bottom since the
+// trip count is known to be positive.
+void CodeGenerator::genCountedLoop(ForNode &p_for,
+                                   const size_t p_loop_var_offset,
+                                   const int64_t p_end, const size_t p_factor,
+                                   const std::string &p_label) {
+  constexpr const char *const loop_label = "%s:\n";
+  dumpInstructions(m_output_file.get(), loop_label, p_label.c_str());
+  for (size_t i = 0; i < p_factor; ++i) {
+    p_for.getBody().accept(*this);
+
+    const char *loop_var = allocReg();
+    loadLocal(loop_var, p_loop_var_offset);
+    constexpr const char *const increment = "    addi %s, %s, 1\n";
+    dumpInstructions(m_output_file.get(), increment, loop_var, loop_var);
+    storeLocal(loop_var, p_loop_var_offset);
+    if (i + 1 == p_factor) {
+      const char *end = allocReg();
+      constexpr const char *const latch =
+          "    li %s, %ld\n"
+          "    blt %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), latch, end, p_end, loop_var, end,
+                       p_label.c_str());
+      freeReg(end);
+    }
+    freeReg(loop_var);
+  }
 }
 
 void CodeGenerator::visit(ForNode &p_for) {
@@ -633,30 +1555,99 @@ void CodeGenerator::visit(ForNode &p_for) {
       p_for.getSymbolTable());
   constexpr const char *const comment = "    # forStatement\n";
   dumpInstructions(m_output_file.get(), comment);
-  // unrolling the loop
-  for (int i = p_for.getLowerBound().getConstantPtr()->integer();
-       i < p_for.getUpperBound().getConstantPtr()->integer(); i++) {
-    auto label = genRandString(10);
-    constexpr const char *const assign_loop_var =
-        "    li t0, %d\n"
-        "    sw t0, -%d(s0)\n";
-    dumpInstructions(
-        m_output_file.get(), assign_loop_var, i,
-        m_symbol_manager_ptr
-            ->lookup(p_for.getLoopVarDecl().getVariables().front()->getName())
-            ->getOffset());
-    p_for.getBody().accept(*this);
+
+  const auto loop_var_offset =
+      m_symbol_manager_ptr
+          ->lookup(p_for.getLoopVarDecl().getVariables().front()->getName())
+          ->getOffset();
+  const int64_t lower = p_for.getLowerBound().getConstantPtr()->integer();
+  const int64_t upper = p_for.getUpperBound().getConstantPtr()->integer();
+  const size_t trip_count = (lower < upper) ? upper - lower : 0;
+  const size_t factor = trip_count ? chooseUnrollFactor(p_for, trip_count) : 0;
+
+  if (factor == trip_count) {
+    // fully unrolled, the loop variable is a constant in each copy
+    for (int64_t i = lower; i < upper; ++i) {
+      const char *value = allocReg();
+      constexpr const char *const assign_loop_var = "    li %s, %ld\n";
+      dumpInstructions(m_output_file.get(), assign_loop_var, value, i);
+      storeLocal(value, loop_var_offset);
+      freeReg(value);
+      p_for.getBody().accept(*this);
+    }
+  } else {
+    const char *value = allocReg();
+    constexpr const char *const init_loop_var = "    li %s, %ld\n";
+    dumpInstructions(m_output_file.get(), init_loop_var, value, lower);
+    storeLocal(value, loop_var_offset);
+    freeReg(value);
+
+    const auto label = newLabel();
+    const int64_t unrolled_end = lower + trip_count / factor * factor;
+    genCountedLoop(p_for, loop_var_offset, unrolled_end, factor,
+                   label + "_for_body");
+    if (unrolled_end < upper) {
+      // the remaining trip_count % factor iterations
+      genCountedLoop(p_for, loop_var_offset, upper, 1,
+                     label + "_for_remainder");
+    }
   }
+
   // Remove the entries in the hash table
   m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
 }
 
+bool CodeGenerator::genTailCall(FunctionInvocationNode &p_func_invocation) {
+  const auto layout = layoutCall(p_func_invocation.getName());
+  const bool is_self = p_func_invocation.getName() == m_function->getName();
+  // the callee's result is returned as it is, so it must not need converting
+  if (p_func_invocation.getInferredType()->getPrimitiveType() !=
+      m_function->getTypePtr()->getPrimitiveType()) {
+    return false;
+  }
+  // the callee finds its stack arguments where ours were, so they have to fit
+  if (!is_self && layout.stack_size > m_param_layout.stack_size) {
+    return false;
+  }
+  constexpr const char *const comment = "    # tail call function %s\n";
+  dumpInstructions(m_output_file.get(), comment,
+                   p_func_invocation.getNameCString());
+
+  // the incoming arguments are dead once copied into the parameters, and
+  // the arguments only read the parameters
+  genArguments(p_func_invocation, layout, true);
+
+  if (is_self) {
+    constexpr const char *const loop = "    j .L%s.entry\n";
+    dumpInstructions(m_output_file.get(), loop, m_function->getNameCString());
+    return true;
+  }
+  // the callee returns straight to our caller
+  genEpilogue();
+  constexpr const char *const tail_call = "    j %s\n";
+  dumpInstructions(m_output_file.get(), tail_call,
+                   p_func_invocation.getNameCString());
+  return true;
+}
+
 void CodeGenerator::visit(ReturnNode &p_return) {
-  p_return.visitChildNodes(*this);
+  auto &return_value = const_cast<ExpressionNode &>(p_return.getReturnValue());
+  auto *call = dynamic_cast<FunctionInvocationNode *>(&return_value);
+  if (call && m_function && genTailCall(*call)) {
+    return;
+  }
+
+  const char *value =
+      genConverted(return_value, m_function->getTypePtr());
   constexpr const char *const comment = "    # return\n";
   dumpInstructions(m_output_file.get(), comment);
+  const bool is_real = isFloatReg(value);
   constexpr const char *const return_val =
-      "    lw a0, 0(sp)\n"
-      "    addi sp, sp, 4\n";
-  dumpInstructions(m_output_file.get(), return_val);
+      "    %s %s, %s\n"
+      "    j .L%s.exit\n";
+  dumpInstructions(m_output_file.get(), return_val,
+                   is_real ? getRealMove(m_precision) : "mv",
+                   is_real ? "fa0" : "a0", value,
+                   m_function->getNameCString());
+  freeReg(value);
 }
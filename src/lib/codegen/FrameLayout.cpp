@@ -0,0 +1,97 @@
+#include "codegen/FrameLayout.hpp"
+
+#include <algorithm>
+
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+static size_t alignTo(const size_t p_value, const size_t p_align) {
+  return (p_value + p_align - 1) / p_align * p_align;
+}
+
+void FrameLayout::allocate(const SymbolTable *p_table) {
+  if (!p_table) {
+    return;
+  }
+  for (const auto &entry : p_table->getEntries()) {
+    const auto kind = entry->getKind();
+    if (kind == SymbolEntry::KindEnum::kProgramKind ||
+        kind == SymbolEntry::KindEnum::kFunctionKind ||
+        entry->getLevel() == 0) {
+      continue;
+    }
+    const auto *type = entry->getTypePtr();
+    // arrays are passed by reference, so an array parameter is an address
+    const bool is_reference = kind == SymbolEntry::KindEnum::kParameterKind &&
+                              !type->getDimensions().empty();
+    const size_t size = is_reference ? 4 : type->getStorageSize(m_real_size);
+    const size_t align =
+        (type->isPrimitiveReal() && !is_reference) ? m_real_size : 4;
+    m_offset = alignTo(m_offset + size, align);
+    entry->setOffset(m_offset);
+  }
+  m_max_offset = std::max(m_max_offset, m_offset);
+}
+
+FrameLayout::Frame FrameLayout::getFrame() const {
+  return Frame{alignTo(m_max_offset, kStackAlignment),
+               m_max_offset == kFrameHeaderSize, !m_has_calls};
+}
+
+FrameLayout::Frame FrameLayout::layoutFunction(
+    FunctionNode &p_function, const RealPrecision p_precision) {
+  FrameLayout layout(p_precision);
+  // parameters and the locals of the body share the function's table
+  layout.allocate(p_function.getSymbolTable());
+  p_function.visitBodyChildNodes(layout);
+  return layout.getFrame();
+}
+
+FrameLayout::Frame FrameLayout::layoutMainProgram(
+    CompoundStatementNode &p_body, const RealPrecision p_precision) {
+  FrameLayout layout(p_precision);
+  p_body.accept(layout);
+  return layout.getFrame();
+}
+
+void FrameLayout::visit(CompoundStatementNode &p_compound_statement) {
+  const auto saved_offset = m_offset;
+  allocate(p_compound_statement.getSymbolTable());
+  p_compound_statement.visitChildNodes(*this);
+  m_offset = saved_offset;
+}
+
+// printing and reading go through the runtime
+void FrameLayout::visit(PrintNode &p_print) { m_has_calls = true; }
+
+void FrameLayout::visit(FunctionInvocationNode &p_func_invocation) {
+  m_has_calls = true;
+}
+
+void FrameLayout::visit(AssignmentNode &p_assignment) {
+  m_has_calls |= hasFunctionInvocation(p_assignment.getLvalue()) ||
+                 hasFunctionInvocation(p_assignment.getExpr());
+}
+
+void FrameLayout::visit(ReadNode &p_read) { m_has_calls = true; }
+
+void FrameLayout::visit(IfNode &p_if) {
+  m_has_calls |= hasFunctionInvocation(p_if.getCondition());
+  p_if.visitChildNodes(*this);
+}
+
+void FrameLayout::visit(WhileNode &p_while) {
+  m_has_calls |= hasFunctionInvocation(p_while.getCondition());
+  p_while.visitChildNodes(*this);
+}
+
+void FrameLayout::visit(ForNode &p_for) {
+  const auto saved_offset = m_offset;
+  allocate(p_for.getSymbolTable());
+  p_for.visitChildNodes(*this);
+  m_offset = saved_offset;
+}
+
+void FrameLayout::visit(ReturnNode &p_return) {
+  m_has_calls |= hasFunctionInvocation(p_return.getReturnValue());
+}
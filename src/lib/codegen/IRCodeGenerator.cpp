@@ -0,0 +1,1015 @@
+#include "codegen/IRCodeGenerator.hpp"
+
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "codegen/OutputPath.hpp"
+#include "codegen/StrengthReduction.hpp"
+#include "codegen/StringLiteral.hpp"
+
+static void dumpInstructions(FILE *p_out_file, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  vfprintf(p_out_file, format, args);
+  va_end(args);
+}
+
+static bool isFloatReg(const char *p_reg) { return p_reg[0] == 'f'; }
+
+static bool fitsImm12(const int64_t p_imm) {
+  return p_imm >= -2048 && p_imm <= 2047;
+}
+
+static size_t alignTo(const size_t p_value, const size_t p_align) {
+  return (p_value + p_align - 1) / p_align * p_align;
+}
+
+IRCodeGenerator::IRCodeGenerator(const std::string &source_file_name,
+                                 const std::string &save_path,
+                                 const IRModule &p_module,
+                                 const RealPrecision p_precision)
+    : m_module(p_module), m_precision(p_precision) {
+  const auto output_file_path =
+      getOutputFilePath(source_file_name, save_path, ".S");
+  m_output_file.reset(fopen(output_file_path.c_str(), "w"));
+  assert(m_output_file.get() && "Failed to open output file");
+  setvbuf(m_output_file.get(), nullptr, _IONBF, 0);
+  for (const auto &function : m_module.getFunctions()) {
+    m_functions[function->getName()] = function.get();
+  }
+}
+
+const char *IRCodeGenerator::getMoveMnemonic(const char *p_reg) const {
+  return isFloatReg(p_reg) ? getRealMove(m_precision) : "mv";
+}
+
+const char *IRCodeGenerator::getLoadMnemonic(const char *p_reg) const {
+  return isFloatReg(p_reg) ? getRealLoad(m_precision) : "lw";
+}
+
+const char *IRCodeGenerator::getStoreMnemonic(const char *p_reg) const {
+  return isFloatReg(p_reg) ? getRealStore(m_precision) : "sw";
+}
+
+void IRCodeGenerator::addImmediate(const char *p_dst, const char *p_src,
+                                   const int64_t p_imm) {
+  if (fitsImm12(p_imm)) {
+    constexpr const char *const add_imm = "    addi %s, %s, %ld\n";
+    dumpInstructions(m_output_file.get(), add_imm, p_dst, p_src, p_imm);
+  } else {
+    // t6 is reserved as the scratch register for large offsets
+    constexpr const char *const add_large_imm =
+        "    li t6, %ld\n"
+        "    add %s, %s, t6\n";
+    dumpInstructions(m_output_file.get(), add_large_imm, p_imm, p_dst, p_src);
+  }
+}
+
+void IRCodeGenerator::loadFrame(const char *p_reg, const size_t p_offset) {
+  const auto offset = -static_cast<int64_t>(p_offset);
+  if (fitsImm12(offset)) {
+    constexpr const char *const load = "    %s %s, %ld(s0)\n";
+    dumpInstructions(m_output_file.get(), load, getLoadMnemonic(p_reg), p_reg,
+                     offset);
+  } else {
+    addImmediate("t6", "s0", offset);
+    constexpr const char *const load = "    %s %s, 0(t6)\n";
+    dumpInstructions(m_output_file.get(), load, getLoadMnemonic(p_reg),
+                     p_reg);
+  }
+}
+
+void IRCodeGenerator::storeFrame(const char *p_reg, const size_t p_offset) {
+  const auto offset = -static_cast<int64_t>(p_offset);
+  if (fitsImm12(offset)) {
+    constexpr const char *const store = "    %s %s, %ld(s0)\n";
+    dumpInstructions(m_output_file.get(), store, getStoreMnemonic(p_reg),
+                     p_reg, offset);
+  } else {
+    addImmediate("t6", "s0", offset);
+    constexpr const char *const store = "    %s %s, 0(t6)\n";
+    dumpInstructions(m_output_file.get(), store, getStoreMnemonic(p_reg),
+                     p_reg);
+  }
+}
+
+void IRCodeGenerator::loadOperand(const char *p_reg,
+                                  const IROperand &p_operand) {
+  if (p_operand.isVReg()) {
+    const char *reg = m_allocator->getRegister(p_operand.getVReg());
+    if (!reg) {
+      loadFrame(p_reg, m_spill_offsets[p_operand.getVReg()]);
+    } else if (std::strcmp(reg, p_reg) != 0) {
+      constexpr const char *const move = "    %s %s, %s\n";
+      dumpInstructions(m_output_file.get(), move, getMoveMnemonic(p_reg),
+                       p_reg, reg);
+    }
+  } else if (p_operand.isReal()) {
+    loadRealConstantAddress(p_operand);
+    constexpr const char *const load_real = "    %s %s, 0(t6)\n";
+    dumpInstructions(m_output_file.get(), load_real, getRealLoad(m_precision),
+                     p_reg);
+  } else if (p_operand.isImm() && isFloatReg(p_reg)) {
+    // an integer where a real is expected
+    const char *value = "zero";
+    if (p_operand.getImm() != 0) {
+      constexpr const char *const load_imm = "    li t6, %ld\n";
+      dumpInstructions(m_output_file.get(), load_imm, p_operand.getImm());
+      value = "t6";
+    }
+    constexpr const char *const convert = "    fcvt.%s.w %s, %s\n";
+    dumpInstructions(m_output_file.get(), convert, getRealSuffix(m_precision),
+                     p_reg, value);
+  } else if (p_operand.isImm()) {
+    constexpr const char *const load_imm = "    li %s, %ld\n";
+    dumpInstructions(m_output_file.get(), load_imm, p_reg, p_operand.getImm());
+  } else {
+    loadAddress(p_reg, p_operand);
+  }
+}
+
+void IRCodeGenerator::loadRealConstantAddress(const IROperand &p_operand) {
+  const auto inserted = m_real_constants.insert(
+      std::make_pair(p_operand.getImm(), m_real_constants.size()));
+  constexpr const char *const load_addr = "    la t6, .LC%zu\n";
+  dumpInstructions(m_output_file.get(), load_addr, inserted.first->second);
+}
+
+void IRCodeGenerator::loadAddress(const char *p_reg,
+                                  const IROperand &p_operand) {
+  if (p_operand.isSlot()) {
+    addImmediate(p_reg, "s0",
+                 -static_cast<int64_t>(m_slot_offsets[p_operand.getSlot()]));
+  } else if (p_operand.isGlobal()) {
+    constexpr const char *const load_addr = "    la %s, %s\n";
+    dumpInstructions(m_output_file.get(), load_addr, p_reg,
+                     p_operand.getSymbol().c_str());
+  } else {
+    // a pointer held in a virtual register
+    loadOperand(p_reg, p_operand);
+  }
+}
+
+const char *IRCodeGenerator::useOperand(const IROperand &p_operand,
+                                        const char *p_scratch) {
+  if (p_operand.isVReg() && m_allocator->getRegister(p_operand.getVReg())) {
+    return m_allocator->getRegister(p_operand.getVReg());
+  }
+  if (p_operand.isImm() && p_operand.getImm() == 0 && !isFloatReg(p_scratch)) {
+    return "zero";
+  }
+  loadOperand(p_scratch, p_operand);
+  return p_scratch;
+}
+
+// The address is p_offset past the pointer; an offset that does not fit
+// the instruction is added to the pointer in t1 instead.
+const char *IRCodeGenerator::useAddress(const IROperand &p_pointer,
+                                        int64_t &p_offset) {
+  const char *addr = useOperand(p_pointer, "t1");
+  if (fitsImm12(p_offset)) {
+    return addr;
+  }
+  addImmediate("t1", addr, p_offset);
+  p_offset = 0;
+  return "t1";
+}
+
+const char *IRCodeGenerator::defRegister(const IRInstruction &p_instruction) {
+  const char *reg = m_allocator->getRegister(p_instruction.getDst());
+  if (reg) {
+    return reg;
+  }
+  return p_instruction.getType() == IRType::kReal ? "ft0" : "t0";
+}
+
+void IRCodeGenerator::finishDef(const IRInstruction &p_instruction,
+                                const char *p_reg) {
+  if (m_allocator->isSpilled(p_instruction.getDst())) {
+    storeFrame(p_reg, m_spill_offsets[p_instruction.getDst()]);
+  }
+}
+
+// ra and the caller's s0 take the top 8 bytes, followed by the callee-saved
+// registers in use, the stack slots and the spilled virtual registers. The
+// floating-point ones take the size of a real.
+void IRCodeGenerator::layoutFrame(const IRFunction &p_function) {
+  const auto real_size = getRealSize(m_precision);
+  size_t offset = 8;
+  m_saved_reg_offsets.clear();
+  for (const char *reg : m_allocator->getUsedCalleeSaved()) {
+    const size_t size = isFloatReg(reg) ? real_size : 4;
+    offset = alignTo(offset + size, size);
+    m_saved_reg_offsets.push_back(offset);
+  }
+  m_slot_offsets.clear();
+  for (const auto &slot : p_function.getSlots()) {
+    offset = alignTo(offset + slot.size, slot.align);
+    m_slot_offsets.push_back(offset);
+  }
+  m_spill_offsets.assign(p_function.getNumVRegs(), 0);
+  for (size_t i = 0; i < p_function.getNumVRegs(); ++i) {
+    if (m_allocator->isSpilled(i)) {
+      const size_t size =
+          p_function.getVRegType(i) == IRType::kReal ? real_size : 4;
+      offset = alignTo(offset + size, size);
+      m_spill_offsets[i] = offset;
+    }
+  }
+  // a leaf function with nothing in the frame needs no frame at all
+  const bool is_empty = offset == 8;
+  m_frame_size = (m_is_leaf && is_empty) ? 0 : alignTo(offset, 16);
+}
+
+void IRCodeGenerator::genGlobals() {
+  const auto real_size = getRealSize(m_precision);
+  for (const auto &global : m_module.getGlobals()) {
+    if (global.is_constant) {
+      constexpr const char *const global_constant =
+          ".section    .rodata\n"
+          "    .align %d\n"
+          "    .globl %s\n"
+          "    .type %s, @object\n"
+          "%s:\n";
+      dumpInstructions(m_output_file.get(), global_constant,
+                       global.is_real && real_size == 8 ? 3 : 2,
+                       global.name.c_str(), global.name.c_str(),
+                       global.name.c_str());
+      if (global.is_real) {
+        double value = 0;
+        std::memcpy(&value, &global.init, sizeof(value));
+        uint32_t words[2];
+        getRealWords(m_precision, value, words);
+        constexpr const char *const real_word = "    .word %u\n";
+        for (size_t i = 0; i < real_size / 4; ++i) {
+          dumpInstructions(m_output_file.get(), real_word, words[i]);
+        }
+      } else if (!global.init_symbol.empty()) {
+        constexpr const char *const symbol_word = "    .word %s\n";
+        dumpInstructions(m_output_file.get(), symbol_word,
+                         global.init_symbol.c_str());
+      } else {
+        constexpr const char *const word = "    .word %ld\n";
+        dumpInstructions(m_output_file.get(), word, global.init);
+      }
+    } else {
+      constexpr const char *const global_variable = ".comm %s, %zu, %zu\n";
+      dumpInstructions(m_output_file.get(), global_variable,
+                       global.name.c_str(), global.size, global.align);
+    }
+  }
+}
+
+void IRCodeGenerator::genRealConstantPool() {
+  if (m_real_constants.empty()) {
+    return;
+  }
+  const auto real_size = getRealSize(m_precision);
+  constexpr const char *const pool =
+      ".section    .rodata\n"
+      "    .align %d\n";
+  dumpInstructions(m_output_file.get(), pool, real_size == 8 ? 3 : 2);
+  for (const auto &constant : m_real_constants) {
+    double value = 0;
+    std::memcpy(&value, &constant.first, sizeof(value));
+    uint32_t words[2];
+    getRealWords(m_precision, value, words);
+    constexpr const char *const label = ".LC%zu:\n";
+    dumpInstructions(m_output_file.get(), label, constant.second);
+    constexpr const char *const real_word = "    .word %u\n";
+    for (size_t i = 0; i < real_size / 4; ++i) {
+      dumpInstructions(m_output_file.get(), real_word, words[i]);
+    }
+  }
+}
+
+void IRCodeGenerator::genStringLiteralPool() {
+  if (m_module.getStrings().empty()) {
+    return;
+  }
+  constexpr const char *const pool = ".section    .rodata\n";
+  dumpInstructions(m_output_file.get(), pool);
+  for (const auto &string : m_module.getStrings()) {
+    genStringLiteral(m_output_file.get(),
+                     IRModule::getStringLabel(string.second), string.first);
+  }
+}
+
+void IRCodeGenerator::genFunction(const IRFunction &p_function) {
+  m_function = &p_function;
+  const auto &params = p_function.getParams();
+  std::vector<bool> is_real;
+  for (const auto param : params) {
+    is_real.push_back(p_function.getVRegType(param) == IRType::kReal);
+  }
+  m_param_layout = layoutArguments(is_real, m_precision);
+  m_allocator.reset(new RegisterAllocator(p_function, m_param_layout));
+  m_is_leaf = true;
+  for (const auto &block : p_function.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      m_is_leaf &= instruction->getOpcode() != IROpcode::kCall;
+    }
+  }
+  layoutFrame(p_function);
+
+  constexpr const char *const function_decl =
+      ".section    .text\n"
+      "    .globl %s\n"
+      "    .type %s, @function\n"
+      "%s:\n";
+  dumpInstructions(m_output_file.get(), function_decl,
+                   p_function.getNameCString(), p_function.getNameCString(),
+                   p_function.getNameCString());
+
+  constexpr const char *const comment = "    # function prologue\n";
+  dumpInstructions(m_output_file.get(), comment);
+  genPrologue();
+
+  // the allocator gives the used parameters distinct registers, none of them
+  // the argument register of another parameter, and unused ones none, so the
+  // parameters can be moved out of them in any order
+  for (size_t i = 0; i < params.size(); ++i) {
+    const char *reg = m_allocator->getRegister(params[i]);
+    if (!reg && !m_allocator->isSpilled(params[i])) {
+      continue;  // unused
+    }
+    const auto &location = m_param_layout.locations[i];
+    if (location.reg) {
+      if (reg && std::strcmp(reg, location.reg) == 0) {
+        continue;  // stays where it arrived
+      }
+      if (reg) {
+        constexpr const char *const move_arg = "    %s %s, %s\n";
+        dumpInstructions(m_output_file.get(), move_arg, getMoveMnemonic(reg),
+                         reg, location.reg);
+      } else {
+        storeFrame(location.reg, m_spill_offsets[params[i]]);
+      }
+      continue;
+    }
+    if (!reg) {
+      reg = is_real[i] ? "ft0" : "t0";
+    }
+    // without a frame, sp has not moved since the entry
+    constexpr const char *const load_arg = "    %s %s, %zu(%s)\n";
+    dumpInstructions(m_output_file.get(), load_arg, getLoadMnemonic(reg), reg,
+                     location.stack_offset, isFrameless() ? "sp" : "s0");
+    if (m_allocator->isSpilled(params[i])) {
+      storeFrame(reg, m_spill_offsets[params[i]]);
+    }
+  }
+
+  std::vector<size_t> use_counts(p_function.getNumVRegs(), 0);
+  for (const auto &block : p_function.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      for (const auto &operand : instruction->getOperands()) {
+        if (operand.isVReg()) {
+          ++use_counts[operand.getVReg()];
+        }
+      }
+    }
+  }
+
+  const auto &blocks = p_function.getBlocks();
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    const auto *next = (i + 1 < blocks.size()) ? blocks[i + 1].get() : nullptr;
+    constexpr const char *const block_label = ".L%s.bb%zu:\n";
+    dumpInstructions(m_output_file.get(), block_label,
+                     p_function.getNameCString(), blocks[i]->getId());
+    const auto &instructions = blocks[i]->getInstructions();
+    m_fused_compare = nullptr;
+    if (instructions.size() >= 2) {
+      const auto &terminator = *instructions.back();
+      const auto &compare = *instructions[instructions.size() - 2];
+      const auto &cond = terminator.getOperands().empty()
+                             ? IROperand()
+                             : terminator.getOperand(0);
+      if (terminator.getOpcode() == IROpcode::kCondBr && cond.isVReg() &&
+          compare.isComparison() && compare.getDst() == cond.getVReg() &&
+          use_counts[cond.getVReg()] == 1) {
+        m_fused_compare = &compare;
+      }
+    }
+    for (size_t j = 0; j < instructions.size(); ++j) {
+      if (instructions[j].get() == m_fused_compare) {
+        continue;
+      }
+      if (isTailCall(*blocks[i], j)) {
+        genTailCall(*instructions[j]);
+        break;
+      }
+      genInstruction(*instructions[j], next);
+    }
+  }
+  m_fused_compare = nullptr;
+
+  constexpr const char *const exit_label =
+      ".L%s.exit:\n"
+      "    # function epilogue\n";
+  dumpInstructions(m_output_file.get(), exit_label,
+                   p_function.getNameCString());
+  genEpilogue();
+  constexpr const char *const function_end =
+      "    jr ra\n"
+      "    .size %s, .-%s\n";
+  dumpInstructions(m_output_file.get(), function_end,
+                   p_function.getNameCString(), p_function.getNameCString());
+  m_function = nullptr;
+  m_allocator.reset();
+}
+
+bool IRCodeGenerator::isFrameless() const { return m_frame_size == 0; }
+
+void IRCodeGenerator::genPrologue() {
+  if (isFrameless()) {
+    return;
+  }
+  const auto frame_size = static_cast<int64_t>(m_frame_size);
+  addImmediate("sp", "sp", -frame_size);
+  // a leaf function keeps its return address in ra
+  if (fitsImm12(frame_size)) {
+    if (!m_is_leaf) {
+      constexpr const char *const save_ra = "    sw ra, %ld(sp)\n";
+      dumpInstructions(m_output_file.get(), save_ra, frame_size - 4);
+    }
+    constexpr const char *const set_fp =
+        "    sw s0, %ld(sp)\n"
+        "    addi s0, sp, %ld\n";
+    dumpInstructions(m_output_file.get(), set_fp, frame_size - 8, frame_size);
+  } else {
+    addImmediate("t6", "sp", frame_size);
+    if (!m_is_leaf) {
+      constexpr const char *const save_ra = "    sw ra, -4(t6)\n";
+      dumpInstructions(m_output_file.get(), save_ra);
+    }
+    constexpr const char *const set_fp =
+        "    sw s0, -8(t6)\n"
+        "    mv s0, t6\n";
+    dumpInstructions(m_output_file.get(), set_fp);
+  }
+
+  const auto &saved_regs = m_allocator->getUsedCalleeSaved();
+  for (size_t i = 0; i < saved_regs.size(); ++i) {
+    storeFrame(saved_regs[i], m_saved_reg_offsets[i]);
+  }
+}
+
+void IRCodeGenerator::genEpilogue() {
+  if (isFrameless()) {
+    return;
+  }
+  const auto frame_size = static_cast<int64_t>(m_frame_size);
+  const auto &saved_regs = m_allocator->getUsedCalleeSaved();
+  for (size_t i = 0; i < saved_regs.size(); ++i) {
+    loadFrame(saved_regs[i], m_saved_reg_offsets[i]);
+  }
+  if (fitsImm12(frame_size)) {
+    if (!m_is_leaf) {
+      constexpr const char *const restore_ra = "    lw ra, %ld(sp)\n";
+      dumpInstructions(m_output_file.get(), restore_ra, frame_size - 4);
+    }
+    constexpr const char *const epilogue =
+        "    lw s0, %ld(sp)\n"
+        "    addi sp, sp, %ld\n";
+    dumpInstructions(m_output_file.get(), epilogue, frame_size - 8,
+                     frame_size);
+  } else {
+    constexpr const char *const epilogue =
+        "    mv t6, s0\n"
+        "    lw s0, -8(t6)\n"
+        "    mv sp, t6\n";
+    if (!m_is_leaf) {
+      constexpr const char *const restore_ra = "    lw ra, -4(s0)\n";
+      dumpInstructions(m_output_file.get(), restore_ra);
+    }
+    dumpInstructions(m_output_file.get(), epilogue);
+  }
+}
+
+bool IRCodeGenerator::isTailCall(const IRBasicBlock &p_block,
+                                 const size_t p_index) const {
+  const auto &instructions = p_block.getInstructions();
+  const auto &call = *instructions[p_index];
+  if (call.getOpcode() != IROpcode::kCall ||
+      p_index + 2 != instructions.size()) {
+    return false;
+  }
+  // the callee finds its stack arguments where ours were, so they have to
+  // fit, and the result of the runtime would need converting afterwards
+  if (convertsAtCall(call) ||
+      layoutCall(call).stack_size > m_param_layout.stack_size) {
+    return false;
+  }
+  const auto &ret = *instructions.back();
+  if (ret.getOpcode() != IROpcode::kRet) {
+    return false;
+  }
+  if (ret.getOperands().empty()) {
+    return !call.hasDst();
+  }
+  return call.hasDst() && ret.getOperand(0) == IROperand::vreg(call.getDst());
+}
+
+bool IRCodeGenerator::isRealArgument(const IRInstruction &p_call,
+                                     const size_t p_index) const {
+  const auto callee = m_functions.find(p_call.getCallee());
+  if (callee == m_functions.end()) {
+    return isReal(p_call.getOperand(p_index));
+  }
+  const auto &function = *callee->second;
+  return function.getVRegType(function.getParams()[p_index]) == IRType::kReal;
+}
+
+ArgumentLayout IRCodeGenerator::layoutCall(const IRInstruction &p_call) const {
+  std::vector<bool> is_real;
+  for (size_t i = 0; i < p_call.getOperands().size(); ++i) {
+    is_real.push_back(isRealArgument(p_call, i));
+  }
+  return layoutArguments(is_real, m_precision);
+}
+
+bool IRCodeGenerator::convertsAtCall(const IRInstruction &p_call) const {
+  return m_precision == RealPrecision::kDouble &&
+         m_functions.find(p_call.getCallee()) == m_functions.end();
+}
+
+void IRCodeGenerator::genArguments(const IRInstruction &p_call,
+                                   const char *p_stack_args) {
+  const auto &args = p_call.getOperands();
+  const auto layout = layoutCall(p_call);
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (layout.locations[i].reg) {
+      continue;
+    }
+    const char *value =
+        useOperand(args[i], isRealArgument(p_call, i) ? "ft0" : "t0");
+    constexpr const char *const store_arg = "    %s %s, %zu(%s)\n";
+    dumpInstructions(m_output_file.get(), store_arg, getStoreMnemonic(value),
+                     value, layout.locations[i].stack_offset, p_stack_args);
+  }
+  for (size_t i = 0; i < args.size(); ++i) {
+    const char *reg = layout.locations[i].reg;
+    if (!reg) {
+      continue;
+    }
+    loadOperand(reg, args[i]);
+    if (isFloatReg(reg) && convertsAtCall(p_call)) {
+      constexpr const char *const to_single = "    fcvt.s.d %s, %s\n";
+      dumpInstructions(m_output_file.get(), to_single, reg, reg);
+    }
+  }
+}
+
+void IRCodeGenerator::genTailCall(const IRInstruction &p_call) {
+  // the incoming arguments are dead once the parameters are loaded
+  genArguments(p_call, "s0");
+  // the callee returns straight to our caller
+  genEpilogue();
+  constexpr const char *const tail_call = "    j %s\n";
+  dumpInstructions(m_output_file.get(), tail_call,
+                   p_call.getCallee().c_str());
+}
+
+void IRCodeGenerator::genCall(const IRInstruction &p_call) {
+  // sp stays aligned at calls for the sake of C callees
+  const auto args_size = alignTo(layoutCall(p_call).stack_size, 16);
+  if (args_size > 0) {
+    constexpr const char *const alloc_args = "    addi sp, sp, -%zu\n";
+    dumpInstructions(m_output_file.get(), alloc_args, args_size);
+  }
+  genArguments(p_call, "sp");
+
+  constexpr const char *const call_function = "    jal ra, %s\n";
+  dumpInstructions(m_output_file.get(), call_function,
+                   p_call.getCallee().c_str());
+  if (args_size > 0) {
+    constexpr const char *const free_args = "    addi sp, sp, %zu\n";
+    dumpInstructions(m_output_file.get(), free_args, args_size);
+  }
+  if (p_call.hasDst()) {
+    const bool is_real = p_call.getType() == IRType::kReal;
+    const char *ret_reg = is_real ? "fa0" : "a0";
+    if (is_real && convertsAtCall(p_call)) {
+      constexpr const char *const to_double = "    fcvt.d.s fa0, fa0\n";
+      dumpInstructions(m_output_file.get(), to_double);
+    }
+    if (m_allocator->isSpilled(p_call.getDst())) {
+      finishDef(p_call, ret_reg);
+    } else if (m_allocator->getRegister(p_call.getDst()) &&
+               std::strcmp(m_allocator->getRegister(p_call.getDst()),
+                           ret_reg) != 0) {
+      const char *dst = defRegister(p_call);
+      constexpr const char *const ret_val = "    %s %s, %s\n";
+      dumpInstructions(m_output_file.get(), ret_val, getMoveMnemonic(dst), dst,
+                       ret_reg);
+    }
+  }
+}
+
+void IRCodeGenerator::genTerminator(const IRInstruction &p_terminator,
+                                    const IRBasicBlock *p_next) {
+  const char *name = m_function->getNameCString();
+  switch (p_terminator.getOpcode()) {
+    case IROpcode::kBr:
+      if (p_terminator.getTarget(0) != p_next) {
+        constexpr const char *const jump = "    j .L%s.bb%zu\n";
+        dumpInstructions(m_output_file.get(), jump, name,
+                         p_terminator.getTarget(0)->getId());
+      }
+      break;
+    case IROpcode::kCondBr: {
+      const auto *then_block = p_terminator.getTarget(0);
+      const auto *else_block = p_terminator.getTarget(1);
+      if (m_fused_compare) {
+        genCompareAndBranch(*m_fused_compare, then_block, else_block, p_next);
+        break;
+      }
+      const char *cond = useOperand(p_terminator.getOperand(0), "t0");
+      if (then_block == p_next) {
+        constexpr const char *const branch = "    beqz %s, .L%s.bb%zu\n";
+        dumpInstructions(m_output_file.get(), branch, cond, name,
+                         else_block->getId());
+        break;
+      }
+      constexpr const char *const branch = "    bnez %s, .L%s.bb%zu\n";
+      dumpInstructions(m_output_file.get(), branch, cond, name,
+                       then_block->getId());
+      if (else_block != p_next) {
+        constexpr const char *const jump = "    j .L%s.bb%zu\n";
+        dumpInstructions(m_output_file.get(), jump, name, else_block->getId());
+      }
+      break;
+    }
+    case IROpcode::kRet:
+      if (!p_terminator.getOperands().empty()) {
+        loadOperand(
+            m_function->getReturnType() == IRType::kReal ? "fa0" : "a0",
+            p_terminator.getOperand(0));
+      }
+      if (p_next) {
+        constexpr const char *const jump = "    j .L%s.exit\n";
+        dumpInstructions(m_output_file.get(), jump, name);
+      }
+      break;
+    default:
+      assert(false && "Invalid terminator");
+  }
+}
+
+// Compare-and-branch taken when the comparison holds, or does not hold if
+// p_negate is set, with its operands swapped if p_swap is set.
+static const char *getBranchMnemonic(const IROpcode p_opcode,
+                                     const bool p_negate, bool &p_swap) {
+  p_swap = (p_opcode == IROpcode::kCmpGt || p_opcode == IROpcode::kCmpLe);
+  switch (p_opcode) {
+    case IROpcode::kCmpEq:
+      return p_negate ? "bne" : "beq";
+    case IROpcode::kCmpNe:
+      return p_negate ? "beq" : "bne";
+    case IROpcode::kCmpLt:
+    case IROpcode::kCmpGt:
+      return p_negate ? "bge" : "blt";
+    case IROpcode::kCmpGe:
+    case IROpcode::kCmpLe:
+      return p_negate ? "blt" : "bge";
+    default:
+      assert(false && "Invalid comparison");
+      return nullptr;
+  }
+}
+
+void IRCodeGenerator::genCompareAndBranch(const IRInstruction &p_compare,
+                                          const IRBasicBlock *p_then,
+                                          const IRBasicBlock *p_else,
+                                          const IRBasicBlock *p_next) {
+  const char *name = m_function->getNameCString();
+  // branch to whichever target does not follow
+  const bool negate = (p_then == p_next);
+  const auto *target = negate ? p_else : p_then;
+  if (isRealOperation(p_compare)) {
+    // reals have no compare-and-branch, only comparisons into an integer
+    genRealOperation(p_compare, "t0");
+    constexpr const char *const branch = "    %s t0, .L%s.bb%zu\n";
+    dumpInstructions(m_output_file.get(), branch, negate ? "beqz" : "bnez",
+                     name, target->getId());
+  } else {
+    const char *lhs = useOperand(p_compare.getOperand(0), "t0");
+    const char *rhs = useOperand(p_compare.getOperand(1), "t1");
+    bool swap = false;
+    const char *branch =
+        getBranchMnemonic(p_compare.getOpcode(), negate, swap);
+    constexpr const char *const compare_and_branch =
+        "    %s %s, %s, .L%s.bb%zu\n";
+    dumpInstructions(m_output_file.get(), compare_and_branch, branch,
+                     swap ? rhs : lhs, swap ? lhs : rhs, name,
+                     target->getId());
+  }
+  if (!negate && p_else != p_next) {
+    constexpr const char *const jump = "    j .L%s.bb%zu\n";
+    dumpInstructions(m_output_file.get(), jump, name, p_else->getId());
+  }
+}
+
+void IRCodeGenerator::genInstruction(const IRInstruction &p_instruction,
+                                     const IRBasicBlock *p_next) {
+  if (p_instruction.isTerminator()) {
+    genTerminator(p_instruction, p_next);
+    return;
+  }
+
+  const auto &operands = p_instruction.getOperands();
+  switch (p_instruction.getOpcode()) {
+    case IROpcode::kCall:
+      genCall(p_instruction);
+      return;
+    case IROpcode::kStore: {
+      const char *value = useOperand(
+          operands[0], p_instruction.getType() == IRType::kReal ? "ft0" : "t0");
+      if (operands[1].isSlot()) {
+        storeFrame(value, m_slot_offsets[operands[1].getSlot()]);
+      } else {
+        int64_t offset = operands.size() > 2 ? operands[2].getImm() : 0;
+        const char *addr = useAddress(operands[1], offset);
+        constexpr const char *const store = "    %s %s, %ld(%s)\n";
+        dumpInstructions(m_output_file.get(), store, getStoreMnemonic(value),
+                         value, offset, addr);
+      }
+      return;
+    }
+    case IROpcode::kPhi:
+      assert(false && "Phi must be eliminated before code generation");
+      return;
+    default:
+      break;
+  }
+
+  if (!m_allocator->getRegister(p_instruction.getDst()) &&
+      !m_allocator->isSpilled(p_instruction.getDst())) {
+    return;  // the result is never used
+  }
+  const char *dst = defRegister(p_instruction);
+  switch (p_instruction.getOpcode()) {
+    case IROpcode::kLoad:
+      if (operands[0].isSlot()) {
+        loadFrame(dst, m_slot_offsets[operands[0].getSlot()]);
+      } else {
+        int64_t offset = operands.size() > 1 ? operands[1].getImm() : 0;
+        const char *addr = useAddress(operands[0], offset);
+        constexpr const char *const load = "    %s %s, %ld(%s)\n";
+        dumpInstructions(m_output_file.get(), load, getLoadMnemonic(dst), dst,
+                         offset, addr);
+      }
+      break;
+    case IROpcode::kAddr:
+    case IROpcode::kCopy:
+      loadOperand(dst, operands[0]);
+      break;
+    case IROpcode::kNeg: {
+      if (p_instruction.getType() == IRType::kReal) {
+        constexpr const char *const neg = "    fneg.%s %s, %s\n";
+        dumpInstructions(m_output_file.get(), neg, getRealSuffix(m_precision),
+                         dst, useOperand(operands[0], "ft0"));
+        break;
+      }
+      constexpr const char *const neg = "    neg %s, %s\n";
+      dumpInstructions(m_output_file.get(), neg, dst,
+                       useOperand(operands[0], "t0"));
+      break;
+    }
+    case IROpcode::kIntToReal: {
+      constexpr const char *const to_real = "    fcvt.%s.w %s, %s\n";
+      dumpInstructions(m_output_file.get(), to_real,
+                       getRealSuffix(m_precision), dst,
+                       useOperand(operands[0], "t0"));
+      break;
+    }
+    case IROpcode::kRealToInt: {
+      // truncated toward zero like an integer division
+      constexpr const char *const to_int = "    fcvt.w.%s %s, %s, rtz\n";
+      dumpInstructions(m_output_file.get(), to_int, getRealSuffix(m_precision),
+                       dst, useOperand(operands[0], "ft0"));
+      break;
+    }
+    case IROpcode::kNot: {
+      constexpr const char *const not_op = "    seqz %s, %s\n";
+      dumpInstructions(m_output_file.get(), not_op, dst,
+                       useOperand(operands[0], "t0"));
+      break;
+    }
+    default: {
+      assert(p_instruction.isBinary() && "Invalid instruction");
+      if (isRealOperation(p_instruction)) {
+        genRealOperation(p_instruction, dst);
+        break;
+      }
+      const char *lhs = useOperand(operands[0], "t0");
+      if (operands[1].isImm() &&
+          genByConstant(p_instruction.getOpcode(), dst, lhs,
+                        operands[1].getImm())) {
+        break;
+      }
+      const char *rhs = useOperand(operands[1], "t1");
+      genBinary(p_instruction.getOpcode(), dst, lhs, rhs);
+      break;
+    }
+  }
+  finishDef(p_instruction, dst);
+}
+
+// t1 and t6 are never handed out by the register allocator
+bool IRCodeGenerator::genByConstant(const IROpcode p_opcode, const char *p_dst,
+                                    const char *p_lhs, const int64_t p_imm) {
+  switch (p_opcode) {
+    case IROpcode::kAdd:
+      if (!fitsImm12(p_imm)) {
+        return false;
+      }
+      addImmediate(p_dst, p_lhs, p_imm);
+      return true;
+    case IROpcode::kSub:
+      if (!fitsImm12(-p_imm)) {
+        return false;
+      }
+      addImmediate(p_dst, p_lhs, -p_imm);
+      return true;
+    case IROpcode::kMul:
+      return genMulByConstant(m_output_file.get(), p_dst, p_lhs, p_imm, "t1");
+    case IROpcode::kDiv:
+      return genDivByConstant(m_output_file.get(), p_dst, p_lhs, p_imm, "t1");
+    case IROpcode::kRem:
+      return genRemByConstant(m_output_file.get(), p_dst, p_lhs, p_imm, "t1",
+                              "t6");
+    default:
+      return false;
+  }
+}
+
+void IRCodeGenerator::genBinary(const IROpcode p_opcode, const char *p_dst,
+                                const char *p_lhs, const char *p_rhs) {
+  switch (p_opcode) {
+    case IROpcode::kAdd: {
+      constexpr const char *const add = "    add %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), add, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kSub: {
+      constexpr const char *const sub = "    sub %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), sub, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kMul: {
+      constexpr const char *const mul = "    mul %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), mul, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kDiv: {
+      constexpr const char *const div = "    div %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), div, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kRem: {
+      constexpr const char *const rem = "    rem %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), rem, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kAnd: {
+      constexpr const char *const and_op = "    and %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), and_op, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kOr: {
+      constexpr const char *const or_op = "    or %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), or_op, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kCmpEq: {
+      constexpr const char *const equal =
+          "    xor %s, %s, %s\n"
+          "    seqz %s, %s\n";
+      dumpInstructions(m_output_file.get(), equal, p_dst, p_lhs, p_rhs, p_dst,
+                       p_dst);
+      break;
+    }
+    case IROpcode::kCmpNe: {
+      constexpr const char *const not_equal =
+          "    xor %s, %s, %s\n"
+          "    snez %s, %s\n";
+      dumpInstructions(m_output_file.get(), not_equal, p_dst, p_lhs, p_rhs,
+                       p_dst, p_dst);
+      break;
+    }
+    case IROpcode::kCmpLt: {
+      constexpr const char *const less = "    slt %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), less, p_dst, p_lhs, p_rhs);
+      break;
+    }
+    case IROpcode::kCmpLe: {
+      constexpr const char *const less_or_equal =
+          "    slt %s, %s, %s\n"
+          "    xori %s, %s, 1\n";
+      dumpInstructions(m_output_file.get(), less_or_equal, p_dst, p_rhs, p_lhs,
+                       p_dst, p_dst);
+      break;
+    }
+    case IROpcode::kCmpGt: {
+      constexpr const char *const greater = "    slt %s, %s, %s\n";
+      dumpInstructions(m_output_file.get(), greater, p_dst, p_rhs, p_lhs);
+      break;
+    }
+    case IROpcode::kCmpGe: {
+      constexpr const char *const greater_or_equal =
+          "    slt %s, %s, %s\n"
+          "    xori %s, %s, 1\n";
+      dumpInstructions(m_output_file.get(), greater_or_equal, p_dst, p_lhs,
+                       p_rhs, p_dst, p_dst);
+      break;
+    }
+    default:
+      assert(false && "Invalid binary instruction");
+  }
+}
+
+bool IRCodeGenerator::isReal(const IROperand &p_operand) const {
+  return p_operand.isReal() ||
+         (p_operand.isVReg() &&
+          m_function->getVRegType(p_operand.getVReg()) == IRType::kReal);
+}
+
+bool IRCodeGenerator::isRealOperation(
+    const IRInstruction &p_instruction) const {
+  return p_instruction.getType() == IRType::kReal ||
+         isReal(p_instruction.getOperand(0)) ||
+         isReal(p_instruction.getOperand(1));
+}
+
+// ft0 and ft1 are never handed out by the register allocator
+void IRCodeGenerator::genRealOperation(const IRInstruction &p_instruction,
+                                       const char *p_dst) {
+  const char *suffix = getRealSuffix(m_precision);
+  const char *lhs = useOperand(p_instruction.getOperand(0), "ft0");
+  const char *rhs = useOperand(p_instruction.getOperand(1), "ft1");
+  const char *mnemonic = nullptr;
+  bool swap = false;
+  switch (p_instruction.getOpcode()) {
+    case IROpcode::kAdd:
+      mnemonic = "fadd";
+      break;
+    case IROpcode::kSub:
+      mnemonic = "fsub";
+      break;
+    case IROpcode::kMul:
+      mnemonic = "fmul";
+      break;
+    case IROpcode::kDiv:
+      mnemonic = "fdiv";
+      break;
+    case IROpcode::kCmpEq:
+    case IROpcode::kCmpNe:
+      mnemonic = "feq";
+      break;
+    case IROpcode::kCmpLt:
+      mnemonic = "flt";
+      break;
+    case IROpcode::kCmpLe:
+      mnemonic = "fle";
+      break;
+    case IROpcode::kCmpGt:
+      mnemonic = "flt";
+      swap = true;
+      break;
+    case IROpcode::kCmpGe:
+      mnemonic = "fle";
+      swap = true;
+      break;
+    default:
+      assert(false && "Invalid real instruction");
+  }
+  constexpr const char *const real_op = "    %s.%s %s, %s, %s\n";
+  dumpInstructions(m_output_file.get(), real_op, mnemonic, suffix, p_dst,
+                   swap ? rhs : lhs, swap ? lhs : rhs);
+  if (p_instruction.getOpcode() == IROpcode::kCmpNe) {
+    constexpr const char *const negate = "    xori %s, %s, 1\n";
+    dumpInstructions(m_output_file.get(), negate, p_dst, p_dst);
+  }
+}
+
+void IRCodeGenerator::generate() {
+  constexpr const char *const riscv_assembly_file_prologue =
+      "    .file \"%s\"\n"
+      "    .option nopic\n";
+  dumpInstructions(m_output_file.get(), riscv_assembly_file_prologue,
+                   m_module.getSourceFile().c_str());
+
+  genGlobals();
+  for (const auto &function : m_module.getFunctions()) {
+    genFunction(*function);
+  }
+  genRealConstantPool();
+  genStringLiteralPool();
+
+  constexpr const char *const riscv_assembly_file_epilogue =
+      ".section    .note.GNU-stack,\"\",@progbits\n";
+  dumpInstructions(m_output_file.get(), riscv_assembly_file_epilogue);
+}
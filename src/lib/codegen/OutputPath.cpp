@@ -0,0 +1,19 @@
+#include "codegen/OutputPath.hpp"
+
+std::string getOutputFilePath(const std::string &p_source_file_name,
+                              const std::string &p_save_path,
+                              const char *p_extension) {
+  // FIXME: assume that the source file is always xxxx.p
+  const auto &real_path = p_save_path.empty() ? std::string{"."} : p_save_path;
+  auto slash_pos = p_source_file_name.rfind("/");
+  auto dot_pos = p_source_file_name.rfind(".");
+
+  if (slash_pos != std::string::npos) {
+    ++slash_pos;
+  } else {
+    slash_pos = 0;
+  }
+  return real_path + "/" +
+         p_source_file_name.substr(slash_pos, dot_pos - slash_pos) +
+         p_extension;
+}
@@ -0,0 +1,17 @@
+#include "codegen/RealPrecision.hpp"
+
+#include <cstring>
+
+void getRealWords(const RealPrecision p_precision, const double p_value,
+                  uint32_t (&p_words)[2]) {
+  if (p_precision == RealPrecision::kSingle) {
+    const auto value = static_cast<float>(p_value);
+    std::memcpy(&p_words[0], &value, sizeof(value));
+    p_words[1] = 0;
+    return;
+  }
+  uint64_t bits = 0;
+  std::memcpy(&bits, &p_value, sizeof(bits));
+  p_words[0] = static_cast<uint32_t>(bits);
+  p_words[1] = static_cast<uint32_t>(bits >> 32);
+}
@@ -0,0 +1,310 @@
+#include "codegen/RegisterAllocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "ir/Dominators.hpp"
+#include "ir/LoopInfo.hpp"
+
+// t0, t1, t6, ft0 and ft1 are kept free as scratch registers of the code
+// generator
+static constexpr const char *const kRegisters[] = {
+    // integers: temporaries, arguments, callee-saved; the caller-saved ones
+    // come first so that leaf functions need not save any
+    "t2", "t3", "t4", "t5", "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7",
+    "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11",
+    // reals, likewise
+    "ft2", "ft3", "ft4", "ft5", "ft6", "ft7", "ft8", "ft9", "ft10", "ft11",
+    "fa0", "fa1", "fa2", "fa3", "fa4", "fa5", "fa6", "fa7", "fs0", "fs1",
+    "fs2", "fs3", "fs4", "fs5", "fs6", "fs7", "fs8", "fs9", "fs10", "fs11"};
+static constexpr size_t kNumRegisters =
+    sizeof(kRegisters) / sizeof(kRegisters[0]);
+
+// a range of kRegisters: the argument registers from first_argument on, the
+// callee-saved ones from first_callee_saved on
+struct RegisterClass {
+  size_t first;
+  size_t first_argument;
+  size_t first_callee_saved;
+  size_t end;
+};
+static constexpr RegisterClass kIntRegisters{0, 4, 12, 23};
+static constexpr RegisterClass kRealRegisters{23, 33, 41, kNumRegisters};
+
+static constexpr size_t kNone = static_cast<size_t>(-1);
+
+// the index into kRegisters, or kNone for nullptr
+static size_t findRegister(const char *p_reg) {
+  for (size_t r = 0; p_reg && r < kNumRegisters; ++r) {
+    if (std::strcmp(kRegisters[r], p_reg) == 0) {
+      return r;
+    }
+  }
+  return kNone;
+}
+
+RegisterAllocator::RegisterAllocator(const IRFunction &p_function,
+                                     const ArgumentLayout &p_param_layout)
+    : m_function(p_function),
+      m_param_layout(p_param_layout),
+      m_registers(p_function.getNumVRegs(), nullptr),
+      m_spilled(p_function.getNumVRegs(), false) {
+  buildIntervals();
+  allocate();
+}
+
+void RegisterAllocator::buildIntervals() {
+  const auto num_vregs = m_function.getNumVRegs();
+  const auto num_block_ids = m_function.getNumBlockIds();
+
+  // number the instructions in layout order, leaving 0 for the parameters
+  std::vector<size_t> block_start(num_block_ids), block_end(num_block_ids);
+  std::vector<size_t> call_positions;
+  size_t pos = 0;
+  for (const auto &block : m_function.getBlocks()) {
+    block_start[block->getId()] = pos + 2;
+    for (const auto &instruction : block->getInstructions()) {
+      pos += 2;
+      if (instruction->getOpcode() == IROpcode::kCall) {
+        call_positions.push_back(pos);
+      }
+    }
+    block_end[block->getId()] = pos;
+  }
+
+  // live variables, iterated backwards to a fixed point
+  std::vector<std::vector<bool>> live_in(num_block_ids), live_out(
+                                                             num_block_ids);
+  std::vector<std::vector<bool>> uses(num_block_ids), defs(num_block_ids);
+  for (const auto &block : m_function.getBlocks()) {
+    auto &block_uses = uses[block->getId()];
+    auto &block_defs = defs[block->getId()];
+    block_uses.assign(num_vregs, false);
+    block_defs.assign(num_vregs, false);
+    live_in[block->getId()].assign(num_vregs, false);
+    live_out[block->getId()].assign(num_vregs, false);
+    for (const auto &instruction : block->getInstructions()) {
+      for (const auto &operand : instruction->getOperands()) {
+        if (operand.isVReg() && !block_defs[operand.getVReg()]) {
+          block_uses[operand.getVReg()] = true;
+        }
+      }
+      if (instruction->hasDst()) {
+        block_defs[instruction->getDst()] = true;
+      }
+    }
+  }
+  const auto &blocks = m_function.getBlocks();
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+      const auto id = (*it)->getId();
+      auto &out = live_out[id];
+      for (const auto *succ : (*it)->getSuccessors()) {
+        const auto &succ_in = live_in[succ->getId()];
+        for (size_t v = 0; v < num_vregs; ++v) {
+          out[v] = out[v] || succ_in[v];
+        }
+      }
+      auto &in = live_in[id];
+      for (size_t v = 0; v < num_vregs; ++v) {
+        const bool new_in = uses[id][v] || (out[v] && !defs[id][v]);
+        if (new_in != in[v]) {
+          in[v] = new_in;
+          changed = true;
+        }
+      }
+    }
+  }
+
+  std::vector<Interval> intervals(num_vregs);
+  for (size_t v = 0; v < num_vregs; ++v) {
+    intervals[v].vreg = v;
+    intervals[v].start = kNone;
+    intervals[v].end = 0;
+  }
+  auto extend = [&](const size_t p_vreg, const size_t p_pos) {
+    auto &interval = intervals[p_vreg];
+    interval.start = std::min(interval.start, p_pos);
+    interval.end = std::max(interval.end, p_pos);
+  };
+  DominatorTree dom_tree(m_function);
+  LoopInfo loop_info(m_function, dom_tree);
+  pos = 0;
+  for (const auto &block : blocks) {
+    const auto id = block->getId();
+    for (size_t v = 0; v < num_vregs; ++v) {
+      if (live_in[id][v]) {
+        extend(v, block_start[id]);
+      }
+      if (live_out[id][v]) {
+        extend(v, block_end[id]);
+      }
+    }
+    const double weight = std::pow(10.0, loop_info.getLoopDepth(block.get()));
+    for (const auto &instruction : block->getInstructions()) {
+      pos += 2;
+      for (const auto &operand : instruction->getOperands()) {
+        if (operand.isVReg()) {
+          extend(operand.getVReg(), pos);
+          intervals[operand.getVReg()].spill_cost += weight;
+        }
+      }
+      if (instruction->hasDst()) {
+        extend(instruction->getDst(), pos);
+        intervals[instruction->getDst()].spill_cost += weight;
+        const auto &source = instruction->getOperands();
+        if (instruction->getOpcode() == IROpcode::kCopy &&
+            source[0].isVReg()) {
+          intervals[instruction->getDst()].hint_vreg = source[0].getVReg();
+        } else if (instruction->getOpcode() == IROpcode::kCall) {
+          intervals[instruction->getDst()].arg_reg =
+              instruction->getType() == IRType::kReal ? "fa0" : "a0";
+        }
+      }
+    }
+  }
+
+  // The parameters arrive together at the entry, so the used ones all start
+  // there and overlap each other. Unused ones get neither an interval nor a
+  // register, or moving them out of their argument registers could clobber
+  // a used one sharing theirs.
+  const auto &params = m_function.getParams();
+  for (size_t i = 0; i < params.size(); ++i) {
+    auto &interval = intervals[params[i]];
+    if (interval.start != kNone) {
+      interval.start = 0;
+      interval.is_param = true;
+      interval.arg_reg = m_param_layout.locations[i].reg;
+    }
+  }
+
+  for (auto &interval : intervals) {
+    if (interval.start == kNone) {
+      continue;  // never used
+    }
+    // a value that is still needed after a call must survive it
+    const auto call = std::upper_bound(call_positions.begin(),
+                                       call_positions.end(), interval.start);
+    interval.crosses_call = call != call_positions.end() && *call < interval.end;
+    interval.reaches_call =
+        call != call_positions.end() && *call <= interval.end;
+    m_intervals.push_back(interval);
+  }
+  std::stable_sort(m_intervals.begin(), m_intervals.end(),
+                   [](const Interval &p_lhs, const Interval &p_rhs) {
+                     return p_lhs.start < p_rhs.start;
+                   });
+}
+
+void RegisterAllocator::allocate() {
+  std::vector<size_t> owners(kNumRegisters, kNone);
+  std::vector<size_t> assigned(m_function.getNumVRegs(), kNone);
+  std::vector<bool> used(kNumRegisters, false);
+  // indices into m_intervals of the intervals holding a register
+  std::vector<size_t> active;
+
+  auto weight = [&](const Interval &p_interval) {
+    return p_interval.spill_cost / (p_interval.end - p_interval.start + 1);
+  };
+  auto assign = [&](const size_t p_interval_idx, const size_t p_reg) {
+    const auto vreg = m_intervals[p_interval_idx].vreg;
+    owners[p_reg] = p_interval_idx;
+    assigned[vreg] = p_reg;
+    used[p_reg] = true;
+    active.push_back(p_interval_idx);
+  };
+
+  for (size_t idx = 0; idx < m_intervals.size(); ++idx) {
+    const auto &current = m_intervals[idx];
+
+    // intervals ending where this one starts give their register up: the
+    // instruction reads its operands before it writes its result
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [&](const size_t p_active) {
+                                  if (m_intervals[p_active].end >
+                                      current.start) {
+                                    return false;
+                                  }
+                                  owners[assigned[m_intervals[p_active].vreg]] =
+                                      kNone;
+                                  return true;
+                                }),
+                 active.end());
+
+    const auto &reg_class = m_function.getVRegType(current.vreg) == IRType::kReal
+                                ? kRealRegisters
+                                : kIntRegisters;
+    const size_t first_reg = current.crosses_call
+                                 ? reg_class.first_callee_saved
+                                 : reg_class.first;
+    const size_t arg_reg = findRegister(current.arg_reg);
+    auto is_allowed = [&](const size_t p_reg) {
+      if (p_reg == kNone || p_reg < first_reg || p_reg >= reg_class.end) {
+        return false;
+      }
+      if (p_reg < reg_class.first_argument ||
+          p_reg >= reg_class.first_callee_saved) {
+        return true;
+      }
+      // the parameters are moved out of the argument registers in any order
+      // at the entry, so each may only stay where it arrived
+      return !current.reaches_call && (!current.is_param || p_reg == arg_reg);
+    };
+    auto is_free = [&](const size_t p_reg) {
+      return is_allowed(p_reg) && owners[p_reg] == kNone;
+    };
+
+    size_t reg = kNone;
+    if (current.hint_vreg != kNone && is_free(assigned[current.hint_vreg])) {
+      reg = assigned[current.hint_vreg];
+    } else if (is_free(arg_reg)) {
+      reg = arg_reg;
+    }
+    for (size_t r = first_reg; reg == kNone && r < reg_class.end; ++r) {
+      if (is_free(r)) {
+        reg = r;
+      }
+    }
+    if (reg != kNone) {
+      assign(idx, reg);
+      continue;
+    }
+
+    // out of registers: spill whichever interval is cheapest to keep in memory
+    size_t victim = kNone;
+    for (const auto a : active) {
+      if (!is_allowed(assigned[m_intervals[a].vreg])) {
+        continue;
+      }
+      if (victim == kNone || weight(m_intervals[a]) < weight(m_intervals[victim])) {
+        victim = a;
+      }
+    }
+    if (victim == kNone || weight(current) <= weight(m_intervals[victim])) {
+      m_spilled[current.vreg] = true;
+      continue;
+    }
+    const auto victim_vreg = m_intervals[victim].vreg;
+    reg = assigned[victim_vreg];
+    assigned[victim_vreg] = kNone;
+    m_spilled[victim_vreg] = true;
+    active.erase(std::find(active.begin(), active.end(), victim));
+    assign(idx, reg);
+  }
+
+  for (size_t v = 0; v < assigned.size(); ++v) {
+    if (assigned[v] != kNone) {
+      m_registers[v] = kRegisters[assigned[v]];
+    }
+  }
+  for (const auto *reg_class : {&kIntRegisters, &kRealRegisters}) {
+    for (size_t r = reg_class->first_callee_saved; r < reg_class->end; ++r) {
+      if (used[r]) {
+        m_used_callee_saved.push_back(kRegisters[r]);
+      }
+    }
+  }
+}
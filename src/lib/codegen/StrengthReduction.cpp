@@ -0,0 +1,266 @@
+#include "codegen/StrengthReduction.hpp"
+
+#include <cstdarg>
+#include <limits>
+
+static void dumpInstructions(FILE *p_out_file, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  vfprintf(p_out_file, format, args);
+  va_end(args);
+}
+
+static bool isInt32(const int64_t p_imm) {
+  return p_imm >= std::numeric_limits<int32_t>::min() &&
+         p_imm <= std::numeric_limits<int32_t>::max();
+}
+
+// k if p_value is 2^k, -1 otherwise
+static int exactLog2(const uint32_t p_value) {
+  if (p_value == 0 || (p_value & (p_value - 1)) != 0) {
+    return -1;
+  }
+  int log = 0;
+  while ((p_value >> log) != 1) {
+    ++log;
+  }
+  return log;
+}
+
+bool genMulByConstant(FILE *p_out, const char *p_dst, const char *p_src,
+                      const int64_t p_imm, const char *p_scratch) {
+  if (!isInt32(p_imm)) {
+    return false;
+  }
+  if (p_imm == 0) {
+    constexpr const char *const zero = "    li %s, 0\n";
+    dumpInstructions(p_out, zero, p_dst);
+    return true;
+  }
+  if (p_imm == std::numeric_limits<int32_t>::min()) {
+    // -x * 2^31 and x * 2^31 agree modulo 2^32
+    constexpr const char *const shift = "    slli %s, %s, 31\n";
+    dumpInstructions(p_out, shift, p_dst, p_src);
+    return true;
+  }
+
+  const bool negate = p_imm < 0;
+  const auto multiplier = static_cast<uint32_t>(negate ? -p_imm : p_imm);
+  const int shift = exactLog2(multiplier);
+  const int shift_minus = exactLog2(multiplier + 1);
+  const int shift_plus = exactLog2(multiplier - 1);
+  if (shift == 0) {
+    constexpr const char *const move = "    mv %s, %s\n";
+    dumpInstructions(p_out, move, p_dst, p_src);
+  } else if (shift > 0) {
+    constexpr const char *const shift_left = "    slli %s, %s, %d\n";
+    dumpInstructions(p_out, shift_left, p_dst, p_src, shift);
+  } else if (shift_plus > 0) {
+    // x * (2^k + 1) = (x << k) + x
+    constexpr const char *const shift_add =
+        "    slli %s, %s, %d\n"
+        "    add %s, %s, %s\n";
+    dumpInstructions(p_out, shift_add, p_scratch, p_src, shift_plus, p_dst,
+                     p_scratch, p_src);
+  } else if (shift_minus > 0 && negate) {
+    // x * (1 - 2^k) = x - (x << k), which needs no negation at the end
+    constexpr const char *const shift_sub =
+        "    slli %s, %s, %d\n"
+        "    sub %s, %s, %s\n";
+    dumpInstructions(p_out, shift_sub, p_scratch, p_src, shift_minus, p_dst,
+                     p_src, p_scratch);
+    return true;
+  } else if (shift_minus > 0) {
+    // x * (2^k - 1) = (x << k) - x
+    constexpr const char *const shift_sub =
+        "    slli %s, %s, %d\n"
+        "    sub %s, %s, %s\n";
+    dumpInstructions(p_out, shift_sub, p_scratch, p_src, shift_minus, p_dst,
+                     p_scratch, p_src);
+  } else {
+    // x * (2^a + 2^b) = (x << a) + (x << b), only if no negation follows so
+    // that the sequence stays within three instructions
+    const int low = exactLog2(multiplier & -multiplier);
+    const int high = exactLog2(multiplier & ~(1u << low));
+    if (negate || high < 0) {
+      return false;
+    }
+    constexpr const char *const shift_shift_add =
+        "    slli %s, %s, %d\n"
+        "    slli %s, %s, %d\n"
+        "    add %s, %s, %s\n";
+    dumpInstructions(p_out, shift_shift_add, p_scratch, p_src, high, p_dst,
+                     p_src, low, p_dst, p_scratch, p_dst);
+  }
+  if (negate) {
+    constexpr const char *const neg = "    neg %s, %s\n";
+    dumpInstructions(p_out, neg, p_dst, p_dst);
+  }
+  return true;
+}
+
+// p_dst = p_src + (p_src < 0 ? 2^k - 1 : 0), so that an arithmetic shift
+// right by k rounds toward zero rather than toward negative infinity
+static void genRoundingBias(FILE *p_out, const char *p_dst, const char *p_src,
+                            const int p_shift) {
+  if (p_shift == 1) {
+    constexpr const char *const sign_bit =
+        "    srli %s, %s, 31\n"
+        "    add %s, %s, %s\n";
+    dumpInstructions(p_out, sign_bit, p_dst, p_src, p_dst, p_dst, p_src);
+    return;
+  }
+  constexpr const char *const low_bits =
+      "    srai %s, %s, 31\n"
+      "    srli %s, %s, %d\n"
+      "    add %s, %s, %s\n";
+  dumpInstructions(p_out, low_bits, p_dst, p_src, p_dst, p_dst, 32 - p_shift,
+                   p_dst, p_dst, p_src);
+}
+
+// Magic number M and shift s of a divisor with 2 <= |d| < 2^31 that is not a
+// power of two: x / d = mulh(x, M) [+/- x] >> s, plus one if that is negative.
+// See Hacker's Delight, section 10-4.
+static void computeMagic(const int32_t p_divisor, int32_t &p_magic,
+                         int &p_shift) {
+  const uint32_t two31 = 0x80000000u;
+  const uint32_t abs_divisor = p_divisor < 0
+                                   ? 0u - static_cast<uint32_t>(p_divisor)
+                                   : static_cast<uint32_t>(p_divisor);
+  const uint32_t t = two31 + (static_cast<uint32_t>(p_divisor) >> 31);
+  const uint32_t abs_nc = t - 1 - t % abs_divisor;
+  int p = 31;
+  uint32_t q1 = two31 / abs_nc;
+  uint32_t r1 = two31 - q1 * abs_nc;
+  uint32_t q2 = two31 / abs_divisor;
+  uint32_t r2 = two31 - q2 * abs_divisor;
+  uint32_t delta = 0;
+  do {
+    ++p;
+    q1 *= 2;
+    r1 *= 2;
+    if (r1 >= abs_nc) {
+      ++q1;
+      r1 -= abs_nc;
+    }
+    q2 *= 2;
+    r2 *= 2;
+    if (r2 >= abs_divisor) {
+      ++q2;
+      r2 -= abs_divisor;
+    }
+    delta = abs_divisor - r2;
+  } while (q1 < delta || (q1 == delta && r1 == 0));
+  const uint32_t magic = q2 + 1;
+  p_magic = static_cast<int32_t>(p_divisor < 0 ? 0u - magic : magic);
+  p_shift = p - 32;
+}
+
+// p_dst = p_src / p_divisor but for the final correction, which adds the
+// sign bit of p_dst
+static void genMagicQuotient(FILE *p_out, const char *p_dst, const char *p_src,
+                             const int32_t p_divisor) {
+  int32_t magic = 0;
+  int shift = 0;
+  computeMagic(p_divisor, magic, shift);
+  constexpr const char *const mul_high =
+      "    li %s, %d\n"
+      "    mulh %s, %s, %s\n";
+  dumpInstructions(p_out, mul_high, p_dst, magic, p_dst, p_src, p_dst);
+  if (p_divisor > 0 && magic < 0) {
+    constexpr const char *const add = "    add %s, %s, %s\n";
+    dumpInstructions(p_out, add, p_dst, p_dst, p_src);
+  } else if (p_divisor < 0 && magic > 0) {
+    constexpr const char *const sub = "    sub %s, %s, %s\n";
+    dumpInstructions(p_out, sub, p_dst, p_dst, p_src);
+  }
+  if (shift > 0) {
+    constexpr const char *const shift_right = "    srai %s, %s, %d\n";
+    dumpInstructions(p_out, shift_right, p_dst, p_dst, shift);
+  }
+}
+
+bool genDivByConstant(FILE *p_out, const char *p_dst, const char *p_src,
+                      const int64_t p_imm, const char *p_scratch) {
+  // division by zero keeps its defined result, and only INT_MIN itself
+  // divides by INT_MIN
+  if (!isInt32(p_imm) || p_imm == 0 ||
+      p_imm == std::numeric_limits<int32_t>::min()) {
+    return false;
+  }
+  const auto divisor = static_cast<int32_t>(p_imm);
+  if (divisor == 1 || divisor == -1) {
+    constexpr const char *const move = "    %s %s, %s\n";
+    dumpInstructions(p_out, move, divisor == 1 ? "mv" : "neg", p_dst, p_src);
+    return true;
+  }
+
+  const int shift = exactLog2(divisor < 0 ? -divisor : divisor);
+  if (shift > 0) {
+    genRoundingBias(p_out, p_scratch, p_src, shift);
+    constexpr const char *const shift_right = "    srai %s, %s, %d\n";
+    dumpInstructions(p_out, shift_right, p_dst, p_scratch, shift);
+    if (divisor < 0) {
+      constexpr const char *const neg = "    neg %s, %s\n";
+      dumpInstructions(p_out, neg, p_dst, p_dst);
+    }
+    return true;
+  }
+
+  genMagicQuotient(p_out, p_scratch, p_src, divisor);
+  constexpr const char *const round_toward_zero =
+      "    srli %s, %s, 31\n"
+      "    add %s, %s, %s\n";
+  dumpInstructions(p_out, round_toward_zero, p_dst, p_scratch, p_dst, p_dst,
+                   p_scratch);
+  return true;
+}
+
+bool genRemByConstant(FILE *p_out, const char *p_dst, const char *p_src,
+                      const int64_t p_imm, const char *p_scratch0,
+                      const char *p_scratch1) {
+  if (!isInt32(p_imm) || p_imm == 0 ||
+      p_imm == std::numeric_limits<int32_t>::min()) {
+    return false;
+  }
+  const auto divisor = static_cast<int32_t>(p_imm);
+  // the remainder takes the sign of the dividend, not of the divisor
+  const int32_t abs_divisor = divisor < 0 ? -divisor : divisor;
+  if (abs_divisor == 1) {
+    constexpr const char *const zero = "    li %s, 0\n";
+    dumpInstructions(p_out, zero, p_dst);
+    return true;
+  }
+
+  const int shift = exactLog2(abs_divisor);
+  if (shift > 0) {
+    // x - (x / 2^k) * 2^k with the quotient rounded toward zero
+    genRoundingBias(p_out, p_scratch0, p_src, shift);
+    if (abs_divisor <= 2048) {
+      constexpr const char *const clear_low = "    andi %s, %s, %d\n";
+      dumpInstructions(p_out, clear_low, p_scratch0, p_scratch0,
+                       -abs_divisor);
+    } else {
+      constexpr const char *const clear_low =
+          "    srai %s, %s, %d\n"
+          "    slli %s, %s, %d\n";
+      dumpInstructions(p_out, clear_low, p_scratch0, p_scratch0, shift,
+                       p_scratch0, p_scratch0, shift);
+    }
+    constexpr const char *const sub = "    sub %s, %s, %s\n";
+    dumpInstructions(p_out, sub, p_dst, p_src, p_scratch0);
+    return true;
+  }
+
+  genMagicQuotient(p_out, p_scratch0, p_src, divisor);
+  constexpr const char *const remainder =
+      "    srli %s, %s, 31\n"
+      "    add %s, %s, %s\n"
+      "    li %s, %d\n"
+      "    mul %s, %s, %s\n"
+      "    sub %s, %s, %s\n";
+  dumpInstructions(p_out, remainder, p_scratch1, p_scratch0, p_scratch0,
+                   p_scratch0, p_scratch1, p_scratch1, divisor, p_scratch0,
+                   p_scratch0, p_scratch1, p_dst, p_src, p_scratch0);
+  return true;
+}
@@ -0,0 +1,30 @@
+#include "codegen/StringLiteral.hpp"
+
+std::string quoteStringLiteral(const std::string &p_value) {
+  std::string quoted = "\"";
+  for (const char c : p_value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (c == '\n') {
+      quoted += "\\n";
+    } else if (c == '\t') {
+      quoted += "\\t";
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + '"';
+}
+
+void genStringLiteral(FILE *p_out, const std::string &p_label,
+                      const std::string &p_value) {
+  std::fprintf(p_out,
+               "    .align 2\n"
+               "    .word %zu\n"
+               "    .word 0\n"
+               "%s:\n"
+               "    .string %s\n",
+               p_value.size(), p_label.c_str(),
+               quoteStringLiteral(p_value).c_str());
+}
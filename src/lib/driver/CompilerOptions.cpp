@@ -0,0 +1,94 @@
+#include "driver/CompilerOptions.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "asm/Scheduler.hpp"
+
+void printUsage(const char *p_program) {
+  std::fprintf(stderr,
+               "Usage: %s <filename> [--dump-ast] [--dump-ir] [-O0|-O1] "
+               "[--passes=<pass,...>] [--unroll=<factor>] [-emit-obj] "
+               "[--whole-program] [--no-peephole] [--no-block-layout] "
+               "[--no-schedule] [--mtune=generic|bumblebee] "
+               "[--real-precision=single|double] [--save-path <save path>]\n",
+               p_program);
+}
+
+bool parseCompilerOptions(const int argc, const char *const argv[],
+                          CompilerOptions &p_options) {
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    if (std::strcmp(arg, "--dump-ast") == 0) {
+      p_options.dump_ast = true;
+    } else if (std::strcmp(arg, "--dump-ir") == 0) {
+      p_options.dump_ir = true;
+    } else if (std::strcmp(arg, "-O0") == 0) {
+      p_options.opt_level = 0;
+    } else if (std::strcmp(arg, "-O1") == 0) {
+      p_options.opt_level = 1;
+    } else if (std::strncmp(arg, "--passes=", 9) == 0) {
+      p_options.has_passes = true;
+      p_options.passes = arg + 9;
+    } else if (std::strncmp(arg, "--unroll=", 9) == 0) {
+      p_options.has_unroll = true;
+      char *end = nullptr;
+      p_options.unroll_factor = std::strtoul(arg + 9, &end, 10);
+      if (arg[9] == '\0' || *end != '\0') {
+        std::fprintf(stderr, "Invalid unroll factor: %s\n", arg + 9);
+        return false;
+      }
+    } else if (std::strcmp(arg, "-emit-obj") == 0 ||
+               std::strcmp(arg, "--emit-obj") == 0) {
+      p_options.emit_obj = true;
+    } else if (std::strcmp(arg, "--whole-program") == 0) {
+      p_options.whole_program = true;
+    } else if (std::strcmp(arg, "--no-peephole") == 0) {
+      p_options.peephole = false;
+    } else if (std::strcmp(arg, "--no-block-layout") == 0) {
+      p_options.block_layout = false;
+    } else if (std::strcmp(arg, "--no-schedule") == 0) {
+      p_options.schedule = false;
+    } else if (std::strncmp(arg, "--mtune=", 8) == 0) {
+      if (!findPipelineModel(arg + 8)) {
+        std::fprintf(stderr, "Unknown core: %s\n", arg + 8);
+        return false;
+      }
+      p_options.tune = arg + 8;
+    } else if (std::strncmp(arg, "--real-precision=", 17) == 0) {
+      if (std::strcmp(arg + 17, "single") == 0) {
+        p_options.real_precision = RealPrecision::kSingle;
+      } else if (std::strcmp(arg + 17, "double") == 0) {
+        p_options.real_precision = RealPrecision::kDouble;
+      } else {
+        std::fprintf(stderr, "Invalid real precision: %s\n", arg + 17);
+        return false;
+      }
+    } else if (std::strcmp(arg, "--save-path") == 0) {
+      if (i + 1 >= argc) {
+        std::fprintf(stderr, "--save-path requires an argument\n");
+        return false;
+      }
+      p_options.save_path = argv[++i];
+    } else if (arg[0] == '-') {
+      std::fprintf(stderr, "Unknown option: %s\n", arg);
+      return false;
+    } else if (p_options.source_file.empty()) {
+      p_options.source_file = arg;
+    } else {
+      // the legacy form "<filename> <flag> <save path>" passes the save path
+      // positionally
+      p_options.save_path = arg;
+    }
+  }
+  if (p_options.source_file.empty()) {
+    std::fprintf(stderr, "No input file\n");
+    return false;
+  }
+  if (p_options.has_unroll && p_options.useIR()) {
+    std::fprintf(stderr,
+                 "Warning: --unroll only applies to -O0 and is ignored\n");
+  }
+  return true;
+}
@@ -0,0 +1,55 @@
+#include "ir/Passes.hpp"
+
+#include <algorithm>
+
+// the single value a phi merges, ignoring its own result; none otherwise
+static IROperand getUniqueIncoming(const IRInstruction &p_phi) {
+  IROperand unique;
+  const auto self = IROperand::vreg(p_phi.getDst());
+  for (const auto &operand : p_phi.getOperands()) {
+    if (operand == self || operand == unique) {
+      continue;
+    }
+    if (!unique.isNone()) {
+      return IROperand();
+    }
+    unique = operand;
+  }
+  return unique;
+}
+
+bool propagateCopies(IRFunction &p_function) {
+  bool changed = false;
+  bool found = true;
+  while (found) {
+    found = false;
+    std::vector<IROperand> replacements(p_function.getNumVRegs());
+    for (auto &block : p_function.getBlocks()) {
+      auto &instructions = block->getInstructions();
+      const auto old_size = instructions.size();
+      instructions.erase(
+          std::remove_if(instructions.begin(), instructions.end(),
+                         [&](const auto &instruction) {
+                           IROperand source;
+                           if (instruction->getOpcode() == IROpcode::kCopy) {
+                             source = instruction->getOperand(0);
+                           } else if (instruction->getOpcode() ==
+                                      IROpcode::kPhi) {
+                             source = getUniqueIncoming(*instruction);
+                           }
+                           if (source.isNone()) {
+                             return false;
+                           }
+                           replacements[instruction->getDst()] = source;
+                           return true;
+                         }),
+          instructions.end());
+      found |= instructions.size() != old_size;
+    }
+    if (found) {
+      p_function.replaceVRegs(replacements);
+      changed = true;
+    }
+  }
+  return changed;
+}
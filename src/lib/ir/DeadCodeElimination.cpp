@@ -0,0 +1,52 @@
+#include "ir/Passes.hpp"
+
+#include <algorithm>
+
+bool eliminateDeadCode(IRFunction &p_function) {
+  bool changed = p_function.removeUnreachableBlocks();
+
+  // mark: start from the instructions that must stay and follow operands
+  std::vector<const IRInstruction *> defs(p_function.getNumVRegs(), nullptr);
+  std::vector<const IRInstruction *> worklist;
+  for (const auto &block : p_function.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      if (instruction->hasDst()) {
+        defs[instruction->getDst()] = instruction.get();
+      }
+      if (instruction->hasSideEffects()) {
+        worklist.push_back(instruction.get());
+      }
+    }
+  }
+  std::vector<bool> live(p_function.getNumVRegs(), false);
+  while (!worklist.empty()) {
+    const auto *instruction = worklist.back();
+    worklist.pop_back();
+    for (const auto &operand : instruction->getOperands()) {
+      if (!operand.isVReg() || live[operand.getVReg()]) {
+        continue;
+      }
+      live[operand.getVReg()] = true;
+      // parameters have no defining instruction
+      if (defs[operand.getVReg()]) {
+        worklist.push_back(defs[operand.getVReg()]);
+      }
+    }
+  }
+
+  // sweep
+  for (auto &block : p_function.getBlocks()) {
+    auto &instructions = block->getInstructions();
+    const auto old_size = instructions.size();
+    instructions.erase(
+        std::remove_if(instructions.begin(), instructions.end(),
+                       [&](const auto &instruction) {
+                         return !instruction->hasSideEffects() &&
+                                instruction->hasDst() &&
+                                !live[instruction->getDst()];
+                       }),
+        instructions.end());
+    changed |= instructions.size() != old_size;
+  }
+  return changed;
+}
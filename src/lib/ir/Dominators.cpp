@@ -0,0 +1,126 @@
+#include "ir/Dominators.hpp"
+
+#include <algorithm>
+#include <utility>
+
+static constexpr size_t kUnreachable = static_cast<size_t>(-1);
+
+DominatorTree::DominatorTree(const IRFunction &p_function)
+    : m_rpo_index(p_function.getNumBlockIds(), kUnreachable),
+      m_idom(p_function.getNumBlockIds(), nullptr),
+      m_children(p_function.getNumBlockIds()),
+      m_frontiers(p_function.getNumBlockIds()) {
+  computeReversePostOrder(p_function);
+  computeIdoms();
+  computeFrontiers();
+}
+
+void DominatorTree::computeReversePostOrder(const IRFunction &p_function) {
+  // iterative DFS; the second member is the next successor to visit
+  std::vector<bool> visited(p_function.getNumBlockIds(), false);
+  std::vector<std::pair<IRBasicBlock *, size_t>> stack;
+  stack.emplace_back(p_function.getEntryBlock(), 0);
+  visited[p_function.getEntryBlock()->getId()] = true;
+  while (!stack.empty()) {
+    auto *block = stack.back().first;
+    const auto &succs = block->getSuccessors();
+    if (stack.back().second < succs.size()) {
+      auto *succ = succs[stack.back().second++];
+      if (!visited[succ->getId()]) {
+        visited[succ->getId()] = true;
+        stack.emplace_back(succ, 0);
+      }
+      continue;
+    }
+    m_reverse_post_order.push_back(block);
+    stack.pop_back();
+  }
+  std::reverse(m_reverse_post_order.begin(), m_reverse_post_order.end());
+  for (size_t i = 0; i < m_reverse_post_order.size(); ++i) {
+    m_rpo_index[m_reverse_post_order[i]->getId()] = i;
+  }
+}
+
+void DominatorTree::computeIdoms() {
+  auto *entry = m_reverse_post_order.front();
+  m_idom[entry->getId()] = entry;
+
+  auto intersect = [&](IRBasicBlock *p_lhs, IRBasicBlock *p_rhs) {
+    while (p_lhs != p_rhs) {
+      while (m_rpo_index[p_lhs->getId()] > m_rpo_index[p_rhs->getId()]) {
+        p_lhs = m_idom[p_lhs->getId()];
+      }
+      while (m_rpo_index[p_rhs->getId()] > m_rpo_index[p_lhs->getId()]) {
+        p_rhs = m_idom[p_rhs->getId()];
+      }
+    }
+    return p_lhs;
+  };
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 1; i < m_reverse_post_order.size(); ++i) {
+      auto *block = m_reverse_post_order[i];
+      IRBasicBlock *new_idom = nullptr;
+      for (auto *pred : block->getPredecessors()) {
+        if (!m_idom[pred->getId()]) {
+          continue;  // not processed yet, or unreachable
+        }
+        new_idom = new_idom ? intersect(pred, new_idom) : pred;
+      }
+      if (m_idom[block->getId()] != new_idom) {
+        m_idom[block->getId()] = new_idom;
+        changed = true;
+      }
+    }
+  }
+
+  for (size_t i = 1; i < m_reverse_post_order.size(); ++i) {
+    auto *block = m_reverse_post_order[i];
+    m_children[m_idom[block->getId()]->getId()].push_back(block);
+  }
+}
+
+void DominatorTree::computeFrontiers() {
+  for (auto *block : m_reverse_post_order) {
+    const auto &preds = block->getPredecessors();
+    if (preds.size() < 2) {
+      continue;
+    }
+    for (auto *pred : preds) {
+      if (!isReachable(pred)) {
+        continue;
+      }
+      for (auto *runner = pred; runner != m_idom[block->getId()];
+           runner = m_idom[runner->getId()]) {
+        auto &frontier = m_frontiers[runner->getId()];
+        if (std::find(frontier.begin(), frontier.end(), block) ==
+            frontier.end()) {
+          frontier.push_back(block);
+        }
+      }
+    }
+  }
+}
+
+bool DominatorTree::isReachable(const IRBasicBlock *p_block) const {
+  return m_rpo_index[p_block->getId()] != kUnreachable;
+}
+
+IRBasicBlock *DominatorTree::getIdom(const IRBasicBlock *p_block) const {
+  auto *idom = m_idom[p_block->getId()];
+  return (idom == p_block) ? nullptr : idom;
+}
+
+bool DominatorTree::dominates(const IRBasicBlock *p_dom,
+                              const IRBasicBlock *p_block) const {
+  if (!isReachable(p_block)) {
+    return false;
+  }
+  // walk up the tree; idoms always come earlier in reverse post order
+  while (m_rpo_index[p_block->getId()] > m_rpo_index[p_dom->getId()]) {
+    p_block = m_idom[p_block->getId()];
+  }
+  return p_block == p_dom;
+}
@@ -0,0 +1,332 @@
+#include "ir/IR.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+const char *getIRTypeCString(const IRType p_type) {
+  static const char *kTypeStrings[] = {"void", "bool", "int", "ptr", "real"};
+  return kTypeStrings[static_cast<size_t>(p_type)];
+}
+
+// ===========================================
+// > IROperand
+// ===========================================
+IROperand IROperand::vreg(const size_t p_id) {
+  IROperand operand;
+  operand.m_kind = Kind::kVReg;
+  operand.m_value = static_cast<int64_t>(p_id);
+  return operand;
+}
+
+IROperand IROperand::imm(const int64_t p_value) {
+  IROperand operand;
+  operand.m_kind = Kind::kImm;
+  operand.m_value = p_value;
+  return operand;
+}
+
+IROperand IROperand::slot(const size_t p_id) {
+  IROperand operand;
+  operand.m_kind = Kind::kSlot;
+  operand.m_value = static_cast<int64_t>(p_id);
+  return operand;
+}
+
+IROperand IROperand::global(const std::string &p_name) {
+  IROperand operand;
+  operand.m_kind = Kind::kGlobal;
+  operand.m_symbol = p_name;
+  return operand;
+}
+
+IROperand IROperand::real(const double p_value) {
+  IROperand operand;
+  operand.m_kind = Kind::kReal;
+  std::memcpy(&operand.m_value, &p_value, sizeof(p_value));
+  return operand;
+}
+
+double IROperand::getReal() const {
+  double value = 0;
+  std::memcpy(&value, &m_value, sizeof(value));
+  return value;
+}
+
+bool IROperand::operator==(const IROperand &p_other) const {
+  return m_kind == p_other.m_kind && m_value == p_other.m_value &&
+         m_symbol == p_other.m_symbol;
+}
+
+// ===========================================
+// > IRInstruction
+// ===========================================
+const char *getIROpcodeCString(const IROpcode p_opcode) {
+  static const char *kOpcodeStrings[] = {
+      "add",   "sub",   "mul",   "div",   "rem",   "and",  "or",
+      "cmpeq", "cmpne", "cmplt", "cmple", "cmpgt", "cmpge", "neg",
+      "not",   "copy",  "inttoreal", "realtoint", "load",  "store", "addr",
+      "call",  "phi",   "br",    "condbr", "ret"};
+  return kOpcodeStrings[static_cast<size_t>(p_opcode)];
+}
+
+bool evaluateIROperation(const IROpcode p_opcode, const int64_t p_lhs,
+                         const int64_t p_rhs, int64_t &p_result) {
+  // wrap around like the 32-bit hardware does
+  auto wrap = [](const int64_t p_value) {
+    return static_cast<int64_t>(
+        static_cast<int32_t>(static_cast<uint32_t>(p_value)));
+  };
+  switch (p_opcode) {
+    case IROpcode::kAdd:
+      p_result = wrap(p_lhs + p_rhs);
+      return true;
+    case IROpcode::kSub:
+      p_result = wrap(p_lhs - p_rhs);
+      return true;
+    case IROpcode::kMul:
+      p_result = wrap(p_lhs * p_rhs);
+      return true;
+    case IROpcode::kDiv:
+    case IROpcode::kRem:
+      if (p_rhs == 0 || (p_lhs == INT32_MIN && p_rhs == -1)) {
+        return false;
+      }
+      p_result = (p_opcode == IROpcode::kDiv) ? p_lhs / p_rhs : p_lhs % p_rhs;
+      return true;
+    case IROpcode::kAnd:
+      p_result = p_lhs & p_rhs;
+      return true;
+    case IROpcode::kOr:
+      p_result = p_lhs | p_rhs;
+      return true;
+    case IROpcode::kCmpEq:
+      p_result = p_lhs == p_rhs;
+      return true;
+    case IROpcode::kCmpNe:
+      p_result = p_lhs != p_rhs;
+      return true;
+    case IROpcode::kCmpLt:
+      p_result = p_lhs < p_rhs;
+      return true;
+    case IROpcode::kCmpLe:
+      p_result = p_lhs <= p_rhs;
+      return true;
+    case IROpcode::kCmpGt:
+      p_result = p_lhs > p_rhs;
+      return true;
+    case IROpcode::kCmpGe:
+      p_result = p_lhs >= p_rhs;
+      return true;
+    case IROpcode::kNeg:
+      p_result = wrap(-p_lhs);
+      return true;
+    case IROpcode::kNot:
+      p_result = p_lhs == 0;
+      return true;
+    case IROpcode::kCopy:
+      p_result = p_lhs;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IRInstruction::isTerminator() const {
+  return m_opcode == IROpcode::kBr || m_opcode == IROpcode::kCondBr ||
+         m_opcode == IROpcode::kRet;
+}
+
+bool IRInstruction::isBinary() const {
+  return m_opcode >= IROpcode::kAdd && m_opcode <= IROpcode::kCmpGe;
+}
+
+bool IRInstruction::isUnary() const {
+  return m_opcode == IROpcode::kNeg || m_opcode == IROpcode::kNot;
+}
+
+bool IRInstruction::isComparison() const {
+  return m_opcode >= IROpcode::kCmpEq && m_opcode <= IROpcode::kCmpGe;
+}
+
+bool IRInstruction::hasSideEffects() const {
+  return m_opcode == IROpcode::kStore || m_opcode == IROpcode::kCall ||
+         isTerminator();
+}
+
+// ===========================================
+// > IRBasicBlock
+// ===========================================
+IRInstruction *IRBasicBlock::append(IRInstruction *p_instruction) {
+  assert(!getTerminator() && "Append to a terminated basic block");
+  m_instructions.emplace_back(p_instruction);
+  return p_instruction;
+}
+
+IRInstruction *IRBasicBlock::getTerminator() const {
+  if (m_instructions.empty() || !m_instructions.back()->isTerminator()) {
+    return nullptr;
+  }
+  return m_instructions.back().get();
+}
+
+// ===========================================
+// > IRFunction
+// ===========================================
+size_t IRFunction::newVReg(const IRType p_type) {
+  m_vreg_types.push_back(p_type);
+  return m_vreg_types.size() - 1;
+}
+
+size_t IRFunction::addParam(const IRType p_type) {
+  m_params.push_back(newVReg(p_type));
+  return m_params.back();
+}
+
+size_t IRFunction::addSlot(const std::string &p_name, const size_t p_size,
+                           const size_t p_align) {
+  m_slots.push_back(StackSlot{p_name, p_size, p_align});
+  return m_slots.size() - 1;
+}
+
+IRBasicBlock *IRFunction::createBlock() {
+  m_blocks.emplace_back(new IRBasicBlock(m_next_block_id++));
+  return m_blocks.back().get();
+}
+
+void IRFunction::recomputeCFG() {
+  for (auto &block : m_blocks) {
+    block->getPredecessors().clear();
+    block->getSuccessors().clear();
+  }
+  for (auto &block : m_blocks) {
+    const auto *terminator = block->getTerminator();
+    assert(terminator && "Basic block without terminator");
+    for (auto *target : terminator->getTargets()) {
+      auto &succs = block->getSuccessors();
+      // both edges of a conditional branch may lead to the same block
+      if (std::find(succs.begin(), succs.end(), target) != succs.end()) {
+        continue;
+      }
+      succs.push_back(target);
+      target->getPredecessors().push_back(block.get());
+    }
+  }
+}
+
+bool IRFunction::removeUnreachableBlocks() {
+  std::vector<bool> reachable(m_next_block_id, false);
+  std::vector<IRBasicBlock *> worklist{getEntryBlock()};
+  reachable[getEntryBlock()->getId()] = true;
+  while (!worklist.empty()) {
+    auto *block = worklist.back();
+    worklist.pop_back();
+    for (auto *target : block->getTerminator()->getTargets()) {
+      if (!reachable[target->getId()]) {
+        reachable[target->getId()] = true;
+        worklist.push_back(target);
+      }
+    }
+  }
+
+  if (std::all_of(m_blocks.begin(), m_blocks.end(), [&](const auto &block) {
+        return reachable[block->getId()];
+      })) {
+    return false;
+  }
+
+  // before the blocks go away, as the phis still point to them
+  for (auto &block : m_blocks) {
+    for (auto &instruction : block->getInstructions()) {
+      if (instruction->getOpcode() != IROpcode::kPhi) {
+        continue;
+      }
+      auto &operands = instruction->getOperands();
+      auto &targets = instruction->getTargets();
+      for (size_t i = targets.size(); i > 0; --i) {
+        if (!reachable[targets[i - 1]->getId()]) {
+          operands.erase(operands.begin() + (i - 1));
+          targets.erase(targets.begin() + (i - 1));
+        }
+      }
+    }
+  }
+  m_blocks.erase(std::remove_if(m_blocks.begin(), m_blocks.end(),
+                                [&](const auto &block) {
+                                  return !reachable[block->getId()];
+                                }),
+                 m_blocks.end());
+  recomputeCFG();
+  return true;
+}
+
+void IRFunction::removeUnusedSlots() {
+  constexpr size_t kUnused = static_cast<size_t>(-1);
+  std::vector<size_t> new_ids(m_slots.size(), kUnused);
+  for (const auto &block : m_blocks) {
+    for (const auto &instruction : block->getInstructions()) {
+      for (const auto &operand : instruction->getOperands()) {
+        if (operand.isSlot()) {
+          new_ids[operand.getSlot()] = 0;
+        }
+      }
+    }
+  }
+
+  Slots slots;
+  for (size_t i = 0; i < m_slots.size(); ++i) {
+    if (new_ids[i] != kUnused) {
+      new_ids[i] = slots.size();
+      slots.push_back(m_slots[i]);
+    }
+  }
+  m_slots = std::move(slots);
+
+  for (auto &block : m_blocks) {
+    for (auto &instruction : block->getInstructions()) {
+      for (auto &operand : instruction->getOperands()) {
+        if (operand.isSlot()) {
+          operand = IROperand::slot(new_ids[operand.getSlot()]);
+        }
+      }
+    }
+  }
+}
+
+void IRFunction::replaceVRegs(std::vector<IROperand> &p_replacements) {
+  // resolve (and compress) a chain of replacements
+  auto resolve = [&](const IROperand &p_operand) {
+    IROperand resolved = p_operand;
+    while (resolved.isVReg() && !p_replacements[resolved.getVReg()].isNone()) {
+      resolved = p_replacements[resolved.getVReg()];
+    }
+    if (p_operand.isVReg() && !p_replacements[p_operand.getVReg()].isNone()) {
+      p_replacements[p_operand.getVReg()] = resolved;
+    }
+    return resolved;
+  };
+  for (auto &block : m_blocks) {
+    for (auto &instruction : block->getInstructions()) {
+      for (auto &operand : instruction->getOperands()) {
+        operand = resolve(operand);
+      }
+    }
+  }
+}
+
+// ===========================================
+// > IRModule
+// ===========================================
+std::string IRModule::internString(const std::string &p_value) {
+  return getStringLabel(
+      m_strings.emplace(p_value, m_strings.size()).first->second);
+}
+
+std::string IRModule::getStringLabel(const size_t p_index) {
+  return ".LS" + std::to_string(p_index);
+}
+
+IRFunction *IRModule::addFunction(IRFunction *p_function) {
+  m_functions.emplace_back(p_function);
+  return p_function;
+}
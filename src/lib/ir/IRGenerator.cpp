@@ -0,0 +1,536 @@
+#include "ir/IRGenerator.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "visitor/AstNodeInclude.hpp"
+
+static IRType toIRType(const PType &p_type) {
+  // arrays and strings are passed around by their address
+  if (!p_type.getDimensions().empty() || p_type.isString()) {
+    return IRType::kPtr;
+  }
+  if (p_type.isVoid()) {
+    return IRType::kVoid;
+  }
+  if (p_type.isBool()) {
+    return IRType::kBool;
+  }
+  if (p_type.isReal()) {
+    return IRType::kReal;
+  }
+  return IRType::kInt;
+}
+
+// integer/boolean constants as an immediate, reals as a real operand
+static IROperand toImmediate(const Constant &p_constant) {
+  if (p_constant.getTypePtr()->isPrimitiveReal()) {
+    return IROperand::real(p_constant.real());
+  }
+  if (p_constant.getTypePtr()->isPrimitiveBool()) {
+    return IROperand::imm(p_constant.boolean() ? 1 : 0);
+  }
+  return IROperand::imm(p_constant.integer());
+}
+
+static IROpcode toIROpcode(const Operator p_op) {
+  switch (p_op) {
+    case Operator::kPlusOp:
+      return IROpcode::kAdd;
+    case Operator::kMinusOp:
+      return IROpcode::kSub;
+    case Operator::kMultiplyOp:
+      return IROpcode::kMul;
+    case Operator::kDivideOp:
+      return IROpcode::kDiv;
+    case Operator::kModOp:
+      return IROpcode::kRem;
+    case Operator::kAndOp:
+      return IROpcode::kAnd;
+    case Operator::kOrOp:
+      return IROpcode::kOr;
+    case Operator::kLessOp:
+      return IROpcode::kCmpLt;
+    case Operator::kLessOrEqualOp:
+      return IROpcode::kCmpLe;
+    case Operator::kGreaterOp:
+      return IROpcode::kCmpGt;
+    case Operator::kGreaterOrEqualOp:
+      return IROpcode::kCmpGe;
+    case Operator::kEqualOp:
+      return IROpcode::kCmpEq;
+    case Operator::kNotEqualOp:
+      return IROpcode::kCmpNe;
+    case Operator::kNegOp:
+      return IROpcode::kNeg;
+    case Operator::kNotOp:
+      return IROpcode::kNot;
+  }
+  assert(false && "Invalid operator");
+  return IROpcode::kAdd;
+}
+
+IRGenerator::IRGenerator(const std::string &p_source_file_name,
+                         const SymbolManager *const p_symbol_manager,
+                         const RealPrecision p_precision)
+    : m_symbol_manager_ptr(p_symbol_manager),
+      m_real_size(getRealSize(p_precision)),
+      m_module(new IRModule(p_source_file_name)) {}
+
+IROperand IRGenerator::genExpr(const ExpressionNode &p_expr) {
+  const_cast<ExpressionNode &>(p_expr).accept(*this);
+  return m_value;
+}
+
+IROperand IRGenerator::genConstant(const Constant &p_constant) {
+  if (p_constant.getTypePtr()->isString()) {
+    return IROperand::global(m_module->internString(p_constant.string()));
+  }
+  return toImmediate(p_constant);
+}
+
+IRType IRGenerator::getOperandType(const IROperand &p_operand) const {
+  if (p_operand.isVReg()) {
+    return m_function->getVRegType(p_operand.getVReg());
+  }
+  if (p_operand.isGlobal()) {
+    return IRType::kPtr;
+  }
+  return p_operand.isReal() ? IRType::kReal : IRType::kInt;
+}
+
+IROperand IRGenerator::genConversion(const IROperand &p_value,
+                                     const IRType p_type) {
+  const auto type = getOperandType(p_value);
+  if (p_type == IRType::kReal && type == IRType::kInt) {
+    return p_value.isImm()
+               ? IROperand::real(static_cast<double>(p_value.getImm()))
+               : emit(IROpcode::kIntToReal, IRType::kReal, {p_value});
+  }
+  if (p_type == IRType::kInt && type == IRType::kReal) {
+    return p_value.isReal()
+               ? IROperand::imm(static_cast<int32_t>(p_value.getReal()))
+               : emit(IROpcode::kRealToInt, IRType::kInt, {p_value});
+  }
+  return p_value;
+}
+
+IROperand IRGenerator::emit(const IROpcode p_opcode, const IRType p_type,
+                            const IRInstruction::Operands &p_operands) {
+  const size_t dst = m_function->newVReg(p_type);
+  m_block->append(new IRInstruction(p_opcode, p_type, dst, p_operands));
+  return IROperand::vreg(dst);
+}
+
+void IRGenerator::emitStore(const IRType p_type, const IROperand &p_value,
+                            const IROperand &p_addr) {
+  emitStore(p_type, p_value, IRInstruction::Operands{p_addr});
+}
+
+void IRGenerator::emitStore(const IRType p_type, const IROperand &p_value,
+                            const IRInstruction::Operands &p_location) {
+  IRInstruction::Operands operands{p_value};
+  operands.insert(operands.end(), p_location.begin(), p_location.end());
+  m_block->append(new IRInstruction(IROpcode::kStore, p_type,
+                                    IRInstruction::kNoDst, operands));
+}
+
+void IRGenerator::emitBranch(IRBasicBlock *p_target) {
+  auto *br = m_block->append(
+      new IRInstruction(IROpcode::kBr, IRType::kVoid, IRInstruction::kNoDst,
+                        {}));
+  br->getTargets().push_back(p_target);
+}
+
+void IRGenerator::emitCondBranch(const IROperand &p_cond,
+                                 IRBasicBlock *p_then, IRBasicBlock *p_else) {
+  auto *br = m_block->append(new IRInstruction(
+      IROpcode::kCondBr, IRType::kBool, IRInstruction::kNoDst, {p_cond}));
+  br->getTargets().push_back(p_then);
+  br->getTargets().push_back(p_else);
+}
+
+void IRGenerator::genCondition(const ExpressionNode &p_cond,
+                               IRBasicBlock *p_true, IRBasicBlock *p_false) {
+  if (const auto *bin_op = dynamic_cast<const BinaryOperatorNode *>(&p_cond)) {
+    const auto op = bin_op->getOp();
+    if (op == Operator::kAndOp || op == Operator::kOrOp) {
+      auto *rhs_block = m_function->createBlock();
+      if (op == Operator::kAndOp) {
+        genCondition(bin_op->getLeftOperand(), rhs_block, p_false);
+      } else {
+        genCondition(bin_op->getLeftOperand(), p_true, rhs_block);
+      }
+      startBlock(rhs_block);
+      genCondition(bin_op->getRightOperand(), p_true, p_false);
+      return;
+    }
+  }
+  if (const auto *un_op = dynamic_cast<const UnaryOperatorNode *>(&p_cond)) {
+    if (un_op->getOp() == Operator::kNotOp) {
+      genCondition(un_op->getOperand(), p_false, p_true);
+      return;
+    }
+  }
+  emitCondBranch(genExpr(p_cond), p_true, p_false);
+}
+
+void IRGenerator::emitReturn(const IRType p_type, const IROperand &p_value) {
+  IRInstruction::Operands operands;
+  if (!p_value.isNone()) {
+    operands.push_back(p_value);
+  }
+  m_block->append(new IRInstruction(IROpcode::kRet, p_type,
+                                    IRInstruction::kNoDst, operands));
+  // statements after a return end up in an unreachable block
+  startBlock(m_function->createBlock());
+}
+
+void IRGenerator::finishFunction() {
+  const auto ret_type = m_function->getReturnType();
+  emitReturn(ret_type, (ret_type == IRType::kVoid)   ? IROperand()
+                      : (ret_type == IRType::kReal) ? IROperand::real(0)
+                                                    : IROperand::imm(0));
+  // drop the empty block opened by the final return
+  m_function->getBlocks().pop_back();
+  m_function->recomputeCFG();
+  m_function = nullptr;
+  m_block = nullptr;
+}
+
+const IROperand &IRGenerator::getLocation(const std::string &p_name) const {
+  const auto *entry = m_symbol_manager_ptr->lookup(p_name);
+  assert(entry && "Reference to an undeclared symbol");
+  return m_locations.at(entry);
+}
+
+void IRGenerator::visit(ProgramNode &p_program) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_program.getSymbolTable());
+
+  auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(*this); };
+  for_each(p_program.getDeclNodes().begin(), p_program.getDeclNodes().end(),
+           visit_ast_node);
+  for_each(p_program.getFuncNodes().begin(), p_program.getFuncNodes().end(),
+           visit_ast_node);
+
+  m_function = m_module->addFunction(new IRFunction("main", IRType::kInt));
+  startBlock(m_function->createBlock());
+  auto &body = const_cast<CompoundStatementNode &>(p_program.getBody());
+  m_in_place_appends = findInPlaceAppends(body, m_symbol_manager_ptr);
+  body.accept(*this);
+  finishFunction();
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_program.getSymbolTable());
+}
+
+void IRGenerator::visit(DeclNode &p_decl) { p_decl.visitChildNodes(*this); }
+
+void IRGenerator::visit(VariableNode &p_variable) {
+  const auto *entry = m_symbol_manager_ptr->lookup(p_variable.getName());
+  const auto *constant = p_variable.getConstantPtr();
+  const auto type = toIRType(*p_variable.getTypePtr());
+
+  const auto *var_type = p_variable.getTypePtr();
+  if (entry->getLevel() == 0) {
+    const auto init = constant ? genConstant(*constant) : IROperand::imm(0);
+    m_module->addGlobal(IRModule::Global{
+        p_variable.getName(), var_type->getStorageSize(m_real_size),
+        var_type->getElementSize(m_real_size), constant != nullptr,
+        type == IRType::kReal, init.isGlobal() ? 0 : init.getImm(),
+        init.isGlobal() ? init.getSymbol() : ""});
+    m_locations[entry] = IROperand::global(p_variable.getName());
+    return;
+  }
+
+  // an array parameter holds the address of the caller's array
+  const bool is_param =
+      entry->getKind() == SymbolEntry::KindEnum::kParameterKind;
+  const auto slot = IROperand::slot(
+      (is_param && !var_type->getDimensions().empty())
+          ? m_function->addSlot(p_variable.getName(), 4, 4)
+          : m_function->addSlot(p_variable.getName(),
+                                var_type->getStorageSize(m_real_size),
+                                var_type->getElementSize(m_real_size)));
+  m_locations[entry] = slot;
+  if (is_param) {
+    emitStore(type, IROperand::vreg(m_function->addParam(type)), slot);
+  } else if (constant) {
+    emitStore(type, genConstant(*constant), slot);
+  }
+}
+
+void IRGenerator::visit(ConstantValueNode &p_constant_value) {
+  m_value = genConstant(*p_constant_value.getConstantPtr());
+}
+
+void IRGenerator::visit(FunctionNode &p_function) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_function.getSymbolTable());
+
+  m_function = m_module->addFunction(new IRFunction(
+      p_function.getName(), toIRType(*p_function.getTypePtr())));
+  startBlock(m_function->createBlock());
+  if (p_function.getBody()) {
+    m_in_place_appends =
+        findInPlaceAppends(*p_function.getBody(), m_symbol_manager_ptr);
+  }
+  p_function.visitChildNodes(*this);
+  finishFunction();
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+}
+
+void IRGenerator::visit(CompoundStatementNode &p_compound_statement) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_compound_statement.getSymbolTable());
+
+  p_compound_statement.visitChildNodes(*this);
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(
+      p_compound_statement.getSymbolTable());
+}
+
+void IRGenerator::visit(PrintNode &p_print) {
+  const auto value = genExpr(p_print.getTarget());
+  auto *call = m_block->append(new IRInstruction(
+      IROpcode::kCall, IRType::kVoid, IRInstruction::kNoDst, {value}));
+  const auto *type = p_print.getTarget().getInferredType();
+  call->setCallee(type->isReal()     ? "printReal"
+                  : type->isBool()   ? "printBool"
+                  : type->isString() ? "printString"
+                                     : "printInt");
+}
+
+void IRGenerator::visit(BinaryOperatorNode &p_bin_op) {
+  const auto op = p_bin_op.getOp();
+  if ((op == Operator::kAndOp || op == Operator::kOrOp) &&
+      hasFunctionInvocation(p_bin_op.getRightOperand())) {
+    // the call on the right must not happen when the left operand decides;
+    // the result goes through a slot that mem2reg turns into a phi
+    const auto result = IROperand::slot(m_function->addSlot("cond", 4, 4));
+    auto *true_block = m_function->createBlock();
+    auto *false_block = m_function->createBlock();
+    auto *end_block = m_function->createBlock();
+    genCondition(p_bin_op, true_block, false_block);
+    startBlock(true_block);
+    emitStore(IRType::kBool, IROperand::imm(1), result);
+    emitBranch(end_block);
+    startBlock(false_block);
+    emitStore(IRType::kBool, IROperand::imm(0), result);
+    emitBranch(end_block);
+    startBlock(end_block);
+    m_value = emit(IROpcode::kLoad, IRType::kBool, {result});
+    return;
+  }
+
+  auto lhs = genExpr(p_bin_op.getLeftOperand());
+  auto rhs = genExpr(p_bin_op.getRightOperand());
+  if (isConcatenation(p_bin_op)) {
+    // a temporary or m_appended is not held by anything else
+    const auto &base = p_bin_op.getLeftOperand();
+    const bool in_place = isConcatenation(base) || &base == m_appended;
+    const size_t dst = m_function->newVReg(IRType::kPtr);
+    auto *call = m_block->append(
+        new IRInstruction(IROpcode::kCall, IRType::kPtr, dst, {lhs, rhs}));
+    call->setCallee(in_place ? "appendString" : "concatString");
+    m_value = IROperand::vreg(dst);
+    return;
+  }
+  // an integer operand of a real operation is converted
+  if (getOperandType(lhs) == IRType::kReal ||
+      getOperandType(rhs) == IRType::kReal) {
+    lhs = genConversion(lhs, IRType::kReal);
+    rhs = genConversion(rhs, IRType::kReal);
+  }
+  m_value = emit(toIROpcode(p_bin_op.getOp()),
+                 toIRType(*p_bin_op.getInferredType()), {lhs, rhs});
+}
+
+void IRGenerator::visit(UnaryOperatorNode &p_un_op) {
+  const auto operand = genExpr(p_un_op.getOperand());
+  m_value = emit(toIROpcode(p_un_op.getOp()),
+                 toIRType(*p_un_op.getInferredType()), {operand});
+}
+
+void IRGenerator::visit(FunctionInvocationNode &p_func_invocation) {
+  // the arguments take the types of the parameters
+  std::vector<IRType> param_types;
+  const auto *entry =
+      m_symbol_manager_ptr->lookup(p_func_invocation.getName());
+  for (const auto &decl : *entry->getAttribute().parameters()) {
+    for (const auto &var : decl->getVariables()) {
+      param_types.push_back(toIRType(*var->getTypePtr()));
+    }
+  }
+  IRInstruction::Operands args;
+  const auto &arguments = p_func_invocation.getArguments();
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    args.push_back(genConversion(genExpr(*arguments[i]), param_types[i]));
+  }
+  const auto type = toIRType(*p_func_invocation.getInferredType());
+  const size_t dst = (type == IRType::kVoid) ? IRInstruction::kNoDst
+                                             : m_function->newVReg(type);
+  auto *call = m_block->append(
+      new IRInstruction(IROpcode::kCall, type, dst, args));
+  call->setCallee(p_func_invocation.getName());
+  m_value = (dst == IRInstruction::kNoDst) ? IROperand() : IROperand::vreg(dst);
+}
+
+IROperand IRGenerator::genElementAddress(
+    const VariableReferenceNode &p_variable_ref, int64_t &p_offset) {
+  const auto *entry = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+  const auto &location = getLocation(p_variable_ref.getName());
+  auto address =
+      (entry->getKind() == SymbolEntry::KindEnum::kParameterKind)
+          ? emit(IROpcode::kLoad, IRType::kPtr, {location})
+          : emit(IROpcode::kAddr, IRType::kPtr, {location});
+
+  const auto *type = entry->getTypePtr();
+  const auto &indices = p_variable_ref.getIndices();
+  p_offset = 0;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const auto stride = static_cast<int64_t>(type->getStride(i, m_real_size));
+    const auto index = genExpr(*indices[i]);
+    if (index.isImm()) {
+      p_offset += index.getImm() * stride;
+      continue;
+    }
+    const auto scaled =
+        emit(IROpcode::kMul, IRType::kInt, {index, IROperand::imm(stride)});
+    address = emit(IROpcode::kAdd, IRType::kPtr, {address, scaled});
+  }
+  return address;
+}
+
+IRInstruction::Operands IRGenerator::genLocation(
+    const VariableReferenceNode &p_variable_ref) {
+  if (p_variable_ref.getIndices().empty()) {
+    return {getLocation(p_variable_ref.getName())};
+  }
+  int64_t offset = 0;
+  const auto address = genElementAddress(p_variable_ref, offset);
+  if (offset == 0) {
+    return {address};
+  }
+  return {address, IROperand::imm(offset)};
+}
+
+void IRGenerator::visit(VariableReferenceNode &p_variable_ref) {
+  const auto *entry = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+  if (!entry->getTypePtr()->getDimensions().empty() &&
+      !p_variable_ref.getInferredType()->isScalar()) {
+    // a whole (sub)array stands for its address
+    int64_t offset = 0;
+    m_value = genElementAddress(p_variable_ref, offset);
+    if (offset != 0) {
+      m_value = emit(IROpcode::kAdd, IRType::kPtr,
+                     {m_value, IROperand::imm(offset)});
+    }
+    return;
+  }
+  m_value = emit(IROpcode::kLoad, toIRType(*p_variable_ref.getInferredType()),
+                 genLocation(p_variable_ref));
+}
+
+void IRGenerator::visit(AssignmentNode &p_assignment) {
+  const auto &lvalue = p_assignment.getLvalue();
+  const auto type = toIRType(*lvalue.getInferredType());
+  if (m_in_place_appends.count(&p_assignment)) {
+    m_appended = &getConcatenationBase(p_assignment.getExpr());
+  }
+  const auto value = genConversion(genExpr(p_assignment.getExpr()), type);
+  m_appended = nullptr;
+  emitStore(type, value, genLocation(lvalue));
+}
+
+void IRGenerator::visit(ReadNode &p_read) {
+  const auto &target = p_read.getTarget();
+  const auto type = toIRType(*target.getInferredType());
+  auto *call = m_block->append(new IRInstruction(
+      IROpcode::kCall, type, m_function->newVReg(type), {}));
+  const auto *target_type = target.getInferredType();
+  call->setCallee(target_type->isReal()     ? "readReal"
+                  : target_type->isBool()   ? "readBool"
+                  : target_type->isString() ? "readString"
+                                            : "readInt");
+  emitStore(type, IROperand::vreg(call->getDst()), genLocation(target));
+}
+
+void IRGenerator::visit(IfNode &p_if) {
+  auto *then_block = m_function->createBlock();
+  auto *else_block = p_if.getElseBody() ? m_function->createBlock() : nullptr;
+  auto *end_block = m_function->createBlock();
+
+  genCondition(p_if.getCondition(), then_block,
+               else_block ? else_block : end_block);
+
+  startBlock(then_block);
+  p_if.getBody().accept(*this);
+  emitBranch(end_block);
+
+  if (else_block) {
+    startBlock(else_block);
+    p_if.getElseBody()->accept(*this);
+    emitBranch(end_block);
+  }
+  startBlock(end_block);
+}
+
+void IRGenerator::visit(WhileNode &p_while) {
+  auto *cond_block = m_function->createBlock();
+  auto *body_block = m_function->createBlock();
+  auto *end_block = m_function->createBlock();
+
+  emitBranch(cond_block);
+  startBlock(cond_block);
+  genCondition(p_while.getCondition(), body_block, end_block);
+
+  startBlock(body_block);
+  p_while.getBody().accept(*this);
+  emitBranch(cond_block);
+
+  startBlock(end_block);
+}
+
+void IRGenerator::visit(ForNode &p_for) {
+  m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+      p_for.getSymbolTable());
+
+  // the loop variable runs from the lower bound up to, but excluding, the
+  // upper bound
+  p_for.getLoopVarDecl().accept(*this);
+  const auto &loop_var =
+      getLocation(p_for.getLoopVarDecl().getVariables().front()->getName());
+  emitStore(IRType::kInt, toImmediate(*p_for.getLowerBound().getConstantPtr()),
+            loop_var);
+
+  auto *cond_block = m_function->createBlock();
+  auto *body_block = m_function->createBlock();
+  auto *end_block = m_function->createBlock();
+
+  emitBranch(cond_block);
+  startBlock(cond_block);
+  const auto upper_bound =
+      toImmediate(*p_for.getUpperBound().getConstantPtr());
+  const auto iv = emit(IROpcode::kLoad, IRType::kInt, {loop_var});
+  emitCondBranch(emit(IROpcode::kCmpLt, IRType::kBool, {iv, upper_bound}),
+                 body_block, end_block);
+
+  startBlock(body_block);
+  p_for.getBody().accept(*this);
+  const auto next = emit(IROpcode::kAdd, IRType::kInt,
+                         {emit(IROpcode::kLoad, IRType::kInt, {loop_var}),
+                          IROperand::imm(1)});
+  emitStore(IRType::kInt, next, loop_var);
+  emitBranch(cond_block);
+
+  startBlock(end_block);
+
+  m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+}
+
+void IRGenerator::visit(ReturnNode &p_return) {
+  const auto type = m_function->getReturnType();
+  emitReturn(type, genConversion(genExpr(p_return.getReturnValue()), type));
+}
@@ -0,0 +1,130 @@
+#include "ir/IRPrinter.hpp"
+
+#include <cinttypes>
+#include <cstring>
+
+#include "codegen/StringLiteral.hpp"
+
+void IRPrinter::printOperand(const IROperand &p_operand) const {
+  switch (p_operand.getKind()) {
+    case IROperand::Kind::kVReg:
+      std::fprintf(m_out, "%%%zu", p_operand.getVReg());
+      break;
+    case IROperand::Kind::kImm:
+      std::fprintf(m_out, "%" PRId64, p_operand.getImm());
+      break;
+    case IROperand::Kind::kSlot:
+      std::fprintf(m_out, "$%zu", p_operand.getSlot());
+      break;
+    case IROperand::Kind::kGlobal:
+      std::fprintf(m_out, "@%s", p_operand.getSymbol().c_str());
+      break;
+    case IROperand::Kind::kReal:
+      // with a decimal point, unlike the integer immediates
+      std::fprintf(m_out, "%#g", p_operand.getReal());
+      break;
+    case IROperand::Kind::kNone:
+      std::fprintf(m_out, "<none>");
+      break;
+  }
+}
+
+void IRPrinter::printInstruction(const IRInstruction &p_instruction) const {
+  std::fprintf(m_out, "  ");
+  if (p_instruction.hasDst()) {
+    std::fprintf(m_out, "%%%zu = ", p_instruction.getDst());
+  }
+  std::fprintf(m_out, "%s %s", p_instruction.getOpcodeCString(),
+               getIRTypeCString(p_instruction.getType()));
+
+  const auto &operands = p_instruction.getOperands();
+  const auto &targets = p_instruction.getTargets();
+  if (p_instruction.getOpcode() == IROpcode::kPhi) {
+    for (size_t i = 0; i < operands.size(); ++i) {
+      std::fprintf(m_out, "%s[", (i == 0) ? " " : ", ");
+      printOperand(operands[i]);
+      std::fprintf(m_out, ", bb%zu]", targets[i]->getId());
+    }
+  } else if (p_instruction.getOpcode() == IROpcode::kCall) {
+    std::fprintf(m_out, " @%s(", p_instruction.getCallee().c_str());
+    for (size_t i = 0; i < operands.size(); ++i) {
+      std::fprintf(m_out, "%s", (i == 0) ? "" : ", ");
+      printOperand(operands[i]);
+    }
+    std::fprintf(m_out, ")");
+  } else {
+    for (size_t i = 0; i < operands.size(); ++i) {
+      std::fprintf(m_out, "%s", (i == 0) ? " " : ", ");
+      printOperand(operands[i]);
+    }
+    for (size_t i = 0; i < targets.size(); ++i) {
+      std::fprintf(m_out, "%sbb%zu", (i == 0 && operands.empty()) ? " " : ", ",
+                   targets[i]->getId());
+    }
+  }
+  std::fprintf(m_out, "\n");
+}
+
+void IRPrinter::printBasicBlock(const IRBasicBlock &p_block) const {
+  std::fprintf(m_out, "bb%zu:", p_block.getId());
+  if (!p_block.getPredecessors().empty()) {
+    std::fprintf(m_out, "  ; preds:");
+    for (const auto *pred : p_block.getPredecessors()) {
+      std::fprintf(m_out, " bb%zu", pred->getId());
+    }
+  }
+  std::fprintf(m_out, "\n");
+  for (const auto &instruction : p_block.getInstructions()) {
+    printInstruction(*instruction);
+  }
+}
+
+void IRPrinter::print(const IRFunction &p_function) const {
+  std::fprintf(m_out, "define %s @%s(",
+               getIRTypeCString(p_function.getReturnType()),
+               p_function.getNameCString());
+  const auto &params = p_function.getParams();
+  for (size_t i = 0; i < params.size(); ++i) {
+    std::fprintf(m_out, "%s%s %%%zu", (i == 0) ? "" : ", ",
+                 getIRTypeCString(p_function.getVRegType(params[i])),
+                 params[i]);
+  }
+  std::fprintf(m_out, ") {\n");
+  const auto &slots = p_function.getSlots();
+  for (size_t i = 0; i < slots.size(); ++i) {
+    std::fprintf(m_out, "  ; $%zu = slot \"%s\", size %zu, align %zu\n", i,
+                 slots[i].name.c_str(), slots[i].size, slots[i].align);
+  }
+  for (const auto &block : p_function.getBlocks()) {
+    printBasicBlock(*block);
+  }
+  std::fprintf(m_out, "}\n");
+}
+
+void IRPrinter::print(const IRModule &p_module) const {
+  std::fprintf(m_out, "; module \"%s\"\n", p_module.getSourceFile().c_str());
+  for (const auto &global : p_module.getGlobals()) {
+    std::fprintf(m_out, "@%s = %s, size %zu, align %zu", global.name.c_str(),
+                 global.is_constant ? "constant" : "global", global.size,
+                 global.align);
+    if (global.is_constant && global.is_real) {
+      double init = 0;
+      std::memcpy(&init, &global.init, sizeof(init));
+      std::fprintf(m_out, ", init %#g", init);
+    } else if (global.is_constant && !global.init_symbol.empty()) {
+      std::fprintf(m_out, ", init @%s", global.init_symbol.c_str());
+    } else if (global.is_constant) {
+      std::fprintf(m_out, ", init %" PRId64, global.init);
+    }
+    std::fprintf(m_out, "\n");
+  }
+  for (const auto &string : p_module.getStrings()) {
+    std::fprintf(m_out, "@%s = string %s\n",
+                 IRModule::getStringLabel(string.second).c_str(),
+                 quoteStringLiteral(string.first).c_str());
+  }
+  for (const auto &function : p_module.getFunctions()) {
+    std::fprintf(m_out, "\n");
+    print(*function);
+  }
+}
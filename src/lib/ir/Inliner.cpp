@@ -0,0 +1,300 @@
+#include "ir/Passes.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "ir/Dominators.hpp"
+#include "ir/LoopInfo.hpp"
+
+// callees up to this many instructions are inlined at every call site
+static constexpr size_t kInlineThreshold = 24;
+// a call in a loop pays the call overhead on every iteration
+static constexpr size_t kLoopInlineThreshold = 64;
+// callers stop growing past this many instructions
+static constexpr size_t kMaxCallerSize = 2048;
+
+using FunctionMap = std::map<std::string, IRFunction *>;
+
+static size_t getSize(const IRFunction &p_function) {
+  size_t size = 0;
+  for (const auto &block : p_function.getBlocks()) {
+    size += block->getInstructions().size();
+  }
+  return size;
+}
+
+static IRFunction *getCallee(const FunctionMap &p_functions,
+                             const IRInstruction &p_instruction) {
+  if (p_instruction.getOpcode() != IROpcode::kCall) {
+    return nullptr;
+  }
+  // calls into the runtime have no body here
+  const auto callee = p_functions.find(p_instruction.getCallee());
+  return callee == p_functions.end() ? nullptr : callee->second;
+}
+
+// Replaces the call at p_index of p_block with a copy of the callee's blocks,
+// which get fresh vregs and stack slots. The rest of p_block moves to a new
+// block, which the copies of the returns branch to; returns that block.
+static IRBasicBlock *inlineCall(IRFunction &p_caller, IRBasicBlock *p_block,
+                                const size_t p_index,
+                                const IRFunction &p_callee) {
+  auto &instructions = p_block->getInstructions();
+  const std::unique_ptr<IRInstruction> call = std::move(instructions[p_index]);
+  IRBasicBlock::Instructions rest;
+  std::move(instructions.begin() + p_index + 1, instructions.end(),
+            std::back_inserter(rest));
+  instructions.erase(instructions.begin() + p_index, instructions.end());
+
+  std::vector<IROperand> vregs(p_callee.getNumVRegs());
+  for (size_t i = 0; i < p_callee.getParams().size(); ++i) {
+    vregs[p_callee.getParams()[i]] = call->getOperand(i);
+  }
+  auto map_vreg = [&](const size_t p_vreg) {
+    if (vregs[p_vreg].isNone()) {
+      vregs[p_vreg] =
+          IROperand::vreg(p_caller.newVReg(p_callee.getVRegType(p_vreg)));
+    }
+    return vregs[p_vreg];
+  };
+  std::vector<size_t> slots;
+  for (const auto &slot : p_callee.getSlots()) {
+    slots.push_back(p_caller.addSlot(p_callee.getName() + "." + slot.name,
+                                     slot.size, slot.align));
+  }
+  std::map<const IRBasicBlock *, IRBasicBlock *> blocks;
+  for (const auto &block : p_callee.getBlocks()) {
+    blocks[block.get()] = p_caller.createBlock();
+  }
+  auto *const cont = p_caller.createBlock();
+  cont->getInstructions() = std::move(rest);
+  for (auto *succ : cont->getTerminator()->getTargets()) {
+    for (auto &instruction : succ->getInstructions()) {
+      if (instruction->getOpcode() != IROpcode::kPhi) {
+        break;
+      }
+      std::replace(instruction->getTargets().begin(),
+                   instruction->getTargets().end(), p_block, cont);
+    }
+  }
+
+  IRInstruction::Operands ret_values;
+  IRInstruction::Targets ret_blocks;
+  for (const auto &block : p_callee.getBlocks()) {
+    auto *const copy = blocks[block.get()];
+    for (const auto &instruction : block->getInstructions()) {
+      IRInstruction::Operands operands;
+      for (const auto &operand : instruction->getOperands()) {
+        if (operand.isVReg()) {
+          operands.push_back(map_vreg(operand.getVReg()));
+        } else if (operand.isSlot()) {
+          operands.push_back(IROperand::slot(slots[operand.getSlot()]));
+        } else {
+          operands.push_back(operand);
+        }
+      }
+
+      if (instruction->getOpcode() == IROpcode::kRet) {
+        if (!operands.empty()) {
+          ret_values.push_back(operands.front());
+          ret_blocks.push_back(copy);
+        }
+        auto *br = copy->append(new IRInstruction(
+            IROpcode::kBr, IRType::kVoid, IRInstruction::kNoDst, {}));
+        br->getTargets().push_back(cont);
+        continue;
+      }
+
+      const auto dst = instruction->hasDst()
+                           ? map_vreg(instruction->getDst()).getVReg()
+                           : IRInstruction::kNoDst;
+      auto *cloned = copy->append(new IRInstruction(
+          instruction->getOpcode(), instruction->getType(), dst, operands));
+      for (auto *target : instruction->getTargets()) {
+        cloned->getTargets().push_back(blocks[target]);
+      }
+      cloned->setCallee(instruction->getCallee());
+    }
+  }
+
+  if (call->hasDst()) {
+    auto &cont_instructions = cont->getInstructions();
+    if (ret_values.empty()) {
+      // the callee never returns, the value is never used
+      cont_instructions.emplace(
+          cont_instructions.begin(),
+          new IRInstruction(IROpcode::kCopy, call->getType(), call->getDst(),
+                            {call->getType() == IRType::kReal
+                                 ? IROperand::real(0)
+                                 : IROperand::imm(0)}));
+    } else {
+      auto *phi = new IRInstruction(IROpcode::kPhi, call->getType(),
+                                    call->getDst(), ret_values);
+      phi->getTargets() = ret_blocks;
+      cont_instructions.emplace(cont_instructions.begin(), phi);
+    }
+  }
+  auto *br = p_block->append(new IRInstruction(IROpcode::kBr, IRType::kVoid,
+                                               IRInstruction::kNoDst, {}));
+  br->getTargets().push_back(blocks[p_callee.getEntryBlock()]);
+
+  // lay the copies and the continuation out right after the call site
+  auto &caller_blocks = p_caller.getBlocks();
+  const auto call_site = std::find_if(
+      caller_blocks.begin(), caller_blocks.end(),
+      [&](const auto &block) { return block.get() == p_block; });
+  const auto num_new = static_cast<long>(p_callee.getBlocks().size() + 1);
+  std::rotate(call_site + 1, caller_blocks.end() - num_new,
+              caller_blocks.end());
+  return cont;
+}
+
+// Removes the functions that no call reaches from main any more, such as the
+// ones inlined at all their call sites.
+static bool removeUncalledFunctions(IRModule &p_module,
+                                    const FunctionMap &p_functions) {
+  std::set<const IRFunction *> reachable;
+  std::vector<const IRFunction *> worklist;
+  const auto entry = p_functions.find("main");
+  if (entry != p_functions.end()) {
+    worklist.push_back(entry->second);
+  }
+  while (!worklist.empty()) {
+    const auto *function = worklist.back();
+    worklist.pop_back();
+    if (!reachable.insert(function).second) {
+      continue;
+    }
+    for (const auto &block : function->getBlocks()) {
+      for (const auto &instruction : block->getInstructions()) {
+        if (const auto *callee = getCallee(p_functions, *instruction)) {
+          worklist.push_back(callee);
+        }
+      }
+    }
+  }
+
+  auto &functions = p_module.getFunctions();
+  const auto old_size = functions.size();
+  functions.erase(std::remove_if(functions.begin(), functions.end(),
+                                 [&](const auto &p_function) {
+                                   return !reachable.count(p_function.get());
+                                 }),
+                  functions.end());
+  return functions.size() != old_size;
+}
+
+bool inlineFunctions(IRModule &p_module) {
+  FunctionMap functions;
+  for (const auto &function : p_module.getFunctions()) {
+    functions[function->getName()] = function.get();
+    // neither worth copying nor counting
+    function->removeUnreachableBlocks();
+  }
+
+  std::map<const IRFunction *, std::set<IRFunction *>> call_graph;
+  std::map<const IRFunction *, size_t> num_call_sites;
+  for (const auto &function : p_module.getFunctions()) {
+    for (const auto &block : function->getBlocks()) {
+      for (const auto &instruction : block->getInstructions()) {
+        if (auto *callee = getCallee(functions, *instruction)) {
+          call_graph[function.get()].insert(callee);
+          ++num_call_sites[callee];
+        }
+      }
+    }
+  }
+
+  // a function is recursive if it can reach itself through calls
+  std::set<const IRFunction *> recursive;
+  for (const auto &function : p_module.getFunctions()) {
+    std::set<const IRFunction *> visited;
+    std::vector<const IRFunction *> worklist{function.get()};
+    while (!worklist.empty()) {
+      const auto *current = worklist.back();
+      worklist.pop_back();
+      for (const auto *callee : call_graph[current]) {
+        if (callee == function.get()) {
+          recursive.insert(callee);
+        }
+        if (visited.insert(callee).second) {
+          worklist.push_back(callee);
+        }
+      }
+    }
+  }
+
+  // callers come after their callees, so the callees are inlined into
+  // before being inlined themselves
+  std::vector<IRFunction *> order;
+  std::set<const IRFunction *> visited;
+  auto visit = [&](auto &p_self, IRFunction *p_function) -> void {
+    if (!visited.insert(p_function).second) {
+      return;
+    }
+    for (auto *callee : call_graph[p_function]) {
+      p_self(p_self, callee);
+    }
+    order.push_back(p_function);
+  };
+  for (const auto &function : p_module.getFunctions()) {
+    visit(visit, function.get());
+  }
+
+  bool changed = false;
+  for (auto *caller : order) {
+    caller->recomputeCFG();
+    const DominatorTree dom_tree(*caller);
+    const LoopInfo loop_info(*caller, dom_tree);
+    size_t caller_size = getSize(*caller);
+
+    std::vector<std::pair<IRBasicBlock *, size_t>> worklist;
+    for (const auto &block : caller->getBlocks()) {
+      worklist.emplace_back(block.get(), loop_info.getLoopDepth(block.get()));
+    }
+    while (!worklist.empty()) {
+      auto *const block = worklist.back().first;
+      const auto loop_depth = worklist.back().second;
+      worklist.pop_back();
+
+      const auto &instructions = block->getInstructions();
+      for (size_t i = 0; i < instructions.size(); ++i) {
+        auto *callee = getCallee(functions, *instructions[i]);
+        if (!callee || callee == caller || recursive.count(callee) ||
+            callee->getName() == "main") {
+          continue;
+        }
+        const auto callee_size = getSize(*callee);
+        const auto threshold =
+            loop_depth > 0 ? kLoopInlineThreshold : kInlineThreshold;
+        if ((callee_size > threshold && num_call_sites[callee] > 1) ||
+            caller_size + callee_size > kMaxCallerSize) {
+          continue;
+        }
+
+        // the calls in the copied body are new call sites of their callees
+        for (const auto &callee_block : callee->getBlocks()) {
+          for (const auto &instruction : callee_block->getInstructions()) {
+            if (auto *nested = getCallee(functions, *instruction)) {
+              ++num_call_sites[nested];
+            }
+          }
+        }
+        caller_size += callee_size;
+        worklist.emplace_back(inlineCall(*caller, block, i, *callee),
+                              loop_depth);
+        changed = true;
+        break;
+      }
+    }
+    caller->recomputeCFG();
+  }
+
+  if (p_module.isWholeProgram() &&
+      removeUncalledFunctions(p_module, functions)) {
+    changed = true;
+  }
+  return changed;
+}
@@ -0,0 +1,63 @@
+#include "ir/LoopInfo.hpp"
+
+#include <algorithm>
+
+LoopInfo::LoopInfo(const IRFunction &p_function,
+                   const DominatorTree &p_dom_tree)
+    : m_block_loops(p_function.getNumBlockIds(), nullptr),
+      m_depths(p_function.getNumBlockIds(), 0) {
+  // one loop per header, merging the bodies of all its back edges
+  for (auto *header : p_dom_tree.getReversePostOrder()) {
+    std::vector<IRBasicBlock *> latches;
+    for (auto *pred : header->getPredecessors()) {
+      if (p_dom_tree.dominates(header, pred)) {
+        latches.push_back(pred);
+      }
+    }
+    if (latches.empty()) {
+      continue;
+    }
+
+    auto *loop = new Loop{header, {header}, latches};
+    std::vector<bool> in_loop(p_function.getNumBlockIds(), false);
+    in_loop[header->getId()] = true;
+    std::vector<IRBasicBlock *> worklist = latches;
+    while (!worklist.empty()) {
+      auto *block = worklist.back();
+      worklist.pop_back();
+      if (in_loop[block->getId()]) {
+        continue;
+      }
+      in_loop[block->getId()] = true;
+      loop->blocks.push_back(block);
+      for (auto *pred : block->getPredecessors()) {
+        if (p_dom_tree.isReachable(pred)) {
+          worklist.push_back(pred);
+        }
+      }
+    }
+    m_loops.emplace_back(loop);
+  }
+
+  // headers are visited in reverse post order, so an enclosing loop is
+  // always recorded before the loops nested in it
+  for (auto &loop : m_loops) {
+    for (auto *block : loop->blocks) {
+      auto *&innermost = m_block_loops[block->getId()];
+      if (block == loop->header && innermost) {
+        loop->parent = innermost;
+      }
+      innermost = loop.get();
+      ++m_depths[block->getId()];
+    }
+  }
+}
+
+bool LoopInfo::contains(const Loop &p_loop, const IRBasicBlock *p_block) const {
+  for (const auto *loop = getLoopFor(p_block); loop; loop = loop->parent) {
+    if (loop == &p_loop) {
+      return true;
+    }
+  }
+  return false;
+}
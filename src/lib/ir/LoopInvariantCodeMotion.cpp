@@ -0,0 +1,221 @@
+#include "ir/Passes.hpp"
+
+#include <algorithm>
+#include <set>
+#include <string>
+
+#include "ir/Dominators.hpp"
+#include "ir/LoopInfo.hpp"
+
+using NameSet = std::set<std::string>;
+using Loop = LoopInfo::Loop;
+
+// What the instructions of a loop may write to memory
+struct MemoryEffects {
+  // stored to directly
+  NameSet globals;
+  std::set<size_t> slots;
+  // stores through pointers and calls of the functions of the module, which
+  // may write to anything
+  bool writes_anything = false;
+};
+
+static MemoryEffects getMemoryEffects(const Loop &p_loop,
+                                      const NameSet &p_functions) {
+  MemoryEffects effects;
+  for (const auto *block : p_loop.blocks) {
+    for (const auto &instruction : block->getInstructions()) {
+      if (instruction->getOpcode() == IROpcode::kCall) {
+        // the runtime only reads the values it is passed, and writes nothing
+        // but the strings it allocates
+        effects.writes_anything |= p_functions.count(instruction->getCallee());
+      } else if (instruction->getOpcode() == IROpcode::kStore) {
+        const auto &addr = instruction->getOperand(1);
+        if (addr.isGlobal()) {
+          effects.globals.insert(addr.getSymbol());
+        } else if (addr.isSlot()) {
+          effects.slots.insert(addr.getSlot());
+        } else {
+          effects.writes_anything = true;
+        }
+      }
+    }
+  }
+  return effects;
+}
+
+// The only block outside the loop that branches to the header, if it
+// branches nowhere else. Such a block is made up when the header is entered
+// from a block that may also skip the loop; nullptr if the loop is entered
+// from several places.
+static IRBasicBlock *getPreheader(IRFunction &p_function,
+                                  const LoopInfo &p_loop_info,
+                                  const Loop &p_loop, const bool p_create) {
+  auto *const header = p_loop.header;
+  IRBasicBlock *entering = nullptr;
+  for (auto *pred : header->getPredecessors()) {
+    if (p_loop_info.contains(p_loop, pred)) {
+      continue;
+    }
+    if (entering) {
+      return nullptr;
+    }
+    entering = pred;
+  }
+  if (!entering) {
+    return nullptr;
+  }
+  if (entering->getSuccessors().size() == 1) {
+    return entering;
+  }
+  if (!p_create) {
+    return nullptr;
+  }
+
+  auto *const preheader = p_function.createBlock();
+  auto *br = preheader->append(new IRInstruction(
+      IROpcode::kBr, IRType::kVoid, IRInstruction::kNoDst, {}));
+  br->getTargets().push_back(header);
+  auto &targets = entering->getTerminator()->getTargets();
+  std::replace(targets.begin(), targets.end(), header, preheader);
+  for (auto &instruction : header->getInstructions()) {
+    if (instruction->getOpcode() != IROpcode::kPhi) {
+      break;
+    }
+    std::replace(instruction->getTargets().begin(),
+                 instruction->getTargets().end(), entering, preheader);
+  }
+
+  // laid out right before the header, which it falls through to
+  auto &blocks = p_function.getBlocks();
+  auto header_it =
+      std::find_if(blocks.begin(), blocks.end(),
+                   [&](const std::unique_ptr<IRBasicBlock> &p_block) {
+                     return p_block.get() == header;
+                   });
+  auto preheader_it = std::find_if(
+      blocks.begin(), blocks.end(),
+      [&](const std::unique_ptr<IRBasicBlock> &p_block) {
+        return p_block.get() == preheader;
+      });
+  std::rotate(header_it, preheader_it, preheader_it + 1);
+  return preheader;
+}
+
+// Whether p_instruction computes the same value on every iteration of the
+// loop. Loads through pointers stay, as a condition in the loop may be all
+// that keeps the pointer valid.
+static bool isInvariant(const IRInstruction &p_instruction, const Loop &p_loop,
+                        const LoopInfo &p_loop_info,
+                        const std::vector<IRBasicBlock *> &p_def_blocks,
+                        const MemoryEffects &p_effects,
+                        const NameSet &p_constants) {
+  if (p_instruction.hasSideEffects() ||
+      p_instruction.getOpcode() == IROpcode::kPhi) {
+    return false;
+  }
+  if (p_instruction.getOpcode() == IROpcode::kLoad) {
+    const auto &addr = p_instruction.getOperand(0);
+    if (addr.isGlobal()) {
+      if (!p_constants.count(addr.getSymbol()) &&
+          (p_effects.writes_anything ||
+           p_effects.globals.count(addr.getSymbol()))) {
+        return false;
+      }
+    } else if (!addr.isSlot() || p_effects.writes_anything ||
+               p_effects.slots.count(addr.getSlot())) {
+      return false;
+    }
+  }
+  for (const auto &operand : p_instruction.getOperands()) {
+    if (!operand.isVReg()) {
+      continue;
+    }
+    // parameters are defined before the entry block
+    const auto *def_block = p_def_blocks[operand.getVReg()];
+    if (def_block && p_loop_info.contains(p_loop, def_block)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool hoistInvariants(IRFunction &p_function,
+                            const NameSet &p_functions,
+                            const NameSet &p_constants) {
+  p_function.recomputeCFG();
+  {
+    // the preheaders are in place before the loops are looked at again
+    const DominatorTree dom_tree(p_function);
+    const LoopInfo loop_info(p_function, dom_tree);
+    for (const auto &loop : loop_info.getLoops()) {
+      getPreheader(p_function, loop_info, *loop, true);
+    }
+    p_function.recomputeCFG();
+  }
+
+  const DominatorTree dom_tree(p_function);
+  const LoopInfo loop_info(p_function, dom_tree);
+  std::vector<IRBasicBlock *> def_blocks(p_function.getNumVRegs(), nullptr);
+  for (const auto &block : p_function.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      if (instruction->hasDst()) {
+        def_blocks[instruction->getDst()] = block.get();
+      }
+    }
+  }
+
+  // inner loops first, so what they hoist into a preheader in the outer loop
+  // can move on out of that one as well
+  bool changed = false;
+  const auto &loops = loop_info.getLoops();
+  for (auto loop_it = loops.rbegin(); loop_it != loops.rend(); ++loop_it) {
+    const auto &loop = **loop_it;
+    auto *const preheader = getPreheader(p_function, loop_info, loop, false);
+    if (!preheader) {
+      continue;
+    }
+    const auto effects = getMemoryEffects(loop, p_functions);
+    auto &hoisted = preheader->getInstructions();
+    // definitions are visited before their uses
+    for (auto *block : dom_tree.getReversePostOrder()) {
+      if (!loop_info.contains(loop, block)) {
+        continue;
+      }
+      auto &instructions = block->getInstructions();
+      for (size_t i = 0; i < instructions.size();) {
+        if (!isInvariant(*instructions[i], loop, loop_info, def_blocks,
+                         effects, p_constants)) {
+          ++i;
+          continue;
+        }
+        if (instructions[i]->hasDst()) {
+          def_blocks[instructions[i]->getDst()] = preheader;
+        }
+        hoisted.insert(hoisted.end() - 1, std::move(instructions[i]));
+        instructions.erase(instructions.begin() + i);
+        changed = true;
+      }
+    }
+  }
+  return changed;
+}
+
+bool hoistLoopInvariants(IRModule &p_module) {
+  NameSet functions;
+  for (const auto &function : p_module.getFunctions()) {
+    functions.insert(function->getName());
+  }
+  NameSet constants;
+  for (const auto &global : p_module.getGlobals()) {
+    if (global.is_constant) {
+      constants.insert(global.name);
+    }
+  }
+
+  bool changed = false;
+  for (const auto &function : p_module.getFunctions()) {
+    changed |= hoistInvariants(*function, functions, constants);
+  }
+  return changed;
+}
@@ -0,0 +1,93 @@
+#include "ir/PassManager.hpp"
+
+#include <cstdio>
+
+#include "ir/Passes.hpp"
+#include "ir/SSA.hpp"
+
+static const struct {
+  const char *name;
+  IRPassManager::Pass pass;
+} kPasses[] = {
+    {"mem2reg", promoteStackSlots},
+    {"copyprop", propagateCopies},
+    {"sccp", propagateConstants},
+    {"dce", eliminateDeadCode},
+    {"tailrec", eliminateTailRecursion},
+    {"gvn", numberValues},
+};
+
+static const struct {
+  const char *name;
+  IRPassManager::ModulePass pass;
+} kModulePasses[] = {
+    {"inline", inlineFunctions},
+    {"licm", hoistLoopInvariants},
+};
+
+const char *IRPassManager::getDefaultPipeline(const unsigned p_opt_level) {
+  if (p_opt_level == 0) {
+    return "";
+  }
+  // inlining sees the callees optimized, which makes their sizes realistic,
+  // and the callers are cleaned up again once arguments reach the bodies;
+  // functions whose recursion became a loop can be inlined as well, and
+  // invariants are hoisted out of the loops of the inlined bodies too;
+  // hoisting may bring identical computations together in a preheader
+  return "mem2reg,tailrec,sccp,copyprop,gvn,dce,inline,sccp,copyprop,licm,"
+         "gvn,dce";
+}
+
+IRPassManager::Pass IRPassManager::findPass(const std::string &p_name) {
+  for (const auto &entry : kPasses) {
+    if (p_name == entry.name) {
+      return entry.pass;
+    }
+  }
+  return nullptr;
+}
+
+IRPassManager::ModulePass IRPassManager::findModulePass(
+    const std::string &p_name) {
+  for (const auto &entry : kModulePasses) {
+    if (p_name == entry.name) {
+      return entry.pass;
+    }
+  }
+  return nullptr;
+}
+
+bool IRPassManager::addPipeline(const std::string &p_pipeline) {
+  size_t begin = 0;
+  while (begin < p_pipeline.size()) {
+    auto end = p_pipeline.find(',', begin);
+    if (end == std::string::npos) {
+      end = p_pipeline.size();
+    }
+    const auto name = p_pipeline.substr(begin, end - begin);
+    begin = end + 1;
+    if (name.empty()) {
+      continue;
+    }
+    const auto pass = findPass(name);
+    const auto module_pass = findModulePass(name);
+    if (!pass && !module_pass) {
+      std::fprintf(stderr, "Unknown pass: %s\n", name.c_str());
+      return false;
+    }
+    m_passes.push_back(Entry{name, pass, module_pass});
+  }
+  return true;
+}
+
+void IRPassManager::run(IRModule &p_module) const {
+  for (const auto &entry : m_passes) {
+    if (entry.module_pass) {
+      entry.module_pass(p_module);
+      continue;
+    }
+    for (auto &function : p_module.getFunctions()) {
+      entry.pass(*function);
+    }
+  }
+}
@@ -0,0 +1,289 @@
+#include "ir/Passes.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+
+// Lattice: undefined (no value seen yet) < constant < overdefined.
+struct LatticeValue {
+  enum class State : uint8_t { kUndefined, kConstant, kOverdefined };
+  State state = State::kUndefined;
+  int64_t value = 0;
+};
+
+class ConstantPropagator {
+ private:
+  using Edge = std::pair<const IRBasicBlock *, const IRBasicBlock *>;
+
+  IRFunction &m_function;
+  std::vector<LatticeValue> m_values;
+  std::vector<bool> m_executable_blocks;
+  std::set<Edge> m_executable_edges;
+  std::vector<std::vector<IRInstruction *>> m_users;
+  std::map<const IRInstruction *, IRBasicBlock *> m_parents;
+
+  std::vector<Edge> m_cfg_worklist;
+  std::vector<IRInstruction *> m_ssa_worklist;
+
+  LatticeValue getValue(const IROperand &p_operand) const;
+  void setValue(const size_t p_vreg, const LatticeValue &p_value);
+  void markEdge(const IRBasicBlock *p_from, IRBasicBlock *p_to);
+  void visitInstruction(IRInstruction &p_instruction);
+  void visitPhi(IRInstruction &p_phi);
+  void visitTerminator(IRInstruction &p_terminator);
+  bool rewrite();
+
+ public:
+  explicit ConstantPropagator(IRFunction &p_function);
+
+  bool run();
+};
+
+ConstantPropagator::ConstantPropagator(IRFunction &p_function)
+    : m_function(p_function),
+      m_values(p_function.getNumVRegs()),
+      m_executable_blocks(p_function.getNumBlockIds(), false),
+      m_users(p_function.getNumVRegs()) {
+  for (auto &block : p_function.getBlocks()) {
+    for (auto &instruction : block->getInstructions()) {
+      m_parents[instruction.get()] = block.get();
+      for (const auto &operand : instruction->getOperands()) {
+        if (operand.isVReg()) {
+          m_users[operand.getVReg()].push_back(instruction.get());
+        }
+      }
+    }
+  }
+  // parameters come from the callers
+  for (const auto param : p_function.getParams()) {
+    m_values[param].state = LatticeValue::State::kOverdefined;
+  }
+}
+
+LatticeValue ConstantPropagator::getValue(const IROperand &p_operand) const {
+  if (p_operand.isVReg()) {
+    return m_values[p_operand.getVReg()];
+  }
+  LatticeValue value;
+  if (p_operand.isImm()) {
+    value.state = LatticeValue::State::kConstant;
+    value.value = p_operand.getImm();
+  } else {
+    // addresses are not known until link time
+    value.state = LatticeValue::State::kOverdefined;
+  }
+  return value;
+}
+
+void ConstantPropagator::setValue(const size_t p_vreg,
+                                  const LatticeValue &p_value) {
+  auto &old_value = m_values[p_vreg];
+  // values only move down the lattice
+  if (old_value.state == p_value.state &&
+      (p_value.state != LatticeValue::State::kConstant ||
+       old_value.value == p_value.value)) {
+    return;
+  }
+  if (old_value.state == LatticeValue::State::kConstant &&
+      p_value.state == LatticeValue::State::kConstant) {
+    old_value.state = LatticeValue::State::kOverdefined;
+  } else if (p_value.state > old_value.state) {
+    old_value = p_value;
+  } else {
+    return;
+  }
+  for (auto *user : m_users[p_vreg]) {
+    m_ssa_worklist.push_back(user);
+  }
+}
+
+void ConstantPropagator::markEdge(const IRBasicBlock *p_from,
+                                  IRBasicBlock *p_to) {
+  if (m_executable_edges.insert(Edge(p_from, p_to)).second) {
+    m_cfg_worklist.emplace_back(p_from, p_to);
+  }
+}
+
+void ConstantPropagator::visitPhi(IRInstruction &p_phi) {
+  const auto *block = m_parents[&p_phi];
+  LatticeValue merged;
+  for (size_t i = 0; i < p_phi.getOperands().size(); ++i) {
+    if (!m_executable_edges.count(Edge(p_phi.getTarget(i), block))) {
+      continue;
+    }
+    const auto incoming = getValue(p_phi.getOperand(i));
+    if (incoming.state == LatticeValue::State::kUndefined) {
+      continue;
+    }
+    if (incoming.state == LatticeValue::State::kOverdefined ||
+        (merged.state == LatticeValue::State::kConstant &&
+         merged.value != incoming.value)) {
+      merged.state = LatticeValue::State::kOverdefined;
+      break;
+    }
+    merged = incoming;
+  }
+  setValue(p_phi.getDst(), merged);
+}
+
+void ConstantPropagator::visitTerminator(IRInstruction &p_terminator) {
+  const auto *block = m_parents[&p_terminator];
+  if (p_terminator.getOpcode() != IROpcode::kCondBr) {
+    for (auto *target : p_terminator.getTargets()) {
+      markEdge(block, target);
+    }
+    return;
+  }
+  const auto cond = getValue(p_terminator.getOperand(0));
+  if (cond.state == LatticeValue::State::kConstant) {
+    markEdge(block, p_terminator.getTarget(cond.value ? 0 : 1));
+  } else if (cond.state == LatticeValue::State::kOverdefined) {
+    markEdge(block, p_terminator.getTarget(0));
+    markEdge(block, p_terminator.getTarget(1));
+  }
+}
+
+void ConstantPropagator::visitInstruction(IRInstruction &p_instruction) {
+  if (!m_executable_blocks[m_parents[&p_instruction]->getId()]) {
+    return;
+  }
+  if (p_instruction.getOpcode() == IROpcode::kPhi) {
+    visitPhi(p_instruction);
+    return;
+  }
+  if (p_instruction.isTerminator()) {
+    visitTerminator(p_instruction);
+    return;
+  }
+  if (!p_instruction.hasDst()) {
+    return;
+  }
+
+  // reals are not folded, as the precision they are computed in is only
+  // known to the code generator; they are never constants here, so neither
+  // are comparisons of them
+  LatticeValue result;
+  const bool foldable = (p_instruction.isBinary() || p_instruction.isUnary() ||
+                         p_instruction.getOpcode() == IROpcode::kCopy) &&
+                        p_instruction.getType() != IRType::kReal;
+  if (!foldable) {
+    result.state = LatticeValue::State::kOverdefined;
+    setValue(p_instruction.getDst(), result);
+    return;
+  }
+
+  const auto lhs = getValue(p_instruction.getOperand(0));
+  const auto rhs = p_instruction.isBinary()
+                       ? getValue(p_instruction.getOperand(1))
+                       : lhs;
+  if (lhs.state == LatticeValue::State::kOverdefined ||
+      rhs.state == LatticeValue::State::kOverdefined) {
+    result.state = LatticeValue::State::kOverdefined;
+  } else if (lhs.state == LatticeValue::State::kConstant &&
+             rhs.state == LatticeValue::State::kConstant) {
+    result.state = evaluateIROperation(p_instruction.getOpcode(), lhs.value,
+                                       rhs.value, result.value)
+                       ? LatticeValue::State::kConstant
+                       : LatticeValue::State::kOverdefined;
+  }
+  setValue(p_instruction.getDst(), result);
+}
+
+bool ConstantPropagator::rewrite() {
+  bool changed = false;
+
+  std::vector<IROperand> replacements(m_function.getNumVRegs());
+  for (size_t vreg = 0; vreg < m_values.size(); ++vreg) {
+    if (m_values[vreg].state == LatticeValue::State::kConstant) {
+      replacements[vreg] = IROperand::imm(m_values[vreg].value);
+      changed = true;
+    }
+  }
+  m_function.replaceVRegs(replacements);
+
+  for (auto &block : m_function.getBlocks()) {
+    if (!m_executable_blocks[block->getId()]) {
+      continue;
+    }
+    // definitions of constants are dead now
+    auto &instructions = block->getInstructions();
+    instructions.erase(
+        std::remove_if(instructions.begin(), instructions.end(),
+                       [&](const auto &instruction) {
+                         return instruction->hasDst() &&
+                                !replacements[instruction->getDst()].isNone() &&
+                                !instruction->hasSideEffects();
+                       }),
+        instructions.end());
+
+    auto *terminator = block->getTerminator();
+    if (terminator->getOpcode() != IROpcode::kCondBr) {
+      continue;
+    }
+    auto *then_block = terminator->getTarget(0);
+    auto *else_block = terminator->getTarget(1);
+    const bool then_taken =
+        m_executable_edges.count(Edge(block.get(), then_block));
+    const bool else_taken =
+        m_executable_edges.count(Edge(block.get(), else_block));
+    if (then_taken == else_taken) {
+      continue;
+    }
+    auto *taken = then_taken ? then_block : else_block;
+    auto *dropped = then_taken ? else_block : then_block;
+    if (dropped != taken) {
+      // the dropped successor loses this block as an incoming edge
+      for (auto &instruction : dropped->getInstructions()) {
+        if (instruction->getOpcode() != IROpcode::kPhi) {
+          break;
+        }
+        auto &targets = instruction->getTargets();
+        const auto pos = std::find(targets.begin(), targets.end(), block.get());
+        if (pos != targets.end()) {
+          instruction->getOperands().erase(instruction->getOperands().begin() +
+                                           (pos - targets.begin()));
+          targets.erase(pos);
+        }
+      }
+    }
+    auto *br = new IRInstruction(IROpcode::kBr, IRType::kVoid,
+                                 IRInstruction::kNoDst, {});
+    br->getTargets().push_back(taken);
+    instructions.back().reset(br);
+    changed = true;
+  }
+
+  m_function.recomputeCFG();
+  changed |= m_function.removeUnreachableBlocks();
+  return changed;
+}
+
+bool ConstantPropagator::run() {
+  auto *entry = m_function.getEntryBlock();
+  m_cfg_worklist.emplace_back(nullptr, entry);
+  while (!m_cfg_worklist.empty() || !m_ssa_worklist.empty()) {
+    while (!m_cfg_worklist.empty()) {
+      auto *block = const_cast<IRBasicBlock *>(m_cfg_worklist.back().second);
+      m_cfg_worklist.pop_back();
+      const bool first_visit = !m_executable_blocks[block->getId()];
+      m_executable_blocks[block->getId()] = true;
+      for (auto &instruction : block->getInstructions()) {
+        // phis see a new incoming edge; everything else only runs once here
+        if (first_visit || instruction->getOpcode() == IROpcode::kPhi) {
+          visitInstruction(*instruction);
+        }
+      }
+    }
+    while (!m_ssa_worklist.empty()) {
+      auto *instruction = m_ssa_worklist.back();
+      m_ssa_worklist.pop_back();
+      visitInstruction(*instruction);
+    }
+  }
+  return rewrite();
+}
+
+bool propagateConstants(IRFunction &p_function) {
+  return ConstantPropagator(p_function).run();
+}
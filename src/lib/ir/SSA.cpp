@@ -0,0 +1,272 @@
+#include "ir/SSA.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+
+#include "ir/Dominators.hpp"
+
+class SlotPromoter {
+ private:
+  IRFunction &m_function;
+  DominatorTree m_dom_tree;
+  std::vector<bool> m_promotable;
+  std::vector<IRType> m_slot_types;
+  // phis inserted for promoted slots
+  std::map<const IRInstruction *, size_t> m_phi_slots;
+  // current reaching definition of each slot
+  std::vector<std::vector<IROperand>> m_stacks;
+  // loads are replaced by the definition reaching them
+  std::vector<IROperand> m_replacements;
+
+  void findPromotableSlots();
+  void insertPhis();
+  void rename(IRBasicBlock *p_block);
+  IROperand resolve(const IROperand &p_operand) const;
+  IROperand currentValue(const size_t p_slot) const;
+
+ public:
+  explicit SlotPromoter(IRFunction &p_function)
+      : m_function(p_function), m_dom_tree(p_function) {}
+
+  bool run();
+};
+
+void SlotPromoter::findPromotableSlots() {
+  const auto num_slots = m_function.getSlots().size();
+  m_promotable.assign(num_slots, true);
+  m_slot_types.assign(num_slots, IRType::kInt);
+  for (const auto &slot : m_function.getSlots()) {
+    // arrays are larger than their alignment
+    if (slot.size != slot.align) {
+      m_promotable[&slot - &m_function.getSlots().front()] = false;
+    }
+  }
+  for (const auto &block : m_function.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      const auto &operands = instruction->getOperands();
+      for (size_t i = 0; i < operands.size(); ++i) {
+        if (!operands[i].isSlot()) {
+          continue;
+        }
+        const bool direct =
+            (instruction->getOpcode() == IROpcode::kLoad && i == 0) ||
+            (instruction->getOpcode() == IROpcode::kStore && i == 1);
+        if (!direct) {
+          // its address escapes
+          m_promotable[operands[i].getSlot()] = false;
+        } else {
+          m_slot_types[operands[i].getSlot()] = instruction->getType();
+        }
+      }
+    }
+  }
+}
+
+void SlotPromoter::insertPhis() {
+  const auto num_slots = m_function.getSlots().size();
+  std::vector<std::vector<IRBasicBlock *>> def_blocks(num_slots);
+  for (const auto &block : m_function.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      if (instruction->getOpcode() != IROpcode::kStore) {
+        continue;
+      }
+      const auto &addr = instruction->getOperand(1);
+      if (addr.isSlot() && m_promotable[addr.getSlot()]) {
+        def_blocks[addr.getSlot()].push_back(block.get());
+      }
+    }
+  }
+
+  std::vector<size_t> has_phi(m_function.getNumBlockIds(), num_slots);
+  std::vector<size_t> in_worklist(m_function.getNumBlockIds(), num_slots);
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    if (!m_promotable[slot]) {
+      continue;
+    }
+    auto worklist = def_blocks[slot];
+    for (auto *block : worklist) {
+      in_worklist[block->getId()] = slot;
+    }
+    while (!worklist.empty()) {
+      auto *block = worklist.back();
+      worklist.pop_back();
+      for (auto *frontier : m_dom_tree.getFrontier(block)) {
+        if (has_phi[frontier->getId()] == slot) {
+          continue;
+        }
+        has_phi[frontier->getId()] = slot;
+        const auto type = m_slot_types[slot];
+        auto &instructions = frontier->getInstructions();
+        instructions.emplace(instructions.begin(),
+                             new IRInstruction(IROpcode::kPhi, type,
+                                               m_function.newVReg(type), {}));
+        m_phi_slots[instructions.front().get()] = slot;
+        if (in_worklist[frontier->getId()] != slot) {
+          in_worklist[frontier->getId()] = slot;
+          worklist.push_back(frontier);
+        }
+      }
+    }
+  }
+}
+
+IROperand SlotPromoter::resolve(const IROperand &p_operand) const {
+  if (p_operand.isVReg() && p_operand.getVReg() < m_replacements.size() &&
+      !m_replacements[p_operand.getVReg()].isNone()) {
+    return m_replacements[p_operand.getVReg()];
+  }
+  return p_operand;
+}
+
+IROperand SlotPromoter::currentValue(const size_t p_slot) const {
+  // a variable read before any assignment holds 0
+  if (m_stacks[p_slot].empty()) {
+    return m_slot_types[p_slot] == IRType::kReal ? IROperand::real(0)
+                                                 : IROperand::imm(0);
+  }
+  return m_stacks[p_slot].back();
+}
+
+void SlotPromoter::rename(IRBasicBlock *p_block) {
+  std::vector<size_t> pushed;
+  auto &instructions = p_block->getInstructions();
+  IRBasicBlock::Instructions kept;
+  for (auto &instruction : instructions) {
+    const auto phi = m_phi_slots.find(instruction.get());
+    if (phi != m_phi_slots.end()) {
+      m_stacks[phi->second].push_back(IROperand::vreg(instruction->getDst()));
+      pushed.push_back(phi->second);
+      kept.push_back(std::move(instruction));
+      continue;
+    }
+    if (instruction->getOpcode() != IROpcode::kPhi) {
+      for (auto &operand : instruction->getOperands()) {
+        operand = resolve(operand);
+      }
+    }
+
+    const auto opcode = instruction->getOpcode();
+    if (opcode == IROpcode::kLoad && instruction->getOperand(0).isSlot() &&
+        m_promotable[instruction->getOperand(0).getSlot()]) {
+      m_replacements[instruction->getDst()] =
+          currentValue(instruction->getOperand(0).getSlot());
+      continue;
+    }
+    if (opcode == IROpcode::kStore && instruction->getOperand(1).isSlot() &&
+        m_promotable[instruction->getOperand(1).getSlot()]) {
+      const auto slot = instruction->getOperand(1).getSlot();
+      m_stacks[slot].push_back(instruction->getOperand(0));
+      pushed.push_back(slot);
+      continue;
+    }
+    kept.push_back(std::move(instruction));
+  }
+  instructions = std::move(kept);
+
+  for (auto *succ : p_block->getSuccessors()) {
+    for (auto &instruction : succ->getInstructions()) {
+      const auto phi = m_phi_slots.find(instruction.get());
+      if (phi == m_phi_slots.end()) {
+        continue;
+      }
+      instruction->getOperands().push_back(currentValue(phi->second));
+      instruction->getTargets().push_back(p_block);
+    }
+  }
+
+  for (auto *child : m_dom_tree.getChildren(p_block)) {
+    rename(child);
+  }
+  for (const auto slot : pushed) {
+    m_stacks[slot].pop_back();
+  }
+}
+
+bool SlotPromoter::run() {
+  findPromotableSlots();
+  if (std::none_of(m_promotable.begin(), m_promotable.end(),
+                   [](const bool promotable) { return promotable; })) {
+    return false;
+  }
+  insertPhis();
+  m_stacks.resize(m_function.getSlots().size());
+  m_replacements.resize(m_function.getNumVRegs());
+  rename(m_function.getEntryBlock());
+
+  // phis in blocks renamed before their incoming values were known
+  m_function.replaceVRegs(m_replacements);
+  m_function.removeUnusedSlots();
+  return true;
+}
+
+bool promoteStackSlots(IRFunction &p_function) {
+  // the renaming walk only covers blocks reachable from the entry
+  p_function.removeUnreachableBlocks();
+  return SlotPromoter(p_function).run();
+}
+
+// Copies for the phis of p_block go to the end of each predecessor. Going
+// through a fresh temporary per phi keeps the copies correct when one phi
+// reads the result of another (the "swap problem").
+static void lowerPhis(IRFunction &p_function, IRBasicBlock *p_block) {
+  auto &instructions = p_block->getInstructions();
+  // index-based: a self-loop gets its copies inserted into p_block itself
+  for (size_t idx = 0; idx < instructions.size(); ++idx) {
+    const auto *phi = instructions[idx].get();
+    if (phi->getOpcode() != IROpcode::kPhi) {
+      break;
+    }
+    const auto type = phi->getType();
+    const auto temp = p_function.newVReg(type);
+    for (size_t i = 0; i < phi->getOperands().size(); ++i) {
+      auto &pred_instructions = phi->getTarget(i)->getInstructions();
+      pred_instructions.emplace(
+          pred_instructions.end() - 1,
+          new IRInstruction(IROpcode::kCopy, type, temp, {phi->getOperand(i)}));
+    }
+    instructions[idx].reset(new IRInstruction(IROpcode::kCopy, type,
+                                              phi->getDst(),
+                                              {IROperand::vreg(temp)}));
+  }
+}
+
+void eliminatePhis(IRFunction &p_function) {
+  // split critical edges, so that copies on an edge run on that edge only
+  const auto num_blocks = p_function.getBlocks().size();
+  for (size_t i = 0; i < num_blocks; ++i) {
+    auto *block = p_function.getBlocks()[i].get();
+    const auto &instructions = block->getInstructions();
+    if (block->getPredecessors().size() < 2 ||
+        instructions.front()->getOpcode() != IROpcode::kPhi) {
+      continue;
+    }
+    const auto preds = block->getPredecessors();
+    for (auto *pred : preds) {
+      if (pred->getSuccessors().size() < 2) {
+        continue;
+      }
+      auto *split = p_function.createBlock();
+      auto *br = split->append(new IRInstruction(
+          IROpcode::kBr, IRType::kVoid, IRInstruction::kNoDst, {}));
+      br->getTargets().push_back(block);
+      for (auto &target : pred->getTerminator()->getTargets()) {
+        if (target == block) {
+          target = split;
+        }
+      }
+      for (auto &instruction : instructions) {
+        if (instruction->getOpcode() != IROpcode::kPhi) {
+          break;
+        }
+        std::replace(instruction->getTargets().begin(),
+                     instruction->getTargets().end(), pred, split);
+      }
+    }
+  }
+  p_function.recomputeCFG();
+
+  for (auto &block : p_function.getBlocks()) {
+    lowerPhis(p_function, block.get());
+  }
+}
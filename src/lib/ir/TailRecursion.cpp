@@ -0,0 +1,85 @@
+#include "ir/Passes.hpp"
+
+#include <algorithm>
+
+// Whether the call at p_index of p_block is a call to the function itself
+// whose result, if any, is returned right away.
+static bool isTailRecursion(const IRFunction &p_function,
+                            const IRBasicBlock &p_block, const size_t p_index) {
+  const auto &instructions = p_block.getInstructions();
+  const auto &call = *instructions[p_index];
+  if (call.getOpcode() != IROpcode::kCall ||
+      call.getCallee() != p_function.getName() ||
+      p_index + 2 != instructions.size()) {
+    return false;
+  }
+  const auto &ret = *instructions.back();
+  if (ret.getOpcode() != IROpcode::kRet) {
+    return false;
+  }
+  if (ret.getOperands().empty()) {
+    return !call.hasDst();
+  }
+  return call.hasDst() && ret.getOperand(0) == IROperand::vreg(call.getDst());
+}
+
+bool eliminateTailRecursion(IRFunction &p_function) {
+  std::vector<IRBasicBlock *> tail_blocks;
+  for (const auto &block : p_function.getBlocks()) {
+    const auto num_instructions = block->getInstructions().size();
+    if (num_instructions >= 2 &&
+        isTailRecursion(p_function, *block, num_instructions - 2)) {
+      tail_blocks.push_back(block.get());
+    }
+  }
+  if (tail_blocks.empty()) {
+    return false;
+  }
+
+  // the old entry becomes the loop header, entered from a new entry block
+  // with the incoming arguments and from the tail calls with their arguments
+  auto *const header = p_function.getEntryBlock();
+  auto *const entry = p_function.createBlock();
+  auto &blocks = p_function.getBlocks();
+  std::rotate(blocks.begin(), blocks.end() - 1, blocks.end());
+  auto *br = entry->append(new IRInstruction(IROpcode::kBr, IRType::kVoid,
+                                             IRInstruction::kNoDst, {}));
+  br->getTargets().push_back(header);
+
+  const auto &params = p_function.getParams();
+  std::vector<IRInstruction *> phis;
+  for (const auto param : params) {
+    const auto type = p_function.getVRegType(param);
+    const auto value = p_function.newVReg(type);
+    auto *phi = new IRInstruction(IROpcode::kPhi, type, value,
+                                  {IROperand::vreg(param)});
+    phi->getTargets().push_back(entry);
+    phis.push_back(phi);
+  }
+  // the parameters now only flow into the phis, which are added after this
+  std::vector<IROperand> replacements(p_function.getNumVRegs());
+  for (size_t i = 0; i < params.size(); ++i) {
+    replacements[params[i]] = IROperand::vreg(phis[i]->getDst());
+  }
+  p_function.replaceVRegs(replacements);
+
+  for (auto *block : tail_blocks) {
+    auto &instructions = block->getInstructions();
+    const auto &call = *instructions[instructions.size() - 2];
+    for (size_t i = 0; i < phis.size(); ++i) {
+      phis[i]->getOperands().push_back(call.getOperand(i));
+      phis[i]->getTargets().push_back(block);
+    }
+    instructions.erase(instructions.end() - 2, instructions.end());
+    br = block->append(new IRInstruction(IROpcode::kBr, IRType::kVoid,
+                                         IRInstruction::kNoDst, {}));
+    br->getTargets().push_back(header);
+  }
+
+  auto &header_instructions = header->getInstructions();
+  for (auto it = phis.rbegin(); it != phis.rend(); ++it) {
+    header_instructions.emplace(header_instructions.begin(), *it);
+  }
+  p_function.recomputeCFG();
+  return true;
+}
@@ -0,0 +1,179 @@
+#include "ir/Passes.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "ir/Dominators.hpp"
+
+// Dominator-based value numbering: an instruction computing what one in a
+// dominating block (or earlier in its own block) already computed is
+// replaced by that result. Expressions are hashed on their opcode and their
+// operands after replacement, so chains of redundancies go in one walk.
+class ValueNumberer {
+ private:
+  IRFunction &m_function;
+  DominatorTree m_dom_tree;
+  // expressions available in the blocks being walked, to their value
+  std::map<std::string, IROperand> m_available;
+  // redundant instructions are replaced by the earlier result
+  std::vector<IROperand> m_replacements;
+  // Loads only match loads that see the same memory, i.e., with no store or
+  // call between them. The generation changes at each of those, and at the
+  // start of a block that is not entered from its immediate dominator alone.
+  size_t m_memory_generation = 0;
+  size_t m_num_generations = 0;
+  bool m_changed = false;
+
+  IROperand resolve(const IROperand &p_operand) const;
+  std::string getKey(const IRInstruction &p_instruction) const;
+  void visit(IRBasicBlock *p_block);
+
+ public:
+  explicit ValueNumberer(IRFunction &p_function)
+      : m_function(p_function),
+        m_dom_tree(p_function),
+        m_replacements(p_function.getNumVRegs()) {}
+
+  bool run();
+};
+
+IROperand ValueNumberer::resolve(const IROperand &p_operand) const {
+  if (p_operand.isVReg() && !m_replacements[p_operand.getVReg()].isNone()) {
+    return m_replacements[p_operand.getVReg()];
+  }
+  return p_operand;
+}
+
+static std::string getOperandKey(const IROperand &p_operand) {
+  switch (p_operand.getKind()) {
+    case IROperand::Kind::kVReg:
+      return "%" + std::to_string(p_operand.getVReg());
+    case IROperand::Kind::kImm:
+      return std::to_string(p_operand.getImm());
+    case IROperand::Kind::kSlot:
+      return "$" + std::to_string(p_operand.getSlot());
+    case IROperand::Kind::kGlobal:
+      return "@" + p_operand.getSymbol();
+    case IROperand::Kind::kReal:
+      return "r" + std::to_string(p_operand.getImm());
+    default:
+      return "_";
+  }
+}
+
+// the same operation with its operands swapped, if there is one
+static bool getSwappedOpcode(const IROpcode p_opcode, IROpcode &p_swapped) {
+  switch (p_opcode) {
+    case IROpcode::kAdd:
+    case IROpcode::kMul:
+    case IROpcode::kAnd:
+    case IROpcode::kOr:
+    case IROpcode::kCmpEq:
+    case IROpcode::kCmpNe:
+      p_swapped = p_opcode;
+      return true;
+    case IROpcode::kCmpLt:
+      p_swapped = IROpcode::kCmpGt;
+      return true;
+    case IROpcode::kCmpGt:
+      p_swapped = IROpcode::kCmpLt;
+      return true;
+    case IROpcode::kCmpLe:
+      p_swapped = IROpcode::kCmpGe;
+      return true;
+    case IROpcode::kCmpGe:
+      p_swapped = IROpcode::kCmpLe;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Empty for instructions whose value may differ from that of an identical
+// instruction before them.
+std::string ValueNumberer::getKey(const IRInstruction &p_instruction) const {
+  auto opcode = p_instruction.getOpcode();
+  if (p_instruction.hasSideEffects() || !p_instruction.hasDst() ||
+      opcode == IROpcode::kPhi || opcode == IROpcode::kCopy) {
+    return "";
+  }
+  std::vector<std::string> operands;
+  for (const auto &operand : p_instruction.getOperands()) {
+    operands.push_back(getOperandKey(resolve(operand)));
+  }
+  // a + b and b + a, or a < b and b > a, are the same expression
+  IROpcode swapped = opcode;
+  if (operands.size() == 2 && getSwappedOpcode(opcode, swapped) &&
+      operands[1] < operands[0]) {
+    std::swap(operands[0], operands[1]);
+    opcode = swapped;
+  }
+
+  std::string key = getIROpcodeCString(opcode);
+  key += " ";
+  key += getIRTypeCString(p_instruction.getType());
+  for (const auto &operand : operands) {
+    key += " " + operand;
+  }
+  if (opcode == IROpcode::kLoad) {
+    key += " #" + std::to_string(m_memory_generation);
+  }
+  return key;
+}
+
+void ValueNumberer::visit(IRBasicBlock *p_block) {
+  const auto *idom = m_dom_tree.getIdom(p_block);
+  const auto &preds = p_block->getPredecessors();
+  if (!(preds.size() == 1 && preds.front() == idom)) {
+    m_memory_generation = ++m_num_generations;
+  }
+
+  std::vector<std::string> added;
+  auto &instructions = p_block->getInstructions();
+  for (size_t i = 0; i < instructions.size();) {
+    const auto &instruction = *instructions[i];
+    const auto opcode = instruction.getOpcode();
+    if (opcode == IROpcode::kStore || opcode == IROpcode::kCall) {
+      m_memory_generation = ++m_num_generations;
+    }
+    const auto key = getKey(instruction);
+    if (key.empty()) {
+      ++i;
+      continue;
+    }
+    const auto available = m_available.find(key);
+    if (available == m_available.end()) {
+      m_available.emplace(key, IROperand::vreg(instruction.getDst()));
+      added.push_back(key);
+      ++i;
+      continue;
+    }
+    m_replacements[instruction.getDst()] = available->second;
+    instructions.erase(instructions.begin() + i);
+    m_changed = true;
+  }
+
+  // the children of a block start out with the memory it ends with
+  const auto memory_generation = m_memory_generation;
+  for (auto *child : m_dom_tree.getChildren(p_block)) {
+    m_memory_generation = memory_generation;
+    visit(child);
+  }
+  for (const auto &key : added) {
+    m_available.erase(key);
+  }
+}
+
+bool ValueNumberer::run() {
+  visit(m_function.getEntryBlock());
+  if (m_changed) {
+    m_function.replaceVRegs(m_replacements);
+  }
+  return m_changed;
+}
+
+bool numberValues(IRFunction &p_function) {
+  p_function.recomputeCFG();
+  return ValueNumberer(p_function).run();
+}
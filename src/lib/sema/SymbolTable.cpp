@@ -49,6 +49,14 @@ SymbolEntry *SymbolTable::addSymbol(
   return m_entries.back().get();
 }
 
+void SymbolTable::removeSymbol(const std::string &p_name) {
+  m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                 [&](const auto &p_entry_ptr) {
+                                   return p_entry_ptr->getName() == p_name;
+                                 }),
+                  m_entries.end());
+}
+
 // ===========================================
 // > SymbolManager
 // ===========================================
@@ -142,14 +150,9 @@ void SymbolManager::reconstructHashTableFromSymbolTable(
                              std::forward_as_tuple(p_entry_ptr->getName()),
                              std::forward_as_tuple(p_entry_ptr.get()));
     }
-    offset += p_entry_ptr->getTypePtr()->getByteSize();
-    p_entry_ptr->setOffset(offset);
     if (p_entry_ptr->getKind() == SymbolEntry::KindEnum::kParameterKind) {
       p_entry_ptr->setParamIdx(param_idx++);
     }
-    printf("entry: %s, level: %lu, offset: %lu, param_idx: %ld\n",
-           p_entry_ptr->getNameCString(), p_entry_ptr->getLevel(),
-           p_entry_ptr->getOffset(), (p_entry_ptr->getParamIdx()));
   };
 
   for_each(p_table->getEntries().begin(), p_table->getEntries().end(),
@@ -184,6 +187,16 @@ void SymbolManager::removeSymbolsFromHashTable(
            remove_entry_from_hash_map);
 }
 
+void SymbolManager::removeSymbol(const SymbolTable *const p_table,
+                                 const std::string &p_name) {
+  for (auto &table : m_popped_tables) {
+    if (table.get() == p_table) {
+      table->removeSymbol(p_name);
+      return;
+    }
+  }
+}
+
 void SymbolManager::prevScope() {
   assert(m_current_table &&
          "If happens, it means that the uses of popScope() are more than the"
@@ -2,6 +2,8 @@
 #include "AST/BinaryOperator.hpp"
 #include "AST/CompoundStatement.hpp"
 #include "AST/ConstantValue.hpp"
+#include "AST/DeadCodeEliminator.hpp"
+#include "AST/ConstantFolder.hpp"
 #include "AST/FunctionInvocation.hpp"
 #include "AST/UnaryOperator.hpp"
 #include "AST/VariableReference.hpp"
@@ -19,7 +21,18 @@
 #include "AST/variable.hpp"
 #include "AST/while.hpp"
 
+#include "asm/Assembler.hpp"
+#include "asm/BlockLayout.hpp"
+#include "asm/Peephole.hpp"
+#include "asm/Scheduler.hpp"
 #include "codegen/CodeGenerator.hpp"
+#include "codegen/IRCodeGenerator.hpp"
+#include "codegen/OutputPath.hpp"
+#include "driver/CompilerOptions.hpp"
+#include "ir/IRGenerator.hpp"
+#include "ir/IRPrinter.hpp"
+#include "ir/PassManager.hpp"
+#include "ir/SSA.hpp"
 #include "sema/SemanticAnalyzer.hpp"
 
 #include "AST/constant.hpp"
@@ -755,12 +768,13 @@ void yyerror(const char *msg) {
 }
 
 int main(int argc, const char *argv[]) {
-    if (argc < 2) {
-        fprintf(stderr, "Usage: %s <filename> --save-path [save path]\n", argv[0]);
+    CompilerOptions options;
+    if (!parseCompilerOptions(argc, argv, options)) {
+        printUsage(argv[0]);
         exit(-1);
     }
 
-    yyin = fopen(argv[1], "r");
+    yyin = fopen(options.source_file.c_str(), "r");
     if (yyin == NULL) {
         perror("fopen() failed");
         exit(-1);
@@ -768,7 +782,7 @@ int main(int argc, const char *argv[]) {
 
     yyparse();
 
-    if (argc >= 3 && strcmp(argv[2], "--dump-ast") == 0) {
+    if (options.dump_ast) {
         AstDumper ast_dumper;
         root->accept(ast_dumper);
     }
@@ -776,9 +790,84 @@ int main(int argc, const char *argv[]) {
     SemanticAnalyzer sema_analyzer(1);
     root->accept(sema_analyzer);
 
-    CodeGenerator code_generator(argv[1], (argc == 4) ? argv[3] : "",
-                                 sema_analyzer.getSymbolManager());
-    root->accept(code_generator);
+    if (!sema_analyzer.hasError()) {
+        ConstantFolder constant_folder(sema_analyzer.getSymbolManager());
+        root->accept(constant_folder);
+
+        DeadCodeEliminator dead_code_eliminator(
+            sema_analyzer.getSymbolManager(), options.whole_program);
+        root->accept(dead_code_eliminator);
+    }
+
+    if (!options.useIR()) {
+        CodeGenerator code_generator(options.source_file, options.save_path,
+                                     sema_analyzer.getSymbolManager(),
+                                     options.unroll_factor,
+                                     options.real_precision);
+        root->accept(code_generator);
+    } else {
+        IRGenerator ir_generator(options.source_file,
+                                 sema_analyzer.getSymbolManager(),
+                                 options.real_precision);
+        root->accept(ir_generator);
+        auto ir_module = ir_generator.takeModule();
+        ir_module->setWholeProgram(options.whole_program);
+
+        IRPassManager pass_manager;
+        if (!pass_manager.addPipeline(
+                options.has_passes
+                    ? options.passes
+                    : IRPassManager::getDefaultPipeline(options.opt_level))) {
+            exit(-1);
+        }
+        pass_manager.run(*ir_module);
+        if (options.dump_ir) {
+            IRPrinter(stdout).print(*ir_module);
+        }
+        for (auto &function : ir_module->getFunctions()) {
+            eliminatePhis(*function);
+        }
+        IRCodeGenerator code_generator(options.source_file, options.save_path,
+                                       *ir_module, options.real_precision);
+        code_generator.generate();
+    }
+
+    const auto asm_path =
+        getOutputFilePath(options.source_file, options.save_path, ".S");
+    if (options.peephole) {
+        std::string error;
+        if (!optimizePeepholeFile(asm_path, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            exit(-1);
+        }
+    }
+    {
+        std::string error;
+        if (!layoutBlocksFile(asm_path, options.block_layout, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            exit(-1);
+        }
+    }
+    if (options.schedule) {
+        std::string error;
+        if (!scheduleInstructionsFile(asm_path,
+                                      *findPipelineModel(options.tune),
+                                      error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            exit(-1);
+        }
+    }
+
+    if (options.emit_obj) {
+        std::string error;
+        if (!assembleFile(asm_path,
+                          getOutputFilePath(options.source_file,
+                                            options.save_path, ".o"),
+                          error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            exit(-1);
+        }
+    }
 
     if (!sema_analyzer.hasError()) {
         printf("\n"
@@ -1,29 +1,328 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-void printInt(int value)
+/*
+ * Every string is preceded by its length and the number of characters it has
+ * room for. Literals have no room; concatenations are allocated from chunks
+ * that are never freed. appendString extends a string that has room left in
+ * place, and otherwise copies it into twice the room needed, so building a
+ * string one piece at a time takes amortized linear time. The compiler only
+ * calls it on strings nothing else refers to.
+ */
+typedef struct {
+    size_t length;
+    size_t capacity;
+} StringHeader;
+
+#define STRING_CHUNK_SIZE 65536
+
+static char *string_top;
+static char *string_end;
+
+static StringHeader *getStringHeader(const char *value)
 {
-    printf("%d\n", value);
+    return (StringHeader *)value - 1;
 }
 
-int readInt()
+static char *allocString(size_t length, size_t capacity)
+{
+    size_t size = sizeof(StringHeader) + capacity + 1;
+    size = (size + sizeof(StringHeader) - 1) & ~(sizeof(StringHeader) - 1);
+    if ((size_t)(string_end - string_top) < size) {
+        size_t chunk_size = size > STRING_CHUNK_SIZE ? size : STRING_CHUNK_SIZE;
+        string_top = malloc(chunk_size);
+        string_end = string_top + chunk_size;
+    }
+    StringHeader *header = (StringHeader *)string_top;
+    string_top += size;
+    header->length = length;
+    header->capacity = capacity;
+    return (char *)(header + 1);
+}
+
+char *concatString(const char *lhs, const char *rhs)
 {
-    int value;
-    scanf("%d", &value);
+    size_t lhs_length = getStringHeader(lhs)->length;
+    size_t rhs_length = getStringHeader(rhs)->length;
+    char *value = allocString(lhs_length + rhs_length, lhs_length + rhs_length);
+    memcpy(value, lhs, lhs_length);
+    memcpy(value + lhs_length, rhs, rhs_length + 1);
     return value;
 }
 
-void printReal(float value)
+char *appendString(char *lhs, const char *rhs)
 {
-    printf("%f\n", value);
+    StringHeader *header = getStringHeader(lhs);
+    size_t rhs_length = getStringHeader(rhs)->length;
+    size_t length = header->length + rhs_length;
+    /* literals have no room and live in read-only memory */
+    if (header->capacity == 0 || length > header->capacity) {
+        char *value = allocString(header->length, 2 * length);
+        memcpy(value, lhs, header->length);
+        lhs = value;
+        header = getStringHeader(value);
+    }
+    /* rhs may be lhs itself */
+    memmove(lhs + header->length, rhs, rhs_length + 1);
+    header->length = length;
+    return lhs;
 }
 
-float readReal(){
-    float value;
-    scanf("%f", &value);
-    return value;
+/*
+ * Output goes to a static buffer that is written out when it fills, before
+ * input is read, and at exit. Integers are formatted two digits at a time.
+ */
+#define OUTPUT_BUFFER_SIZE 65536
+
+static char output_buffer[OUTPUT_BUFFER_SIZE];
+static size_t output_end;
+static int output_flush_registered;
+
+static void flushOutput(void)
+{
+    fwrite(output_buffer, 1, output_end, stdout);
+    fflush(stdout);
+    output_end = 0;
+}
+
+/* room for size more characters at output_buffer + output_end */
+static void reserveOutput(size_t size)
+{
+    if (!output_flush_registered) {
+        atexit(flushOutput);
+        output_flush_registered = 1;
+    }
+    if (OUTPUT_BUFFER_SIZE - output_end < size) {
+        flushOutput();
+    }
+}
+
+static const char kDigitPairs[] =
+    "000102030405060708091011121314151617181920212223242526272829"
+    "303132333435363738394041424344454647484950515253545556575859"
+    "606162636465666768697071727374757677787980818283848586878889"
+    "90919293949596979899";
+
+void printInt(int value)
+{
+    /* a sign, ten digits and the newline */
+    reserveOutput(12);
+    char digits[10];
+    char *first = digits + sizeof(digits);
+    unsigned magnitude = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+    while (magnitude >= 100) {
+        const char *pair = kDigitPairs + magnitude % 100 * 2;
+        magnitude /= 100;
+        *--first = pair[1];
+        *--first = pair[0];
+    }
+    if (magnitude >= 10) {
+        const char *pair = kDigitPairs + magnitude * 2;
+        *--first = pair[1];
+        *--first = pair[0];
+    } else {
+        *--first = (char)('0' + magnitude);
+    }
+    char *out = output_buffer + output_end;
+    if (value < 0) {
+        *out++ = '-';
+    }
+    size_t length = (size_t)(digits + sizeof(digits) - first);
+    memcpy(out, first, length);
+    out[length] = '\n';
+    output_end = (size_t)(out + length + 1 - output_buffer);
+}
+
+void printBool(int value)
+{
+    reserveOutput(2);
+    output_buffer[output_end++] = value ? '1' : '0';
+    output_buffer[output_end++] = '\n';
+}
+
+void printReal(float value)
+{
+    /* %f of the largest float is 46 characters */
+    reserveOutput(64);
+    output_end += (size_t)snprintf(output_buffer + output_end, 64, "%f\n",
+                                   value);
 }
 
 void printString(char *value)
 {
-    printf("%s\n", value);
+    size_t length = getStringHeader(value)->length;
+    while (length >= OUTPUT_BUFFER_SIZE - output_end) {
+        size_t part = OUTPUT_BUFFER_SIZE - output_end;
+        memcpy(output_buffer + output_end, value, part);
+        output_end += part;
+        value += part;
+        length -= part;
+        flushOutput();
+    }
+    reserveOutput(length + 1);
+    memcpy(output_buffer + output_end, value, length);
+    output_end += length;
+    output_buffer[output_end++] = '\n';
+}
+
+/*
+ * Input is read from stdin a block at a time into a static buffer, and the
+ * values are parsed by hand. Values are separated by whitespace; a missing
+ * or malformed one reads as zero (false, the empty string).
+ */
+#define INPUT_BUFFER_SIZE 65536
+
+static char input_buffer[INPUT_BUFFER_SIZE];
+static size_t input_pos;
+static size_t input_end;
+
+/* the next character without consuming it, EOF at the end of the input */
+static int peekInput(void)
+{
+    if (input_pos == input_end) {
+        /* prompts are seen before the program waits for the answer */
+        flushOutput();
+        input_end = fread(input_buffer, 1, INPUT_BUFFER_SIZE, stdin);
+        input_pos = 0;
+        if (input_end == 0) {
+            return EOF;
+        }
+    }
+    return (unsigned char)input_buffer[input_pos];
+}
+
+static int isDigit(int c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static int isSpace(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+           c == '\f';
+}
+
+static void skipSpace(void)
+{
+    while (isSpace(peekInput())) {
+        ++input_pos;
+    }
+}
+
+/* consumes the rest of the word */
+static void skipWord(void)
+{
+    for (int c = peekInput(); c != EOF && !isSpace(c); c = peekInput()) {
+        ++input_pos;
+    }
+}
+
+/* consumes a '+' or '-', returning whether it was a '-' */
+static int readSign(void)
+{
+    int c = peekInput();
+    if (c == '+' || c == '-') {
+        ++input_pos;
+    }
+    return c == '-';
+}
+
+int readInt()
+{
+    skipSpace();
+    int negative = readSign();
+    unsigned value = 0;
+    for (int c = peekInput(); isDigit(c); c = peekInput()) {
+        value = value * 10 + (unsigned)(c - '0');
+        ++input_pos;
+    }
+    return (int)(negative ? 0u - value : value);
+}
+
+/*
+ * The digits are gathered into an integer as long as it stays exact, and
+ * scaled by the power of ten once. Powers of ten up to 1e22 are exact
+ * doubles, so the result is only rounded twice, which is plenty for a float.
+ */
+float readReal()
+{
+    static const double kPowersOfTen[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    skipSpace();
+    int negative = readSign();
+    unsigned long long digits = 0;
+    int exponent = 0;
+    int seen_point = 0;
+    for (int c = peekInput(); isDigit(c) || (c == '.' && !seen_point);
+         c = peekInput()) {
+        ++input_pos;
+        if (c == '.') {
+            seen_point = 1;
+        } else if (digits < 100000000000000ull) {
+            digits = digits * 10 + (unsigned)(c - '0');
+            exponent -= seen_point;
+        } else {
+            /* past the precision of a double */
+            exponent += !seen_point;
+        }
+    }
+    int c = peekInput();
+    if (c == 'e' || c == 'E') {
+        ++input_pos;
+        int exponent_negative = readSign();
+        int written = 0;
+        for (c = peekInput(); isDigit(c); c = peekInput()) {
+            if (written < 10000) {
+                written = written * 10 + (c - '0');
+            }
+            ++input_pos;
+        }
+        exponent += exponent_negative ? -written : written;
+    }
+    double value = (double)digits;
+    for (; exponent > 22; exponent -= 22) {
+        value *= kPowersOfTen[22];
+    }
+    for (; exponent < -22; exponent += 22) {
+        value /= kPowersOfTen[22];
+    }
+    value = exponent < 0 ? value / kPowersOfTen[-exponent]
+                         : value * kPowersOfTen[exponent];
+    return (float)(negative ? -value : value);
+}
+
+/* true, false, or an integer which is true unless it is zero */
+int readBool()
+{
+    skipSpace();
+    int c = peekInput();
+    if (c == 't' || c == 'f') {
+        skipWord();
+        return c == 't';
+    }
+    return readInt() != 0;
+}
+
+/* the next whitespace-separated word */
+char *readString()
+{
+    skipSpace();
+    size_t length = 0;
+    size_t capacity = 16;
+    char *value = allocString(0, capacity);
+    for (int c = peekInput(); c != EOF && !isSpace(c); c = peekInput()) {
+        if (length == capacity) {
+            char *grown = allocString(length, 2 * capacity);
+            memcpy(grown, value, length);
+            value = grown;
+            capacity *= 2;
+        }
+        value[length++] = (char)c;
+        ++input_pos;
+    }
+    value[length] = '\0';
+    getStringHeader(value)->length = length;
+    return value;
 }
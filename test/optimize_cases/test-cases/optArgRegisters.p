@@ -0,0 +1,72 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optArgRegisters;
+
+// Values that no call overwrites are kept in the argument registers, the
+// parameters in the ones they arrive in.
+
+mix(a, b, c, d: integer): integer
+begin
+    var s, t, u, v, w: integer;
+    s := 0;
+    t := 1;
+    u := 2;
+    v := 3;
+    w := 4;
+    for i := 0 to 100 do
+    begin
+        s := s + a * i - 1;
+        t := t + b - s;
+        u := u + c * t;
+        v := v + d - u;
+        w := w + s + t + u + v - 7;
+    end
+    end do
+    return s + t + u + v + w;
+end
+end
+
+// recursive, so that it is called rather than inlined
+diff(a, b: integer): integer
+begin
+    if a < b then
+    begin
+        return 0 - diff(b, a);
+    end
+    else
+    begin
+        return a - b;
+    end
+    end if
+end
+end
+
+// the arguments are passed on in another order
+swapped(a, b, c: integer): integer
+begin
+    var x: integer;
+    x := diff(b, a) * 100;
+    return x + diff(c, b) * 10 + diff(a, c);
+end
+end
+
+scale(x: real; n: integer; y: real): real
+begin
+    var z: real;
+    z := x * n - y;
+    return z / 2.0;
+end
+end
+
+begin
+    print mix(1, 2, 3, 4);
+    print mix(5, 6, 7, 8);
+    print swapped(1, 5, 2);
+    print swapped(9, 3, 7);
+    print scale(2.5, 4, 1.0);
+    print scale(scale(1.0, 3, 0.5), 2, 0.25);
+end
+end
@@ -0,0 +1,100 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optArray;
+var g: array 5 of array 7 of integer;
+var flags: array 10 of boolean;
+var n: integer;
+sum(a: array 7 of integer; len: integer): integer
+begin
+    var i, s: integer;
+    s := 0;
+    i := 0;
+    while i < len do
+    begin
+        s := s + a[i];
+        i := i + 1;
+    end
+    end do
+    return s;
+end
+end
+fill(m: array 5 of array 7 of integer; k: integer)
+begin
+    var i, j: integer;
+    for i := 0 to 5 do
+    begin
+        for j := 0 to 7 do
+        begin
+            m[i][j] := i * 7 + j + k;
+        end
+        end do
+    end
+    end do
+end
+end
+trace(m: array 5 of array 7 of integer): integer
+begin
+    return m[0][0] + m[1][1] + m[2][2] + m[3][3] + m[4][4];
+end
+end
+begin
+var big: array 600 of integer;
+var loc: array 3 of array 4 of array 5 of integer;
+var i, j, k, t: integer;
+fill(g, 100);
+print g[2][3];
+print sum(g[4], 7);
+print trace(g);
+fill(g, 0);
+print trace(g);
+for i := 0 to 600 do
+begin
+    big[i] := i * i;
+end
+end do
+print big[599];
+print big[0] + big[1] + big[2];
+t := 0;
+for i := 0 to 600 do
+begin
+    t := t + big[599 - i] mod 1000;
+end
+end do
+print t;
+for i := 0 to 3 do
+begin
+    for j := 0 to 4 do
+    begin
+        for k := 0 to 5 do
+        begin
+            loc[i][j][k] := i * 100 + j * 10 + k;
+        end
+        end do
+    end
+    end do
+end
+end do
+print loc[2][3][4];
+print loc[1][0][2];
+n := 2;
+print loc[n][n + 1][n * 2];
+print loc[n - 1][loc[0][0][3]][loc[0][0][1] + 1];
+for i := 0 to 10 do
+begin
+    flags[i] := i mod 3 = 0;
+end
+end do
+t := 0;
+for i := 0 to 10 do
+begin
+    if flags[i] then begin t := t + i; end end if
+end
+end do
+print t;
+loc[1][1][1] := sum(g[3], 7) + loc[0][0][4];
+print loc[1][1][1];
+end
+end
@@ -0,0 +1,45 @@
+//&S-
+//&T-
+//&D-
+
+optConditions;
+var g: integer;
+bump(x: integer): boolean
+begin
+    g := g + 1;
+    return x > 0;
+end
+end
+begin
+var a, b, i: integer;
+var c: boolean;
+a := 3; b := 5; g := 0;
+if (a < b) and (b < 10) then begin print 1; end else begin print 0; end end if
+if (a > b) or not (b <> 5) then begin print 2; end else begin print 3; end end if
+if (a >= b) and bump(1) then begin print 4; end end if
+print g;
+if (a <= b) or bump(1) then begin print 5; end end if
+print g;
+c := (a > b) and bump(1);
+print g;
+c := (a < b) and bump(-1);
+print g;
+print c;
+c := (a < b) or bump(1);
+print c;
+print g;
+if not ((a = 3) and (b = 5)) then begin print 6; end else begin print 7; end end if
+if true then begin print 8; end end if
+if false then begin print 9; end end if
+i := 0;
+while (i < 10) and (g < 100) do
+begin
+    i := i + 1;
+    if i mod 3 = 0 then begin g := g + 10; end end if
+end
+end do
+print i;
+print g;
+while false do begin print 99; end end do
+end
+end
@@ -0,0 +1,54 @@
+// OPTIONS: --whole-program
+//&S-
+//&T-
+//&D-
+
+optDeadCode;
+var g: integer;
+unused(x: integer): integer
+begin
+    return x * 2;
+end
+end
+helper(x: integer): integer
+begin
+    return x + 1;
+end
+end
+sign(x: integer): integer
+begin
+    var t: integer;
+    t := x * 3;
+    if x < 0 then
+    begin
+        return -1;
+    end
+    else
+    begin
+        return 1;
+    end
+    end if
+    print 99;
+    return 0;
+end
+end
+bump(): integer
+begin
+    g := g + 1;
+    return g;
+end
+end
+begin
+var a, b, c: integer;
+g := 0;
+a := 1;
+b := a + 2;
+c := bump();
+print sign(-5);
+print sign(5);
+if false then begin print 1; end end if
+if true then begin print 2; end else begin print 3; end end if
+while false do begin print 4; end end do
+print helper(g);
+end
+end
@@ -0,0 +1,32 @@
+// OPTIONS: -O1 -emit-obj
+//&S-
+//&T-
+//&D-
+
+optEmitObj;
+
+// Also assembled into an object file; the assembly itself still has to run.
+
+var total: integer;
+var limit: 7;
+
+add(a, b: integer): integer
+begin
+    return a + b;
+end
+end
+
+begin
+    var i: integer;
+    total := 0;
+    i := 0;
+    while i < limit do
+    begin
+        total := add(total, i * i);
+        i := i + 1;
+    end
+    end do
+    print total;
+    print limit;
+end
+end
@@ -0,0 +1,24 @@
+//&S-
+//&T-
+//&D-
+
+optExprCalls;
+var g: integer;
+f(x, y: integer): integer
+begin
+    g := g + 1;
+    return x - y;
+end
+end
+begin
+var a, b, c, d: integer;
+a := 3; b := 5; c := 7; d := 11;
+print ((a+b)*(c+d)) - ((a*b)+(c*d)) * (((a-b)*(c-d)) + ((a+c)*(b+d)));
+print (((a+b)*(c+d))*((a-b)*(c-d))) + (((a+c)*(b+d))*((a-c)*(b-d))) - ((((a*a)+(b*b))*((c*c)+(d*d)))*(((a+d)*(b+c))+((a-d)*(b-c))));
+print a + f(b, c) * (d - f(a, b + f(c, d)));
+print f(10, 3);
+print g;
+print (a < b) and (c > d) or not (a = b);
+print a <> b;
+end
+end
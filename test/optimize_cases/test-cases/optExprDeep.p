@@ -0,0 +1,11 @@
+//&S-
+//&T-
+//&D-
+
+optExprDeep;
+begin
+var a, b, c: integer;
+a := 1; b := 2; c := 3;
+print ((((((((b + 2) - (c - a)) - ((1 - 3) + (b - a))) * (((1 + 2) * (3 - 1)) * ((b + 2) + (c + a)))) * ((((a * 1) + (b * 1)) + ((2 - b) - (1 + 2))) - (((3 - b) * (c - a)) * ((3 + a) + (3 - 3))))) - (((((3 - 2) - (2 + 3)) - ((c - 2) + (2 * 1))) * (((b - 3) - (1 + 3)) * ((2 * 3) - (3 + c)))) - ((((a * b) * (1 - c)) * ((a + 1) * (c * 3))) - (((1 + 3) + (b + 2)) * ((b * 2) - (b * 1)))))) + ((((((3 * 2) * (3 - a)) - ((2 * b) + (2 - b))) - (((c * 2) - (b - 2)) * ((c - 1) * (a * 2)))) * ((((1 + 2) * (b + 3)) + ((2 + b) * (2 + c))) - (((a - a) - (a + c)) + ((a + 2) + (c + c))))) + (((((b - 3) - (3 - 3)) - ((3 - c) - (1 + a))) + (((c + 1) * (c - a)) - ((2 * b) + (1 + a)))) - ((((a + 3) * (1 * 3)) + ((1 + 2) - (3 * 3))) + (((2 + 3) - (1 * 3)) + ((3 - 3) + (a - 3))))))) * (((((((c * c) - (b * 1)) - ((b * a) * (a + 2))) - (((b * 3) + (2 - a)) + ((c + a) * (2 - 3)))) + ((((a - 3) + (c - 2)) - ((c - 2) + (c + a))) + (((2 - b) * (1 - b)) * ((a * 1) - (c * 3))))) + (((((3 + a) * (b + b)) - ((b - c) - (2 - 2))) - (((c - a) - (b * 2)) + ((b * 2) - (a + c)))) + ((((b - b) - (a * 2)) - ((a * 2) - (b + 2))) + (((c * 2) + (a - 1)) - ((a + c) + (2 + 3)))))) * ((((((b - 2) + (b - a)) * ((3 + b) - (3 - a))) * (((c - 2) + (3 - 1)) * ((b - 3) - (a + a)))) + ((((c - 1) + (c + 1)) * ((c - 2) * (a + c))) - (((3 * 1) * (c + c)) + ((b + c) - (b + c))))) - (((((3 * 2) - (c - b)) - ((a + c) + (c - 2))) * (((a * 2) + (2 + 2)) + ((b + a) * (1 - a)))) + ((((a * a) - (a - c)) * ((1 + b) * (2 + c))) * (((b + b) + (b - c)) * ((3 * 2) + (c + b))))))));
+end
+end
@@ -0,0 +1,421 @@
+//&S-
+//&T-
+//&D-
+
+optFarBranches;
+begin
+var i, s: integer;
+i := 0;
+s := 0;
+while i < 3 do
+begin
+if i = 1 then
+begin
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+s := s + i * 1;
+s := s + i * 2;
+s := s + i * 3;
+s := s + i * 4;
+s := s + i * 5;
+s := s + i * 6;
+s := s + i * 0;
+end
+end if
+i := i + 1;
+end
+end do
+print s;
+end
+end
@@ -0,0 +1,39 @@
+//&S-
+//&T-
+//&D-
+
+optFold;
+var k: 10;
+var t: true;
+var g: integer;
+bump(): boolean
+begin
+    g := g + 1;
+    return true;
+end
+end
+begin
+var n: 3;
+var a, z: integer;
+var c: boolean;
+z := 0;
+g := 0;
+print k * n + 2;
+print 2147483647 + 1;
+print -(7 - k);
+print 17 / 5;
+print -17 mod 5;
+a := 5;
+print a / z + 1 - 1 = 0;
+c := false and bump();
+print g;
+c := true or bump();
+print g;
+c := t and bump();
+print g;
+print c;
+if not (k > n) then begin print 1; end else begin print 2; end end if
+while (k < n) or false do begin print 3; end end do
+print not t;
+end
+end
@@ -0,0 +1,40 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optGvn;
+var g: integer;
+var c: 4;
+f(a, b: integer): integer
+begin
+    var x, y: integer;
+    x := a * b + a * b;
+    if b * a > 10 then
+    begin
+        y := a * b - g * c;
+        g := g + 1;
+        y := y + g * c;
+    end
+    else
+    begin
+        y := (a + b) * (b + a);
+    end
+    end if
+    return x + y + g * c;
+end
+end
+begin
+var i, s: integer;
+g := 1;
+s := 0;
+for i := 0 to 40 do
+begin
+    s := s + f(i, i + 1) + f(i + 1, i);
+    if s mod 7 < i mod 7 then begin s := s - (s mod 7); end end if
+end
+end do
+print s;
+print g;
+end
+end
@@ -0,0 +1,59 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optIRBackend;
+var g: integer;
+sq(x: integer): integer
+begin
+    return x * x;
+end
+end
+clamp(x, lo, hi: integer): integer
+begin
+    if x < lo then begin return lo; end end if
+    if x > hi then begin return hi; end end if
+    return x;
+end
+end
+fib(n: integer): integer
+begin
+    if n < 2 then begin return n; end end if
+    return fib(n - 1) + fib(n - 2);
+end
+end
+note(x: integer)
+begin
+    g := g + x;
+end
+end
+sumsq(n: integer): integer
+begin
+    var s, i: integer;
+    s := 0;
+    i := 0;
+    while i < n do
+    begin
+        s := s + sq(i);
+        i := i + 1;
+    end
+    end do
+    return s;
+end
+end
+begin
+var i, t: integer;
+g := 0;
+for i := 0 to 20 do
+begin
+    t := clamp(sq(i) - 50, 0, 200);
+    note(t);
+end
+end do
+print g;
+print sumsq(10);
+print fib(15);
+print clamp(7, 0, 5) + sq(3);
+end
+end
@@ -0,0 +1,58 @@
+//&S-
+//&T-
+//&D-
+
+optLeaf;
+
+// Functions that call nothing and keep nothing in memory run without a
+// frame, reading any stack arguments off sp.
+
+sq(x: integer): integer
+begin
+    return x * x;
+end
+end
+
+max(a, b: integer): integer
+begin
+    if a > b then
+    begin
+        return a;
+    end
+    end if
+    return b;
+end
+end
+
+mix(a, b, c: integer): integer
+begin
+    var t: integer;
+    t := a * b - c;
+    if t < 0 then
+    begin
+        t := 0 - t;
+    end
+    end if
+    return t + c;
+end
+end
+
+last(a, b, c, d, e, f, g, h, i, j: integer): integer
+begin
+    return j * 100 + i * 10 + a;
+end
+end
+
+begin
+    var s: integer;
+    s := 0;
+    for i := 1 to 20 do
+    begin
+        s := s + sq(i) + max(i, 10) + mix(i, 3, 25);
+    end
+    end do
+    print s;
+    print max(sq(7), mix(6, 7, 8));
+    print last(1, 2, 3, 4, 5, 6, 7, 8, 9, 4);
+end
+end
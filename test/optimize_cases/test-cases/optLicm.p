@@ -0,0 +1,65 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optLicm;
+var g, h: integer;
+var k: 7;
+scale(a, b, n: integer): integer
+begin
+    var i, j, s: integer;
+    s := 0;
+    i := 0;
+    while i < n do
+    begin
+        j := 0;
+        while j < n do
+        begin
+            s := s + (a * b + k) * g + j;
+            j := j + 1;
+        end
+        end do
+        i := i + 1;
+    end
+    end do
+    return s;
+end
+end
+bump(): integer
+begin
+    g := g + 1;
+    return g;
+end
+end
+begin
+var i, t: integer;
+g := 3;
+h := 0;
+print scale(2, 5, 30);
+t := 0;
+for i := 0 to 10 do
+begin
+    t := t + g * k;
+    if i = 5 then begin g := 10; end end if
+end
+end do
+print t;
+t := 0;
+for i := 0 to 5 do
+begin
+    t := t + bump() + g;
+end
+end do
+print t;
+t := 0;
+i := 0;
+while i < 0 do
+begin
+    t := t + 100 / h;
+    i := i + 1;
+end
+end do
+print t;
+end
+end
@@ -0,0 +1,31 @@
+//&S-
+//&T-
+//&D-
+
+optOutput;
+
+// More output than the runtime buffers at once, and integers of every
+// length and sign.
+
+begin
+    var m, v: integer;
+    m := 2147483647;
+    print m;
+    m := m + 1;
+    print m;
+    print 0;
+    print -1;
+    print 9;
+    print 10;
+    print -99;
+    print 100;
+    print -1000000000;
+    v := 1;
+    for i := 0 to 7000 do
+    begin
+        v := v * 7 + i;
+        print v;
+    end
+    end do
+end
+end
@@ -0,0 +1,89 @@
+// OPTIONS: --passes=mem2reg,copyprop,sccp,dce --dump-ir
+//&S-
+//&T-
+//&D-
+
+optPasses;
+
+var g: integer;
+
+fib(n: integer): integer
+begin
+  var a, b, t, i: integer;
+  a := 0;
+  b := 1;
+  i := 0;
+  while i < n do
+  begin
+    t := a;
+    a := b;
+    b := t + b;
+    i := i + 1;
+  end
+  end do
+  return a;
+end
+end
+
+swap(n: integer): integer
+begin
+  var x, y, t: integer;
+  x := 1;
+  y := 2;
+  while n > 0 do
+  begin
+    t := x;
+    x := y;
+    y := t;
+    n := n - 1;
+  end
+  end do
+  return x * 10 + y;
+end
+end
+
+begin
+  var k, s, c: integer;
+  var flag: boolean;
+  c := 5;
+  flag := c > 3;
+  if flag then
+  begin
+    s := c * 2;
+  end
+  else
+  begin
+    s := 0 - 1;
+  end
+  end if
+  print s;
+  s := 0;
+  for k := 1 to 11 do
+  begin
+    if k mod 2 = 0 then
+    begin
+      s := s + k;
+    end
+    else
+    begin
+      s := s - 1;
+    end
+    end if
+  end
+  end do
+  print s;
+  print fib(20);
+  print swap(3);
+  print swap(4);
+  g := 7;
+  k := 0;
+  while k < 3 do
+  begin
+    g := g + k;
+    k := k + 1;
+  end
+  end do
+  print g;
+  print 7 / 0 + 0 * 0;
+end
+end
@@ -0,0 +1,32 @@
+//&S-
+//&T-
+//&D-
+
+optPeephole;
+
+// Values stored and read back right away, as the code generated straight
+// from the AST does for every variable.
+
+var g: integer;
+
+begin
+    var a, b, c: integer;
+    a := 5;
+    b := a + 1;
+    c := b * a;
+    g := c - b;
+    a := g + c;
+    print a;
+    b := 0;
+    c := 1;
+    while b < 10 do
+    begin
+        c := c + b;
+        b := b + 1;
+        g := c;
+    end
+    end do
+    print g;
+    print b * c;
+end
+end
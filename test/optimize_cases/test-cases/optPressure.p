@@ -0,0 +1,89 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optPressure;
+
+id(x: integer): integer
+begin
+  return x;
+end
+end
+
+begin
+  var v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15, v16, v17, v18, v19, k, s: integer;
+  v0 := 1;
+  v1 := 2;
+  v2 := 3;
+  v3 := 4;
+  v4 := 5;
+  v5 := 6;
+  v6 := 7;
+  v7 := 8;
+  v8 := 9;
+  v9 := 10;
+  v10 := 11;
+  v11 := 12;
+  v12 := 13;
+  v13 := 14;
+  v14 := 15;
+  v15 := 16;
+  v16 := 17;
+  v17 := 18;
+  v18 := 19;
+  v19 := 20;
+  k := 0;
+  while k < 5 do
+  begin
+    v0 := id(v0) + v1;
+    v1 := id(v1) + v2;
+    v2 := id(v2) + v3;
+    v3 := id(v3) + v4;
+    v4 := id(v4) + v5;
+    v5 := id(v5) + v6;
+    v6 := id(v6) + v7;
+    v7 := id(v7) + v8;
+    v8 := id(v8) + v9;
+    v9 := id(v9) + v10;
+    v10 := id(v10) + v11;
+    v11 := id(v11) + v12;
+    v12 := id(v12) + v13;
+    v13 := id(v13) + v14;
+    v14 := id(v14) + v15;
+    v15 := id(v15) + v16;
+    v16 := id(v16) + v17;
+    v17 := id(v17) + v18;
+    v18 := id(v18) + v19;
+    v19 := id(v19) + v0;
+    k := k + 1;
+  end
+  end do
+  s := 0;
+  s := s + v0 * 1;
+  s := s + v1 * 2;
+  s := s + v2 * 3;
+  s := s + v3 * 4;
+  s := s + v4 * 5;
+  s := s + v5 * 6;
+  s := s + v6 * 7;
+  s := s + v7 * 8;
+  s := s + v8 * 9;
+  s := s + v9 * 10;
+  s := s + v10 * 11;
+  s := s + v11 * 12;
+  s := s + v12 * 13;
+  s := s + v13 * 14;
+  s := s + v14 * 15;
+  s := s + v15 * 16;
+  s := s + v16 * 17;
+  s := s + v17 * 18;
+  s := s + v18 * 19;
+  s := s + v19 * 20;
+  print s;
+  print v0;
+  print v5;
+  print v10;
+  print v15;
+end
+end
@@ -0,0 +1,66 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optRead;
+
+var gi: integer;
+var gr: real;
+var gb: boolean;
+var ga: array 4 of integer;
+
+idx(n: integer): integer
+begin
+    return n - 1;
+end
+end
+
+readinto(n: integer): integer
+begin
+    var x: integer;
+    var m: array 2 of array 3 of real;
+    read x;
+    read m[1][idx(n)];
+    print m[1][2];
+    return x * n;
+end
+end
+
+begin
+    var i: integer;
+    var r: real;
+    var b: boolean;
+    var s: string;
+    var a: array 5 of integer;
+    var bs: array 2 of boolean;
+    read i;
+    read r;
+    read b;
+    read s;
+    print i;
+    print r;
+    if b then
+    begin
+        print s;
+    end
+    end if
+    read gi;
+    read gr;
+    read gb;
+    print gi + 1;
+    print gr * 2;
+    print gb;
+    for k := 0 to 5 do
+    begin
+        read a[k];
+    end
+    end do
+    read ga[idx(4)];
+    read bs[1];
+    print a[0] + a[1] + a[2] + a[3] + a[4];
+    print ga[3];
+    print bs[1];
+    print readinto(3);
+end
+end
@@ -0,0 +1,86 @@
+// OPTIONS: -O1 --real-precision=double
+//&S-
+//&T-
+//&D-
+
+optReal;
+
+var g: real;
+var pi: 3.25;
+
+many(a, b, c, d, e, f, h, i, j, k: real; n, m: integer): real
+begin
+    return a + b + c + d + e + f + h + i + j + k + n * m;
+end
+end
+
+scale(x: real; n: integer): real
+begin
+    if n = 0 then
+    begin
+        return x;
+    end
+    end if
+    return scale(x * 2, n - 1);
+end
+end
+
+half(n: integer): real
+begin
+    return n / 2.0;
+end
+end
+
+begin
+
+var arr: array 4 of real;
+var i: integer;
+var r, s: real;
+g := 1.5;
+for i := 0 to 4 do
+begin
+    arr[i] := i * g + 0.25;
+end
+end do
+s := 0;
+for i := 0 to 4 do
+begin
+    s := s + arr[i];
+end
+end do
+print s;
+print many(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.5, 3, 4);
+print scale(0.75, 4);
+print half(7);
+r := -pi;
+print r;
+print r * -2 - 1;
+if r < 0 then
+begin
+    print 1;
+end
+end if
+if r >= -3.25 then
+begin
+    print 2;
+end
+end if
+if r <> -3.25 then
+begin
+    print 3;
+end
+else
+begin
+    print 4;
+end
+end if
+if (r > 0) or (s = 10) then
+begin
+    print 5;
+end
+end if
+i := 7;
+r := i;
+print r / 2;
+end
+end
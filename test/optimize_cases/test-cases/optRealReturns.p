@@ -0,0 +1,39 @@
+//&S-
+//&T-
+//&D-
+
+optRealReturns;
+
+// A call returned as it is becomes a jump, but not when its result has to
+// be converted to the type the function returns.
+
+twice(x: integer): integer
+begin
+    return x * 2;
+end
+end
+
+half(x: real): real
+begin
+    return x / 2.0;
+end
+end
+
+asReal(x: integer): real
+begin
+    return twice(x);
+end
+end
+
+quarter(x: real): real
+begin
+    return half(half(x));
+end
+end
+
+begin
+    print asReal(3);
+    print quarter(5.0);
+    print asReal(-4) + quarter(2.0);
+end
+end
@@ -0,0 +1,34 @@
+//&S-
+//&T-
+//&D-
+
+optStackArgs;
+ten(a, b, c, d, e, f, g, h, i, j: integer): integer
+begin
+    return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f + 7 * g + 8 * h + 9 * i + 10 * j;
+end
+end
+sq(x: integer): integer
+begin
+    return x * x;
+end
+end
+count(n, a, b, c, d, e, f, g, h, acc: integer): integer
+begin
+    if n = 0 then begin return acc + h; end end if
+    return count(n - 1, a, b, c, d, e, f, g, h + 1, acc + a + b);
+end
+end
+fwd(a, b, c, d, e, f, g, h, i, j: integer): integer
+begin
+    return ten(j, i, h, g, f, e, d, c, b, a);
+end
+end
+begin
+print ten(1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+print ten(sq(1), 2, sq(3), 4, 5, 6, 7, 8, 9, sq(10));
+print count(1000, 1, 2, 3, 4, 5, 6, 7, 0, 0);
+print fwd(1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+print ten(1, 2, 3, 4, 5, 6, 7, 8, 9, 10) + sq(ten(1, 1, 1, 1, 1, 1, 1, 1, 1, 1));
+end
+end
@@ -0,0 +1,1177 @@
+//&S-
+//&T-
+//&D-
+
+optStrength;
+var v: integer;
+begin
+v := 0;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 1;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 1;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 7;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 7;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 100;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 100;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 12345;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 12345;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 2147483647;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 2147483647;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 2147483647 - 1;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 37;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 37;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 4095;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+v := 0 - 4096;
+print v / 1;
+print v mod 1;
+print v / -1;
+print v mod -1;
+print v / 2;
+print v mod 2;
+print v / -2;
+print v mod -2;
+print v / 3;
+print v mod 3;
+print v / -3;
+print v mod -3;
+print v / 4;
+print v mod 4;
+print v / 7;
+print v mod 7;
+print v / -8;
+print v mod -8;
+print v / 10;
+print v mod 10;
+print v / -5;
+print v mod -5;
+print v / 16;
+print v mod 16;
+print v / 4096;
+print v mod 4096;
+print v / -4096;
+print v mod -4096;
+print v / 65536;
+print v mod 65536;
+print v / 641;
+print v mod 641;
+print v / 1000;
+print v mod 1000;
+print v / -1000;
+print v mod -1000;
+print v / 2147483647;
+print v mod 2147483647;
+print v * 0;
+print 0 * v;
+print v * 1;
+print 1 * v;
+print v * -1;
+print -1 * v;
+print v * 2;
+print 2 * v;
+print v * 3;
+print 3 * v;
+print v * -3;
+print -3 * v;
+print v * 5;
+print 5 * v;
+print v * 6;
+print 6 * v;
+print v * 7;
+print 7 * v;
+print v * -7;
+print -7 * v;
+print v * 10;
+print 10 * v;
+print v * 12;
+print 12 * v;
+print v * -16;
+print -16 * v;
+print v * 31;
+print 31 * v;
+print v * 100;
+print 100 * v;
+print v * -2147483648;
+print -2147483648 * v;
+print v * 1000;
+print 1000 * v;
+end
+end
@@ -0,0 +1,102 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optString;
+
+var g: string;
+var greeting: "hi there";
+var names: array 3 of string;
+
+suffix(s: string): string
+begin
+    return s + "!";
+end
+end
+
+build(n: integer): string
+begin
+    var s: string;
+    var k: "k";
+    s := "";
+    for i := 0 to 3 do
+    begin
+        s := s + k + "b";
+    end
+    end do
+    return s;
+end
+end
+
+twice(s: string): string
+begin
+    var t: string;
+    t := s;
+    t := t + t;
+    return t;
+end
+end
+
+begin
+    var s, t, u: string;
+    var c: "const";
+    var n: integer;
+    print "hello";
+    print greeting;
+    print c;
+    g := "global";
+    g := g + "-x";
+    print g;
+    s := "a";
+    t := s;
+    s := s + "b";
+    print t;
+    print s;
+    u := "";
+    for i := 0 to 5 do
+    begin
+        u := u + "x";
+    end
+    end do
+    print u;
+    u := u + "y" + u;
+    print u;
+    print suffix(u);
+    print build(3);
+    print twice("ab");
+    names[0] := "n0";
+    names[1] := names[0] + "n1";
+    names[2] := names[1] + names[0];
+    print names[2];
+    s := "hello";
+    s := s + " " + suffix("world");
+    print s;
+    n := 3;
+    print n;
+    s := "p" + "q";
+    t := s + "r";
+    s := s + "s";
+    print t;
+    print s;
+    print "hello";
+    u := "";
+    u := u + "";
+    print u;
+    u := u + "" + "z";
+    print u;
+    s := "lit";
+    s := s + "";
+    print s;
+    s := s + "eral";
+    print s;
+    t := "";
+    for i := 0 to 3 do
+    begin
+        t := t + "" + c;
+    end
+    end do
+    print t;
+    print "lit";
+end
+end
@@ -0,0 +1,19 @@
+//&S-
+//&T-
+//&D-
+
+optStringAppend;
+
+begin
+    var s, t: string;
+    s := "";
+    t := "";
+    for i := 0 to 2000 do
+    begin
+        s := s + "ab";
+        t := t + "c" + "d";
+    end
+    end do
+    print 1;
+end
+end
@@ -0,0 +1,47 @@
+//&S-
+//&T-
+//&D-
+
+optTailCalls;
+
+// Returns of calls become jumps: a function calling itself loops instead of
+// growing the stack, and a sibling call reuses the incoming arguments.
+
+sumto(n, acc: integer): integer
+begin
+    if n = 0 then
+    begin
+        return acc;
+    end
+    end if
+    return sumto(n - 1, (acc + n) mod 1000003);
+end
+end
+
+weigh(a, b, c, d, e, f, g, h, i, j: integer): integer
+begin
+    return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f + 7 * g + 8 * h + 9 * i + 10 * j;
+end
+end
+
+// more arguments than fit in registers, passed on where its own arrived
+rotate(a, b, c, d, e, f, g, h, i, j: integer): integer
+begin
+    return weigh(j, a, b, c, d, e, f, g, h, i);
+end
+end
+
+// fewer arguments than it received
+pair(a, b, c, d, e, f, g, h, i, j: integer): integer
+begin
+    return sumto(a + j, b);
+end
+end
+
+begin
+    print sumto(100000, 0);
+    print rotate(1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+    print rotate(10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    print pair(3, 4, 0, 0, 0, 0, 0, 0, 0, 7);
+end
+end
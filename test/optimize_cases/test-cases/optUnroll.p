@@ -0,0 +1,34 @@
+//&S-
+//&T-
+//&D-
+
+optUnroll;
+var s: integer;
+begin
+var t: integer;
+s := 0;
+for i := 0 to 10003 do
+begin
+    s := (s + i * 3) mod 1000003;
+end
+end do
+print s;
+t := 0;
+for k := 5 to 12 do
+begin
+    t := t + k;
+end
+end do
+print t;
+for m := 0 to 3 do
+begin
+    for n := 0 to 1001 do
+    begin
+        t := t + m * n;
+    end
+    end do
+end
+end do
+print t;
+end
+end
@@ -0,0 +1,75 @@
+// OPTIONS: -O1
+//&S-
+//&T-
+//&D-
+
+optUnusedParams;
+
+// Only some of the parameters are used, so the others get no register and
+// must not be moved over the ones that do.
+
+pick(a, b, c, d, e, g, h, k: integer): integer
+begin
+    return a * 1000 + b;
+end
+end
+
+first(a, b, c, d: integer): integer
+begin
+    return a;
+end
+end
+
+last(a, b, c, d: integer): integer
+begin
+    return d;
+end
+end
+
+spread(a, b, c, d, e, g, h, k, m, n: integer): integer
+begin
+    return c * 100 + k * 10 + n;
+end
+end
+
+mixed(x: real; n: integer; y: real; m: integer): real
+begin
+    return y * m;
+end
+end
+
+count(n, unused: integer; flag: boolean): integer
+begin
+    if n <= 0 then
+    begin
+        return 0;
+    end
+    else
+    begin
+        return 1 + count(n - 1, unused * 2, not flag);
+    end
+    end if
+end
+end
+
+begin
+    var i: integer;
+    print pick(79, 857, 3, 4, 5, 6, 7, 8);
+    print pick(1, 2, 3, 4, 5, 6, 7, 8);
+    print first(42, 2, 3, 4);
+    print first(7, 8, 9, 10);
+    print last(1, 2, 3, 44);
+    print last(5, 6, 7, 8);
+    print spread(1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+    print spread(9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    print mixed(1.5, 2, 2.5, 4);
+    i := 0;
+    for j := 1 to 4 do
+    begin
+        i := i + first(j, i, j, i) + last(i, j, i, j);
+    end
+    end do
+    print i;
+    print count(12, 3, true);
+end
+end
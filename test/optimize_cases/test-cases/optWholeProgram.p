@@ -0,0 +1,49 @@
+// OPTIONS: -O1 --whole-program
+//&S-
+//&T-
+//&D-
+
+optWholeProgram;
+
+// square and twice are inlined wherever they are called, which leaves
+// them without callers; fact is recursive and stays.
+
+square(n: integer): integer
+begin
+    return n * n;
+end
+end
+
+twice(n: integer): integer
+begin
+    return square(n) + square(n);
+end
+end
+
+fact(n: integer): integer
+begin
+    if n <= 1 then
+    begin
+        return 1;
+    end
+    else
+    begin
+        return n * fact(n - 1);
+    end
+    end if
+end
+end
+
+begin
+    var s: integer;
+    s := 0;
+    for i := 1 to 6 do
+    begin
+        s := s + twice(i);
+    end
+    end do
+    print s;
+    print square(12);
+    print fact(10);
+end
+end
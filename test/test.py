@@ -47,6 +47,48 @@ class Grader:
     bonus_case_scores = [0, 2, 2, 3, 3, 3, 3, 3]
     bonus_id_list = bonus_cases.keys()
 
+    # Cases for the optimizations and the runtime. A case may start with a
+    # "// OPTIONS: <flags>" comment passing flags to the compiler, and may
+    # come with a <case>.in file given to the program as its input.
+    optimize_case_dir = "./optimize_cases"
+    optimize_cases = {
+        1: "optExprDeep",
+        2: "optExprCalls",
+        3: "optIRBackend",
+        4: "optPasses",
+        5: "optPressure",
+        6: "optUnusedParams",
+        7: "optArgRegisters",
+        8: "optEmitObj",
+        9: "optFrames",
+        10: "optUnroll",
+        11: "optUnrollFactor",
+        12: "optConditions",
+        13: "optFold",
+        14: "optDeadCode",
+        15: "optWholeProgram",
+        16: "optTailCalls",
+        17: "optStackArgs",
+        18: "optLeaf",
+        19: "optPeephole",
+        20: "optStrength",
+        21: "optLicm",
+        22: "optGvn",
+        23: "optArray",
+        24: "optReal",
+        25: "optRealReturns",
+        26: "optString",
+        27: "optStringAppend",
+        28: "optRead",
+        29: "optOutput",
+        30: "optFarBranches",
+        31: "optPipeline"
+    }
+    optimize_case_scores = [
+        0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2]
+    optimize_id_list = optimize_cases.keys()
+
     diff_result = ""
 
     def __init__(self, compiler, save_path, executable_file_path,
@@ -70,18 +112,43 @@ class Grader:
         if not os.path.exists(self.output_dir):
             os.makedirs(self.output_dir)
 
-    def gen_riscv_code(self, case_type, case_id):
+    def get_test_case(self, case_type, case_id, extension=".p"):
         if case_type == "basic":
-            test_case = "%s/%s/%s.p" % (self.basic_case_dir,
-                                        "test-cases", self.basic_cases[case_id])
+            test_case = "%s/%s/%s" % (self.basic_case_dir,
+                                      "test-cases", self.basic_cases[case_id])
         elif case_type == "advance":
-            test_case = "%s/%s/%s.p" % (self.advance_case_dir,
-                                        "test-cases", self.advance_cases[case_id])
+            test_case = "%s/%s/%s" % (self.advance_case_dir,
+                                      "test-cases", self.advance_cases[case_id])
         elif case_type == "bonus":
-            test_case = "%s/%s/%s.p" % (self.bonus_case_dir,
-                                        "test-cases", self.bonus_cases[case_id])
+            test_case = "%s/%s/%s" % (self.bonus_case_dir,
+                                      "test-cases", self.bonus_cases[case_id])
+        elif case_type == "optimize":
+            test_case = "%s/%s/%s" % (self.optimize_case_dir,
+                                      "test-cases", self.optimize_cases[case_id])
+        return test_case + extension
+
+    @staticmethod
+    def get_case_options(test_case):
+        """Returns the flags of the "// OPTIONS:" comments of the case."""
+        options = []
+        with open(test_case) as source:
+            for line in source:
+                if line.startswith("// OPTIONS:"):
+                    options += line[len("// OPTIONS:"):].split()
+        return options
+
+    def get_case_input(self, case_type, case_id):
+        input_file = self.get_test_case(case_type, case_id, ".in")
+        if not os.path.exists(input_file):
+            return b"123"
+        with open(input_file, "rb") as data:
+            return data.read()
+
+    def gen_riscv_code(self, case_type, case_id):
+        test_case = self.get_test_case(case_type, case_id)
 
         clist = [self.compiler, test_case, "--save-path", self.save_path]
+        clist += self.get_case_options(test_case)
         try:
             proc = subprocess.Popen(
                 clist, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
@@ -106,6 +173,11 @@ class Grader:
             test_case = "%s/%s.S" % (self.save_path, self.bonus_cases[case_id])
             executable_file = "%s/%s" % (self.executable_file_path,
                                          self.bonus_cases[case_id])
+        elif case_type == "optimize":
+            test_case = "%s/%s.S" % (self.save_path,
+                                     self.optimize_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.optimize_cases[case_id])
 
         clist = ["riscv32-unknown-elf-gcc", test_case,
                  self.io_file, "-o", executable_file]
@@ -135,13 +207,19 @@ class Grader:
                                      self.bonus_cases[case_id])
             executable_file = "%s/%s" % (self.executable_file_path,
                                          self.bonus_cases[case_id])
+        elif case_type == "optimize":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.optimize_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.optimize_cases[case_id])
 
         clist = ["spike", "--isa=RV32IMAFDC",
                  "/risc-v/riscv32-unknown-elf/bin/pk", executable_file]
         try:
             proc = subprocess.Popen(
                 clist, stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
-            stdout_bytes, stderr_bytes = proc.communicate(input=b"123")
+            stdout_bytes, stderr_bytes = proc.communicate(
+                input=self.get_case_input(case_type, case_id))
         except Exception as e:
             print(colorama.Fore.RED + "Call of '%s' failed: %s" %
                   (" ".join(clist), e))
@@ -171,6 +249,11 @@ class Grader:
                                      self.bonus_cases[case_id])
             solution = "%s/%s/%s" % (self.bonus_case_dir,
                                      "sample-solutions", self.bonus_cases[case_id])
+        elif case_type == "optimize":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.optimize_cases[case_id])
+            solution = "%s/%s/%s" % (self.optimize_case_dir,
+                                     "sample-solutions", self.optimize_cases[case_id])
 
         clist = ["diff", "-Z", "-u", output_file, solution,
                  f'--label="your output:({output_file})"', f'--label="answer:({solution})"']
@@ -190,6 +273,9 @@ class Grader:
                 self.diff_result += "{}\n".format(self.advance_cases[case_id])
             elif case_type == "bonus":
                 self.diff_result += "{}\n".format(self.bonus_cases[case_id])
+            elif case_type == "optimize":
+                self.diff_result += "{}\n".format(
+                    self.optimize_cases[case_id])
             self.diff_result += "{}\n".format(output)
 
         return retcode == 0
@@ -243,6 +329,18 @@ class Grader:
             total_score += get_val
             max_score += max_val
 
+        for o_id in self.optimize_id_list:
+            c_name = self.optimize_cases[o_id]
+            print("+++ TESTING optimize case %s:" % c_name)
+            ok = self.test_sample_case("optimize", o_id)
+            max_val = self.optimize_case_scores[o_id]
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (c_name, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
         self.set_text_color(total_score == max_score)
         print("---\tTOTAL\t\t%d/%d" % (total_score, max_score))
         self.reset_text_color()